@@ -4,6 +4,42 @@
 
 // <<< Use Configuration Wizard in Context Menu >>>
 
+// <e> Buffered output
+// <i> Collect output in a buffer sent by an asynchronous USART, writes return without waiting for the transmitter
+// <id> stdio_buffered_output
+#ifndef CONF_STDIO_BUFFERED_OUTPUT
+#define CONF_STDIO_BUFFERED_OUTPUT 1
+#endif
+
+// <o> Output buffer size
+// <16=>16 bytes
+// <32=>32 bytes
+// <64=>64 bytes
+// <128=>128 bytes
+// <256=>256 bytes
+// <512=>512 bytes
+// <1024=>1024 bytes
+// <i> Writes wait for the transmitter only when the buffer is full
+// <id> stdio_output_buffer_size
+#ifndef CONF_STDIO_OUTPUT_BUFFER_SIZE
+#define CONF_STDIO_OUTPUT_BUFFER_SIZE 256
+#endif
+
+// <q> Flush on newline
+// <i> Start transmission at each newline, otherwise only once half of the buffer is used or on stdio_io_flush()
+// <id> stdio_flush_on_newline
+#ifndef CONF_STDIO_FLUSH_ON_NEWLINE
+#define CONF_STDIO_FLUSH_ON_NEWLINE 1
+#endif
+
+// <o> stdout buffer size <0-256>
+// <i> Buffer newlib collects stdout in, so that printf() writes whole lines or chunks; 0 leaves stdout unbuffered
+// <id> stdio_stream_buffer_size
+#ifndef CONF_STDIO_STREAM_BUFFER_SIZE
+#define CONF_STDIO_STREAM_BUFFER_SIZE 64
+#endif
+// </e>
+
 // <<< end of configuration section >>>
 
 #endif // STDIO_REDIRECT_CONFIG_H
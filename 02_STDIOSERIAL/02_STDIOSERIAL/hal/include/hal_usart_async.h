@@ -0,0 +1,603 @@
+/**
+ * \file
+ *
+ * \brief USART related functionality declaration.
+ *
+ * Copyright (c) 2014-2018 Microchip Technology Inc. and its subsidiaries.
+ *
+ * \asf_license_start
+ *
+ * \page License
+ *
+ * Subject to your compliance with these terms, you may use Microchip
+ * software and any derivatives exclusively with Microchip products.
+ * It is your responsibility to comply with third party license terms applicable
+ * to your use of third party software (including open source software) that
+ * may accompany Microchip software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES,
+ * WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE,
+ * INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY,
+ * AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL MICROCHIP BE
+ * LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR CONSEQUENTIAL
+ * LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO THE
+ * SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE
+ * POSSIBILITY OR THE DAMAGES ARE FORESEEABLE.  TO THE FULLEST EXTENT
+ * ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN ANY WAY
+ * RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+ * THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+ *
+ * \asf_license_stop
+ *
+ */
+
+#ifndef _HAL_USART_ASYNC_H_INCLUDED
+#define _HAL_USART_ASYNC_H_INCLUDED
+
+#include "hal_io.h"
+#include <hpl_usart_async.h>
+#include <utils_ringbuffer.h>
+#include <utils_framer.h>
+
+/**
+ * \addtogroup doc_driver_hal_usart_async
+ *
+ * @{
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief USART descriptor
+ *
+ * The USART descriptor forward declaration.
+ */
+struct usart_async_descriptor;
+
+/**
+ * \brief USART callback type
+ */
+typedef void (*usart_cb_t)(const struct usart_async_descriptor *const descr);
+
+/**
+ * \brief USART transmit buffer callback type
+ *
+ * Called when the buffer has been handed over to the hardware and may be
+ * reused, the last characters can still be on the line.
+ */
+typedef void (*usart_tx_buffer_cb_t)(const struct usart_async_descriptor *const descr, const uint8_t *const buf);
+
+/**
+ * \brief Time stamp source type
+ *
+ * Returns a free-running counter value, e.g. from timer_get_timestamp(). It
+ * is called from the receive interrupt.
+ */
+typedef uint32_t (*usart_timestamp_cb_t)(void);
+
+/** Number of buffers the transmit queue holds */
+#ifndef USART_ASYNC_TX_QUEUE_LENGTH
+#define USART_ASYNC_TX_QUEUE_LENGTH 4
+#endif
+
+/**
+ * \brief USART callback types
+ */
+enum usart_async_callback_type { USART_ASYNC_RXC_CB, USART_ASYNC_TXC_CB, USART_ASYNC_ERROR_CB, USART_ASYNC_RX_START_CB };
+
+/**
+ * \brief USART callbacks
+ */
+struct usart_async_callbacks {
+	usart_cb_t tx_done;
+	usart_cb_t rx_done;
+	usart_cb_t error;
+	usart_cb_t rx_start;
+};
+
+/**
+ * \brief USART transmit buffer
+ */
+struct usart_async_tx_buffer {
+	/** Data to transmit, must stay valid until the callback is called */
+	const uint8_t *buf;
+	/** Number of characters to transmit */
+	uint16_t length;
+	/** Called when the buffer may be reused, can be NULL */
+	usart_tx_buffer_cb_t cb;
+};
+
+/**
+ * \brief USART received frame time stamps
+ */
+struct usart_async_rx_timestamp {
+	/** Time the first character of the frame was received */
+	uint32_t start;
+	/** Time the last character of the frame was received */
+	uint32_t end;
+};
+
+/**
+ * \brief USART receive latency statistics
+ *
+ * Time from the last character of a frame being received to the RX or frame
+ * callback, in time stamp counts.
+ */
+struct usart_async_rx_latency {
+	/** Shortest latency */
+	uint32_t min;
+	/** Average latency */
+	uint32_t avg;
+	/** Longest latency */
+	uint32_t max;
+	/** Number of frames measured */
+	uint32_t count;
+};
+
+/** \brief USART status
+ *  Status descriptor holds the current status of transfer.
+ */
+struct usart_async_status {
+	/** Status flags */
+	uint32_t flags;
+	/** Number of characters transmitted */
+	uint16_t txcnt;
+	/** Number of characters receviced */
+	uint16_t rxcnt;
+	/** Highest number of characters held in the RX buffer */
+	uint16_t rx_high_water;
+	/** Number of characters lost because the RX buffer was full */
+	uint32_t rx_overflows;
+	/** Number of hardware receive buffer overflows */
+	uint32_t rx_hw_overflows;
+	/** Number of characters discarded due to parity or frame errors */
+	uint32_t rx_errors;
+};
+
+/**
+ * \brief Asynchronous USART descriptor structure
+ */
+struct usart_async_descriptor {
+	struct io_descriptor         io;
+	struct _usart_async_device   device;
+	struct usart_async_callbacks usart_cb;
+	uint32_t                     stat;
+
+	struct ringbuffer rx;
+	uint32_t          rx_hw_overflows;
+	uint32_t          rx_errors;
+	uint16_t          tx_por;
+	uint8_t *         tx_buffer;
+	uint16_t          tx_buffer_length;
+	bool              tx_dma;
+	bool              rx_dma;
+	uint16_t          rx_dma_pos;
+	uint8_t           rx_dma_crossed;
+	bool              rx_dma_ahead;
+	bool              rx_idle_pending;
+
+	struct usart_async_tx_buffer tx_queue[USART_ASYNC_TX_QUEUE_LENGTH];
+	uint8_t                      tx_head;
+	uint8_t                      tx_count;
+
+	struct framer *framer;
+
+	usart_timestamp_cb_t            rx_timestamp;
+	struct usart_async_rx_timestamp rx_frame;
+	bool                            rx_frame_open;
+	uint32_t                        rx_latency_min;
+	uint32_t                        rx_latency_max;
+	uint32_t                        rx_latency_count;
+	uint64_t                        rx_latency_sum;
+};
+
+/** USART write busy */
+#define USART_ASYNC_STATUS_BUSY 0x0001
+/** USART reception held back because the RX buffer is full */
+#define USART_ASYNC_STATUS_RX_BLOCKED 0x0002
+
+/**
+ * \brief Initialize USART interface
+ *
+ * This function initializes the given I/O descriptor to be used as USART
+ * interface descriptor.
+ * It checks if the given hardware is not initialized and if the given hardware
+ * is permitted to be initialized.
+ *
+ * \param[out] descr A USART descriptor which is used to communicate via the USART
+ * \param[in] hw The pointer to the hardware instance
+ * \param[in] rx_buffer An RX buffer
+ * \param[in] rx_buffer_length The length of the buffer above
+ * \param[in] func The pointer to a set of function pointers
+ *
+ * \return Initialization status.
+ * \retval -1 Passed parameters were invalid or the interface is already
+ * initialized
+ * \retval 0 The initialization is completed successfully
+ */
+int32_t usart_async_init(struct usart_async_descriptor *const descr, void *const hw, uint8_t *const rx_buffer,
+                         const uint16_t rx_buffer_length, void *const func);
+
+/**
+ * \brief Deinitialize USART interface
+ *
+ * This function deinitializes the given I/O descriptor.
+ * It checks if the given hardware is initialized and if the given hardware
+ * is permitted to be deinitialized.
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ *
+ * \return De-initialization status.
+ */
+int32_t usart_async_deinit(struct usart_async_descriptor *const descr);
+
+/**
+ * \brief Enable USART interface
+ *
+ * Enables the USART interface
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ *
+ * \return Enabling status.
+ */
+int32_t usart_async_enable(struct usart_async_descriptor *const descr);
+
+/**
+ * \brief Disable USART interface
+ *
+ * Disables the USART interface
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ *
+ * \return Disabling status.
+ */
+int32_t usart_async_disable(struct usart_async_descriptor *const descr);
+
+/**
+ * \brief Queue buffers for transmission
+ *
+ * The buffers are appended to the transmit queue as a whole and sent back to
+ * back, so a header and its payload can be given as separate buffers without
+ * a gap on the line. Each buffer's callback is called as soon as that buffer
+ * may be reused, tx_done callback is called when the queue has run empty and
+ * the last character has left the transmitter.
+ * io_write() queues a single buffer without a callback.
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ * \param[in] bufs The buffers to transmit
+ * \param[in] count The number of buffers
+ *
+ * \return The number of characters queued.
+ * \retval ERR_NO_RESOURCE The transmit queue can not take all the buffers
+ */
+int32_t usart_async_write_buffers(struct usart_async_descriptor *const descr,
+                                  const struct usart_async_tx_buffer *const bufs, const uint8_t count);
+
+/**
+ * \brief Retrieve I/O descriptor
+ *
+ * This function retrieves the I/O descriptor of the given USART descriptor.
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ * \param[out] io An I/O descriptor to retrieve
+ *
+ * \return The status of I/O descriptor retrieving.
+ */
+int32_t usart_async_get_io_descriptor(struct usart_async_descriptor *const descr, struct io_descriptor **io);
+
+/**
+ * \brief Register USART callback
+ *
+ * USART_ASYNC_RX_START_CB is only available with DMA reception. It is called
+ * from the interrupt when a character starts to arrive while the receive
+ * start detection is armed; it is armed on registration and again by
+ * usart_async_check_rx_idle() once no data is pending.
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ * \param[in] type Callback type
+ * \param[in] cb A callback function
+ *
+ * \return The status of callback assignment.
+ * \retval -1 Passed parameters were invalid or the interface is not initialized
+ * \retval 0 A callback is registered successfully
+ */
+int32_t usart_async_register_callback(struct usart_async_descriptor *const descr,
+                                      const enum usart_async_callback_type type, usart_cb_t cb);
+
+/**
+ * \brief Specify action for flow control pins
+ *
+ * This function sets action (or state) for flow control pins if
+ * the flow control is enabled.
+ * It sets state of flow control pins only if automatic support of
+ * the flow control is not supported by the hardware.
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ * \param[in] state A state to set the flow control pins
+ *
+ * \return The status of flow control action setup.
+ */
+int32_t usart_async_set_flow_control(struct usart_async_descriptor *const descr,
+                                     const union usart_flow_control_state state);
+
+/**
+ * \brief Set USART baud rate
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ * \param[in] baud_rate A baud rate to set
+ *
+ * \return The status of baud rate setting.
+ */
+int32_t usart_async_set_baud_rate(struct usart_async_descriptor *const descr, const uint32_t baud_rate);
+
+/**
+ * \brief Find the USART baud rate setting closest to a baud rate
+ *
+ * Tries arithmetic and fractional baud rate generation with 16, 8 and 3
+ * samples per bit. More samples are preferred while the error stays below
+ * 0.1%. Nothing is written to the hardware.
+ *
+ * \param[in] baud Required baud rate
+ * \param[in] clock_rate Frequency of the SERCOM core clock
+ * \param[out] setting The best setting, with the actual baud rate and error
+ *
+ * \return ERR_NONE if a setting was found, ERR_INVALID_ARG if the baud rate is
+ * above a third of the clock rate or zero
+ */
+int32_t usart_async_solve_baud_rate(const uint32_t baud, const uint32_t clock_rate,
+                                    struct usart_baud_setting *const setting);
+
+/**
+ * \brief Apply a USART baud rate setting
+ *
+ * The baud rate is changed between characters only, the call fails while a
+ * transmission is in progress.
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ * \param[in] setting A setting found by usart_async_solve_baud_rate
+ *
+ * \return ERR_NONE on success, ERR_BUSY if a transmission is in progress
+ */
+int32_t usart_async_set_baud_setting(struct usart_async_descriptor *const    descr,
+                                     const struct usart_baud_setting *const setting);
+
+/**
+ * \brief Set USART data order
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ * \param[in] data_order A data order to set
+ *
+ * \return The status of data order setting.
+ */
+int32_t usart_async_set_data_order(struct usart_async_descriptor *const descr, const enum usart_data_order data_order);
+
+/**
+ * \brief Set USART mode
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ * \param[in] mode A mode to set
+ *
+ * \return The status of mode setting.
+ */
+int32_t usart_async_set_mode(struct usart_async_descriptor *const descr, const enum usart_mode mode);
+
+/**
+ * \brief Set USART parity
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ * \param[in] parity A parity to set
+ *
+ * \return The status of parity setting.
+ */
+int32_t usart_async_set_parity(struct usart_async_descriptor *const descr, const enum usart_parity parity);
+
+/**
+ * \brief Set USART stop bits
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ * \param[in] stop_bits Stop bits to set
+ *
+ * \return The status of stop bits setting.
+ */
+int32_t usart_async_set_stopbits(struct usart_async_descriptor *const descr, const enum usart_stop_bits stop_bits);
+
+/**
+ * \brief Set USART character size
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ * \param[in] size A character size to set
+ *
+ * \return The status of character size setting.
+ */
+int32_t usart_async_set_character_size(struct usart_async_descriptor *const descr,
+                                       const enum usart_character_size      size);
+
+/**
+ * \brief Retrieve the state of flow control pins
+ *
+ * This function retrieves the flow control pins
+ * if the flow control is enabled.
+ *
+ * The function can return USART_FLOW_CONTROL_STATE_UNAVAILABLE in case
+ * if the flow control is done by the hardware
+ * and the pins state cannot be read out.
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ * \param[out] state The state of flow control pins
+ *
+ * \return The status of flow control state reading.
+ */
+int32_t usart_async_flow_control_status(const struct usart_async_descriptor *const descr,
+                                        union usart_flow_control_state *const      state);
+
+/**
+ * \brief Check if the USART transmitter is empty
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ *
+ * \return The status of USART TX empty checking.
+ * \retval 0 The USART transmitter is not empty
+ * \retval 1 The USART transmitter is empty
+ */
+int32_t usart_async_is_tx_empty(const struct usart_async_descriptor *const descr);
+
+/**
+ * \brief Check if the USART receiver is not empty
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ *
+ * \return The status of the USART RX empty checking.
+ * \retval 1 The USART receiver is not empty
+ * \retval 0 The USART receiver is empty
+ */
+int32_t usart_async_is_rx_not_empty(struct usart_async_descriptor *const descr);
+
+/**
+ * \brief Retrieve the current interface status
+ *
+ * \param[in]  descr A USART descriptor which is used to communicate via USART
+ * \param[out] status The state of USART
+ *
+ * \return The status of USART status retrieving.
+ */
+int32_t usart_async_get_status(struct usart_async_descriptor *const descr, struct usart_async_status *const status);
+
+/**
+ * \brief Set the RX buffer full strategy
+ *
+ * With RINGBUFFER_OVERWRITE_OLDEST (the default) the oldest received data is
+ * overwritten, with RINGBUFFER_REJECT_NEWEST newly received data is dropped.
+ * Both are counted in usart_async_status::rx_overflows.
+ * With RINGBUFFER_BLOCK the receive interrupt is disabled as soon as the RX
+ * buffer is full and USART_ASYNC_STATUS_RX_BLOCKED is set, leaving further
+ * data in the hardware; reception resumes when data is read from the buffer.
+ * When reception goes through the DMAC the oldest data is always overwritten,
+ * whatever the strategy. A DMA block interrupt held off while the DMAC goes
+ * a whole lap round the RX buffer is counted as a buffer full of lost data.
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ * \param[in] policy The RX buffer full strategy
+ *
+ * \return The status of strategy setting.
+ */
+int32_t usart_async_set_rx_overflow_policy(struct usart_async_descriptor *const  descr,
+                                           const enum ringbuffer_overflow_policy policy);
+
+/**
+ * \brief Clear the RX loss counters and high-water mark
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ *
+ * \return ERR_NONE
+ */
+int32_t usart_async_clear_rx_stats(struct usart_async_descriptor *const descr);
+
+/**
+ * \brief Parse received data into frames
+ *
+ * The framer is run in the receive path and hands complete frames to its
+ * callback straight from the RX buffer, before the RX callback is called.
+ * The framer has to be initialized on the RX buffer of the descriptor, and
+ * must be its only reader: io_read() must not be used while it is attached.
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ * \param[in] framer The framer to attach, NULL to detach the current one
+ *
+ * \return ERR_NONE
+ */
+int32_t usart_async_set_framer(struct usart_async_descriptor *const descr, struct framer *const framer);
+
+/**
+ * \brief Check the USART receiver for an idle line
+ *
+ * With DMA reception the RX callback is not called per character but when
+ * half of the RX buffer has been filled, or when the line turned idle after
+ * data was received. The SERCOM has no receive timeout, so this function has
+ * to be called again while it returns ERR_NOT_READY, e.g. from a one-shot
+ * timer task; the idle timeout is the calling period. Once it returns
+ * anything else, the USART_ASYNC_RX_START_CB callback is armed and can start
+ * the timer task again, so an idle line needs no polling.
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ *
+ * \return The status of idle checking.
+ * \retval ERR_NONE The line turned idle, the RX callback has been called
+ * \retval ERR_NOT_READY Data arrived since the previous check
+ * \retval ERR_NO_CHANGE No data is pending
+ * \retval ERR_UNSUPPORTED_OP Reception does not go through the DMAC
+ */
+int32_t usart_async_check_rx_idle(struct usart_async_descriptor *const descr);
+
+/**
+ * \brief Time stamp received frames
+ *
+ * The receive path reads the time stamp source when the first and the last
+ * character of a frame arrive. A frame ends when the framer hands it to its
+ * callback, or with each RX callback when no framer is attached. With DMA
+ * reception, characters are seen when a block is complete and at idle checks
+ * only. The first character after an idle line is stamped from the receive
+ * start interrupt while USART_ASYNC_RX_START_CB is registered, other time
+ * stamps are taken when the data is seen. The end of a frame is then late by
+ * up to one idle check period, and the latency measured from it is short by
+ * as much: it covers the time from the idle check or block interrupt that
+ * delivered the last character, not from its arrival.
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ * \param[in] timestamp The time stamp source, NULL to stop time stamping
+ *
+ * \return ERR_NONE
+ */
+int32_t usart_async_set_rx_timestamp(struct usart_async_descriptor *const descr, usart_timestamp_cb_t timestamp);
+
+/**
+ * \brief Retrieve the time stamps of the received frame
+ *
+ * To be called once from the RX or frame callback. The time from the end of
+ * the frame to this call is added to the latency statistics.
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ * \param[out] frame The time stamps of the frame being delivered
+ *
+ * \return ERR_NONE on success, ERR_UNSUPPORTED_OP if time stamping is off
+ */
+int32_t usart_async_get_rx_timestamp(struct usart_async_descriptor *const   descr,
+                                     struct usart_async_rx_timestamp *const frame);
+
+/**
+ * \brief Retrieve the receive latency statistics
+ *
+ * The statistics are reset by usart_async_clear_rx_stats().
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ * \param[out] latency The latency statistics, all zero if nothing was measured
+ *
+ * \return ERR_NONE
+ */
+int32_t usart_async_get_rx_latency(struct usart_async_descriptor *const descr,
+                                   struct usart_async_rx_latency *const latency);
+
+/**
+ * \brief flush USART ringbuf
+ *
+ * This function flush USART RX ringbuf.
+ *
+ * \param[in] descr The pointer to USART descriptor
+ *
+ * \return ERR_NONE
+ */
+int32_t usart_async_flush_rx_buffer(struct usart_async_descriptor *const descr);
+
+/**
+ * \brief Retrieve the current driver version
+ *
+ * \return Current driver version.
+ */
+uint32_t usart_async_get_version(void);
+
+#ifdef __cplusplus
+}
+#endif
+/**@}*/
+#endif /* _HAL_USART_ASYNC_H_INCLUDED */
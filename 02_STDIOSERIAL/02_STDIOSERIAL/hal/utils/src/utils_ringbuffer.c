@@ -0,0 +1,348 @@
+/**
+ * \file
+ *
+ * \brief Ringbuffer functionality implementation.
+ *
+ * Copyright (c) 2014-2018 Microchip Technology Inc. and its subsidiaries.
+ *
+ * \asf_license_start
+ *
+ * \page License
+ *
+ * Subject to your compliance with these terms, you may use Microchip
+ * software and any derivatives exclusively with Microchip products.
+ * It is your responsibility to comply with third party license terms applicable
+ * to your use of third party software (including open source software) that
+ * may accompany Microchip software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES,
+ * WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE,
+ * INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY,
+ * AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL MICROCHIP BE
+ * LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR CONSEQUENTIAL
+ * LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO THE
+ * SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE
+ * POSSIBILITY OR THE DAMAGES ARE FORESEEABLE.  TO THE FULLEST EXTENT
+ * ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN ANY WAY
+ * RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+ * THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+ *
+ * \asf_license_stop
+ *
+ */
+#include "utils_ringbuffer.h"
+#include <string.h>
+
+/**
+ * \brief Ringbuffer init
+ */
+int32_t ringbuffer_init(struct ringbuffer *const rb, void *buf, uint32_t size)
+{
+	ASSERT(rb && buf && size);
+
+	/*
+	 * buf size must be aligned to power of 2
+	 */
+	if ((size & (size - 1)) != 0) {
+		return ERR_INVALID_ARG;
+	}
+
+	/* size - 1 is faster in calculation */
+	rb->size        = size - 1;
+	rb->read_index  = 0;
+	rb->write_index = rb->read_index;
+	rb->buf         = (uint8_t *)buf;
+	rb->overflows   = 0;
+	rb->high_water  = 0;
+	rb->policy      = RINGBUFFER_OVERWRITE_OLDEST;
+
+	return ERR_NONE;
+}
+
+/**
+ * \brief Set ringbuffer full strategy
+ */
+int32_t ringbuffer_set_policy(struct ringbuffer *const rb, const enum ringbuffer_overflow_policy policy)
+{
+	ASSERT(rb);
+
+	if (policy > RINGBUFFER_BLOCK) {
+		return ERR_INVALID_ARG;
+	}
+	rb->policy = policy;
+
+	return ERR_NONE;
+}
+
+/**
+ * \internal Track the highest fill level of ringbuffer
+ */
+static inline void ringbuffer_update_high_water(struct ringbuffer *const rb)
+{
+	uint32_t num = rb->write_index - rb->read_index;
+
+	if (num > rb->high_water) {
+		rb->high_water = num;
+	}
+}
+
+/**
+ * \brief Get one byte from ringbuffer
+ *
+ */
+int32_t ringbuffer_get(struct ringbuffer *const rb, uint8_t *data)
+{
+	ASSERT(rb && data);
+
+	if (rb->write_index != rb->read_index) {
+		*data = rb->buf[rb->read_index & rb->size];
+		rb->read_index++;
+		return ERR_NONE;
+	}
+
+	return ERR_NOT_FOUND;
+}
+
+/**
+ * \brief Put one byte to ringbuffer
+ *
+ */
+int32_t ringbuffer_put(struct ringbuffer *const rb, uint8_t data)
+{
+	ASSERT(rb);
+
+	if ((rb->write_index - rb->read_index) > rb->size) {
+		if (rb->policy == RINGBUFFER_BLOCK) {
+			return ERR_BUSY;
+		}
+		rb->overflows++;
+		if (rb->policy == RINGBUFFER_REJECT_NEWEST) {
+			return ERR_OVERFLOW;
+		}
+		/*
+		 * buffer full strategy: new data will overwrite the oldest data in
+		 * the buffer
+		 */
+		rb->read_index = rb->write_index - rb->size;
+	}
+
+	rb->buf[rb->write_index & rb->size] = data;
+	rb->write_index++;
+	ringbuffer_update_high_water(rb);
+
+	return ERR_NONE;
+}
+
+/**
+ * \brief Read a block of bytes from ringbuffer
+ */
+uint32_t ringbuffer_read(struct ringbuffer *const rb, uint8_t *buf, uint32_t length)
+{
+	uint32_t num, offset, chunk;
+
+	ASSERT(rb && (buf || !length));
+
+	num = rb->write_index - rb->read_index;
+	if (length > num) {
+		length = num;
+	}
+	if (!length) {
+		return 0;
+	}
+
+	offset = rb->read_index & rb->size;
+	chunk  = rb->size + 1 - offset;
+	if (chunk > length) {
+		chunk = length;
+	}
+	memcpy(buf, &rb->buf[offset], chunk);
+	memcpy(&buf[chunk], rb->buf, length - chunk);
+	rb->read_index += length;
+
+	return length;
+}
+
+/**
+ * \brief Write a block of bytes to ringbuffer
+ */
+uint32_t ringbuffer_write(struct ringbuffer *const rb, const uint8_t *buf, uint32_t length)
+{
+	uint32_t written = length;
+	uint32_t space, offset, chunk;
+
+	ASSERT(rb && (buf || !length));
+
+	space = rb->size + 1 - (rb->write_index - rb->read_index);
+	if (length > space) {
+		if (rb->policy == RINGBUFFER_BLOCK) {
+			written = length = space;
+		} else if (rb->policy == RINGBUFFER_REJECT_NEWEST) {
+			rb->overflows += length - space;
+			written = length = space;
+		} else {
+			rb->overflows += length - space;
+		}
+	}
+
+	/*
+	 * only the newest size + 1 bytes can survive, skip the rest
+	 */
+	if (length > rb->size + 1) {
+		rb->write_index += length - (rb->size + 1);
+		buf += length - (rb->size + 1);
+		length = rb->size + 1;
+	}
+	if (!length) {
+		return written;
+	}
+
+	offset = rb->write_index & rb->size;
+	chunk  = rb->size + 1 - offset;
+	if (chunk > length) {
+		chunk = length;
+	}
+	memcpy(&rb->buf[offset], buf, chunk);
+	memcpy(rb->buf, &buf[chunk], length - chunk);
+	rb->write_index += length;
+
+	/*
+	 * buffer full strategy: new data will overwrite the oldest data in
+	 * the buffer
+	 */
+	if ((rb->write_index - rb->read_index) > rb->size + 1) {
+		rb->read_index = rb->write_index - (rb->size + 1);
+	}
+	ringbuffer_update_high_water(rb);
+
+	return written;
+}
+
+/**
+ * \brief Get the contiguous readable span of ringbuffer
+ */
+uint32_t ringbuffer_peek_span(const struct ringbuffer *const rb, uint8_t **span)
+{
+	uint32_t num, offset, chunk;
+
+	ASSERT(rb && span);
+
+	num    = rb->write_index - rb->read_index;
+	offset = rb->read_index & rb->size;
+	chunk  = rb->size + 1 - offset;
+
+	*span = &rb->buf[offset];
+
+	return (num < chunk) ? num : chunk;
+}
+
+/**
+ * \brief Release bytes from the head of ringbuffer
+ */
+int32_t ringbuffer_commit_read(struct ringbuffer *const rb, uint32_t length)
+{
+	ASSERT(rb);
+
+	if (length > rb->write_index - rb->read_index) {
+		return ERR_INVALID_ARG;
+	}
+	rb->read_index += length;
+
+	return ERR_NONE;
+}
+
+/**
+ * \brief Get the contiguous free span of ringbuffer
+ */
+uint32_t ringbuffer_reserve_span(const struct ringbuffer *const rb, uint8_t **span)
+{
+	uint32_t space, offset, chunk;
+
+	ASSERT(rb && span);
+
+	space  = rb->size + 1 - (rb->write_index - rb->read_index);
+	offset = rb->write_index & rb->size;
+	chunk  = rb->size + 1 - offset;
+
+	*span = &rb->buf[offset];
+
+	return (space < chunk) ? space : chunk;
+}
+
+/**
+ * \brief Publish bytes written into the free span of ringbuffer
+ */
+int32_t ringbuffer_commit_write(struct ringbuffer *const rb, uint32_t length)
+{
+	ASSERT(rb);
+
+	if (length > rb->size + 1 - (rb->write_index - rb->read_index)) {
+		return ERR_INVALID_ARG;
+	}
+	rb->write_index += length;
+	ringbuffer_update_high_water(rb);
+
+	return ERR_NONE;
+}
+
+/**
+ * \brief Publish bytes stored into ringbuffer memory by hardware
+ */
+uint32_t ringbuffer_commit_overwrite(struct ringbuffer *const rb, uint32_t length)
+{
+	uint32_t lost = 0;
+
+	ASSERT(rb);
+
+	rb->write_index += length;
+	if ((rb->write_index - rb->read_index) > rb->size + 1) {
+		lost           = rb->write_index - rb->read_index - (rb->size + 1);
+		rb->read_index = rb->write_index - (rb->size + 1);
+		rb->overflows += lost;
+	}
+	ringbuffer_update_high_water(rb);
+
+	return lost;
+}
+
+/**
+ * \brief Return the element number of ringbuffer
+ */
+uint32_t ringbuffer_num(const struct ringbuffer *const rb)
+{
+	ASSERT(rb);
+
+	return rb->write_index - rb->read_index;
+}
+
+/**
+ * \brief Return the free space of ringbuffer
+ */
+uint32_t ringbuffer_space(const struct ringbuffer *const rb)
+{
+	ASSERT(rb);
+
+	return rb->size + 1 - (rb->write_index - rb->read_index);
+}
+
+/**
+ * \brief Clear ringbuffer statistics
+ */
+void ringbuffer_clear_stats(struct ringbuffer *const rb)
+{
+	ASSERT(rb);
+
+	rb->overflows  = 0;
+	rb->high_water = rb->write_index - rb->read_index;
+}
+
+/**
+ * \brief Flush ringbuffer
+ */
+uint32_t ringbuffer_flush(struct ringbuffer *const rb)
+{
+	ASSERT(rb);
+
+	rb->read_index = rb->write_index;
+
+	return ERR_NONE;
+}
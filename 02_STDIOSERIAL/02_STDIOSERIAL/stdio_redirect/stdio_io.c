@@ -32,11 +32,133 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 #include <stdio_io.h>
+#include <stdio_redirect_config.h>
+
+#if CONF_STDIO_BUFFERED_OUTPUT
+#include <hal_atomic.h>
+#include <hal_usart_async.h>
+#include <utils_ringbuffer.h>
+#endif
 
 /** IO descriptor for STDIO access. */
 static struct io_descriptor *stdio_io = NULL;
 
+#if CONF_STDIO_BUFFERED_OUTPUT
+/** USART sending the buffered output, NULL when output is not buffered. */
+static struct usart_async_descriptor *stdio_usart = NULL;
+
+/** Output buffer. */
+static uint8_t           stdio_out_buffer[CONF_STDIO_OUTPUT_BUFFER_SIZE];
+static struct ringbuffer stdio_out;
+
+/** Buffer index up to which output is to be sent. */
+static uint32_t stdio_out_flush;
+
+/** Number of bytes handed to the USART. */
+static volatile uint32_t stdio_out_pending;
+
+#if defined(__GNUC__) && CONF_STDIO_STREAM_BUFFER_SIZE
+/** Buffer newlib collects stdout in before calling _write(). */
+static char stdio_stream_buffer[CONF_STDIO_STREAM_BUFFER_SIZE];
+#endif
+
+static void stdio_io_start_output(void);
+
+/**
+ *  \brief Release the data sent by the USART and send the next part
+ */
+static void stdio_io_output_done(const struct usart_async_descriptor *const descr, const uint8_t *const buf)
+{
+	(void)descr;
+	(void)buf;
+
+	ringbuffer_commit_read(&stdio_out, stdio_out_pending);
+	stdio_out_pending = 0;
+	stdio_io_start_output();
+}
+
+/**
+ *  \brief Hand the data to flush to the USART, if it is idle
+ *
+ *  Must be called with interrupts disabled.
+ */
+static void stdio_io_start_output(void)
+{
+	struct usart_async_tx_buffer txb;
+	uint8_t *                    span;
+	uint32_t                     num;
+
+	if (stdio_out_pending) {
+		return;
+	}
+
+	num = ringbuffer_peek_span(&stdio_out, &span);
+	if (num > stdio_out_flush - stdio_out.read_index) {
+		num = stdio_out_flush - stdio_out.read_index;
+	}
+	if (!num) {
+		return;
+	}
+
+	txb.buf    = span;
+	txb.length = num;
+	txb.cb     = stdio_io_output_done;
+	if (usart_async_write_buffers(stdio_usart, &txb, 1) > 0) {
+		stdio_out_pending = num;
+	}
+}
+
+/**
+ *  \brief Check if the caller can wait for the transmitter to make room
+ *
+ *  Buffer space is released from the USART interrupts, which cannot preempt
+ *  an interrupt handler or run while interrupts are disabled.
+ */
+static inline bool stdio_io_can_wait(void)
+{
+	return !__get_IPSR() && !__get_PRIMASK();
+}
+
+/**
+ *  \brief Copy data to the output buffer
+ *
+ *  Waits while the buffer is full, except in an interrupt handler or with
+ *  interrupts disabled, where the data that does not fit is dropped.
+ */
+static int32_t stdio_io_write_buffered(const uint8_t *buf, const int32_t len)
+{
+	int32_t  done = 0;
+	uint32_t num;
+
+	while (done < len) {
+		CRITICAL_SECTION_ENTER()
+		num = ringbuffer_write(&stdio_out, buf + done, len - done);
+
+#if CONF_STDIO_FLUSH_ON_NEWLINE
+		if (memchr(buf + done, '\n', num)) {
+			stdio_out_flush = stdio_out.write_index;
+		}
+#endif
+		/* Keep the transmitter busy while the buffer fills up */
+		if (!num || ringbuffer_num(&stdio_out) > CONF_STDIO_OUTPUT_BUFFER_SIZE / 2) {
+			stdio_out_flush = stdio_out.write_index;
+		}
+		stdio_io_start_output();
+		CRITICAL_SECTION_LEAVE()
+
+		if (!num && !stdio_io_can_wait()) {
+			break;
+		}
+		/* Retried until the transmitter has made room for the rest */
+		done += num;
+	}
+
+	return len;
+}
+#endif
+
 void stdio_io_init(struct io_descriptor *io)
 {
 #if defined(__GNUC__)
@@ -62,6 +184,16 @@ int32_t stdio_io_read(uint8_t *buf, const int32_t len)
 	if (stdio_io == NULL) {
 		return 0;
 	}
+#if CONF_STDIO_BUFFERED_OUTPUT
+	if (stdio_usart) {
+		int32_t n;
+
+		/* The asynchronous USART returns at once, wait for some input */
+		while ((n = io_read(stdio_io, buf, len)) == 0) {
+		}
+		return n;
+	}
+#endif
 	return io_read(stdio_io, buf, len);
 }
 
@@ -70,5 +202,57 @@ int32_t stdio_io_write(const uint8_t *buf, const int32_t len)
 	if (stdio_io == NULL) {
 		return 0;
 	}
+#if CONF_STDIO_BUFFERED_OUTPUT
+	if (stdio_usart) {
+		return stdio_io_write_buffered(buf, len);
+	}
+#endif
 	return io_write(stdio_io, buf, len);
 }
+
+#if CONF_STDIO_BUFFERED_OUTPUT
+void stdio_io_init_async(struct usart_async_descriptor *const descr)
+{
+	stdio_io_init(&descr->io);
+#if defined(__GNUC__) && CONF_STDIO_STREAM_BUFFER_SIZE
+	/* Have newlib pass on whole lines or chunks instead of single characters */
+	setvbuf(stdout,
+	        stdio_stream_buffer,
+	        CONF_STDIO_FLUSH_ON_NEWLINE ? _IOLBF : _IOFBF,
+	        CONF_STDIO_STREAM_BUFFER_SIZE);
+#endif
+
+	ringbuffer_init(&stdio_out, stdio_out_buffer, CONF_STDIO_OUTPUT_BUFFER_SIZE);
+	ringbuffer_set_policy(&stdio_out, RINGBUFFER_BLOCK);
+	stdio_out_flush   = 0;
+	stdio_out_pending = 0;
+	stdio_usart       = descr;
+}
+#endif
+
+void stdio_io_flush(void)
+{
+#if CONF_STDIO_BUFFERED_OUTPUT
+	if (stdio_usart == NULL) {
+		return;
+	}
+#if defined(__GNUC__) && CONF_STDIO_STREAM_BUFFER_SIZE
+	fflush(stdout);
+#endif
+
+	CRITICAL_SECTION_ENTER()
+	stdio_out_flush = stdio_out.write_index;
+	stdio_io_start_output();
+	CRITICAL_SECTION_LEAVE()
+#endif
+}
+
+bool stdio_io_is_flushed(void)
+{
+#if CONF_STDIO_BUFFERED_OUTPUT
+	if (stdio_usart) {
+		return ringbuffer_num(&stdio_out) == 0;
+	}
+#endif
+	return true;
+}
@@ -74,6 +74,38 @@ int32_t stdio_io_read(uint8_t *buf, const int32_t len);
  */
 int32_t stdio_io_write(const uint8_t *buf, const int32_t len);
 
+struct usart_async_descriptor;
+
+/**
+ *  \brief Initialize STDIO access with buffered output
+ *
+ *  Written data is copied to an output buffer and sent by the USART in the
+ *  background, writes only wait for the transmitter when the buffer is full.
+ *  Transmission starts at each newline when CONF_STDIO_FLUSH_ON_NEWLINE is
+ *  set, once half of the buffer is used, or on stdio_io_flush(). With
+ *  CONF_STDIO_STREAM_BUFFER_SIZE set, newlib buffers stdout as well and
+ *  passes it on per line, or per full buffer without CONF_STDIO_FLUSH_ON_NEWLINE.
+ *  A write from an interrupt handler, or with interrupts disabled, drops
+ *  what does not fit into the output buffer instead of waiting.
+ *  Reads wait until at least one byte has been received.
+ *  \param[in] descr Pointer to an enabled USART descriptor
+ */
+void stdio_io_init_async(struct usart_async_descriptor *const descr);
+
+/**
+ *  \brief Start transmission of all buffered output
+ *
+ *  Flushes stdout first. Returns without waiting for the data to be sent.
+ *  Must not be called from an interrupt handler.
+ */
+void stdio_io_flush(void);
+
+/**
+ *  \brief Check if all buffered output has been handed to the USART
+ *  \return true when the output buffer is empty
+ */
+bool stdio_io_is_flushed(void);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
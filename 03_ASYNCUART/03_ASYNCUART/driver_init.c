@@ -14,7 +14,9 @@
 #include <hpl_pm_base.h>
 
 /*! The buffer size for USART */
-#define SERIAL_BUFFER_SIZE 16
+#define SERIAL_BUFFER_SIZE 256
+
+struct timer_descriptor TIMER;
 
 struct usart_async_descriptor SERIAL;
 
@@ -57,9 +59,24 @@ void SERIAL_init(void)
 	SERIAL_PORT_init();
 }
 
+/**
+ * \brief Timer initialization function
+ *
+ * Enables Timer peripheral, clocks and initializes Timer driver
+ */
+static void TIMER_init(void)
+{
+	_pm_enable_bus_clock(PM_BUS_APBC, TC3);
+	_gclk_enable_channel(TC3_GCLK_ID, CONF_GCLK_TC3_SRC);
+
+	timer_init(&TIMER, TC3, _tc_get_timer());
+}
+
 void system_init(void)
 {
 	init_mcu();
 
 	SERIAL_init();
+
+	TIMER_init();
 }
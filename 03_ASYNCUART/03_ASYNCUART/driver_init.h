@@ -21,8 +21,13 @@ extern "C" {
 #include <hal_io.h>
 #include <hal_sleep.h>
 
+#include <hal_timer.h>
+#include <hpl_tc_base.h>
+
 #include <hal_usart_async.h>
 
+extern struct timer_descriptor TIMER;
+
 extern struct usart_async_descriptor SERIAL;
 
 void SERIAL_PORT_init(void);
@@ -37,6 +37,7 @@
 #include "hal_io.h"
 #include <hpl_usart_async.h>
 #include <utils_ringbuffer.h>
+#include <utils_framer.h>
 
 /**
  * \addtogroup doc_driver_hal_usart_async
@@ -60,10 +61,31 @@ struct usart_async_descriptor;
  */
 typedef void (*usart_cb_t)(const struct usart_async_descriptor *const descr);
 
+/**
+ * \brief USART transmit buffer callback type
+ *
+ * Called when the buffer has been handed over to the hardware and may be
+ * reused, the last characters can still be on the line.
+ */
+typedef void (*usart_tx_buffer_cb_t)(const struct usart_async_descriptor *const descr, const uint8_t *const buf);
+
+/**
+ * \brief Time stamp source type
+ *
+ * Returns a free-running counter value, e.g. from timer_get_timestamp(). It
+ * is called from the receive interrupt.
+ */
+typedef uint32_t (*usart_timestamp_cb_t)(void);
+
+/** Number of buffers the transmit queue holds */
+#ifndef USART_ASYNC_TX_QUEUE_LENGTH
+#define USART_ASYNC_TX_QUEUE_LENGTH 4
+#endif
+
 /**
  * \brief USART callback types
  */
-enum usart_async_callback_type { USART_ASYNC_RXC_CB, USART_ASYNC_TXC_CB, USART_ASYNC_ERROR_CB };
+enum usart_async_callback_type { USART_ASYNC_RXC_CB, USART_ASYNC_TXC_CB, USART_ASYNC_ERROR_CB, USART_ASYNC_RX_START_CB };
 
 /**
  * \brief USART callbacks
@@ -72,6 +94,46 @@ struct usart_async_callbacks {
 	usart_cb_t tx_done;
 	usart_cb_t rx_done;
 	usart_cb_t error;
+	usart_cb_t rx_start;
+};
+
+/**
+ * \brief USART transmit buffer
+ */
+struct usart_async_tx_buffer {
+	/** Data to transmit, must stay valid until the callback is called */
+	const uint8_t *buf;
+	/** Number of characters to transmit */
+	uint16_t length;
+	/** Called when the buffer may be reused, can be NULL */
+	usart_tx_buffer_cb_t cb;
+};
+
+/**
+ * \brief USART received frame time stamps
+ */
+struct usart_async_rx_timestamp {
+	/** Time the first character of the frame was received */
+	uint32_t start;
+	/** Time the last character of the frame was received */
+	uint32_t end;
+};
+
+/**
+ * \brief USART receive latency statistics
+ *
+ * Time from the last character of a frame being received to the RX or frame
+ * callback, in time stamp counts.
+ */
+struct usart_async_rx_latency {
+	/** Shortest latency */
+	uint32_t min;
+	/** Average latency */
+	uint32_t avg;
+	/** Longest latency */
+	uint32_t max;
+	/** Number of frames measured */
+	uint32_t count;
 };
 
 /** \brief USART status
@@ -84,6 +146,14 @@ struct usart_async_status {
 	uint16_t txcnt;
 	/** Number of characters receviced */
 	uint16_t rxcnt;
+	/** Highest number of characters held in the RX buffer */
+	uint16_t rx_high_water;
+	/** Number of characters lost because the RX buffer was full */
+	uint32_t rx_overflows;
+	/** Number of hardware receive buffer overflows */
+	uint32_t rx_hw_overflows;
+	/** Number of characters discarded due to parity or frame errors */
+	uint32_t rx_errors;
 };
 
 /**
@@ -96,13 +166,37 @@ struct usart_async_descriptor {
 	uint32_t                     stat;
 
 	struct ringbuffer rx;
+	uint32_t          rx_hw_overflows;
+	uint32_t          rx_errors;
 	uint16_t          tx_por;
 	uint8_t *         tx_buffer;
 	uint16_t          tx_buffer_length;
+	bool              tx_dma;
+	bool              rx_dma;
+	uint16_t          rx_dma_pos;
+	uint8_t           rx_dma_crossed;
+	bool              rx_dma_ahead;
+	bool              rx_idle_pending;
+
+	struct usart_async_tx_buffer tx_queue[USART_ASYNC_TX_QUEUE_LENGTH];
+	uint8_t                      tx_head;
+	uint8_t                      tx_count;
+
+	struct framer *framer;
+
+	usart_timestamp_cb_t            rx_timestamp;
+	struct usart_async_rx_timestamp rx_frame;
+	bool                            rx_frame_open;
+	uint32_t                        rx_latency_min;
+	uint32_t                        rx_latency_max;
+	uint32_t                        rx_latency_count;
+	uint64_t                        rx_latency_sum;
 };
 
 /** USART write busy */
 #define USART_ASYNC_STATUS_BUSY 0x0001
+/** USART reception held back because the RX buffer is full */
+#define USART_ASYNC_STATUS_RX_BLOCKED 0x0002
 
 /**
  * \brief Initialize USART interface
@@ -161,6 +255,26 @@ int32_t usart_async_enable(struct usart_async_descriptor *const descr);
  */
 int32_t usart_async_disable(struct usart_async_descriptor *const descr);
 
+/**
+ * \brief Queue buffers for transmission
+ *
+ * The buffers are appended to the transmit queue as a whole and sent back to
+ * back, so a header and its payload can be given as separate buffers without
+ * a gap on the line. Each buffer's callback is called as soon as that buffer
+ * may be reused, tx_done callback is called when the queue has run empty and
+ * the last character has left the transmitter.
+ * io_write() queues a single buffer without a callback.
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ * \param[in] bufs The buffers to transmit
+ * \param[in] count The number of buffers
+ *
+ * \return The number of characters queued.
+ * \retval ERR_NO_RESOURCE The transmit queue can not take all the buffers
+ */
+int32_t usart_async_write_buffers(struct usart_async_descriptor *const descr,
+                                  const struct usart_async_tx_buffer *const bufs, const uint8_t count);
+
 /**
  * \brief Retrieve I/O descriptor
  *
@@ -176,6 +290,11 @@ int32_t usart_async_get_io_descriptor(struct usart_async_descriptor *const descr
 /**
  * \brief Register USART callback
  *
+ * USART_ASYNC_RX_START_CB is only available with DMA reception. It is called
+ * from the interrupt when a character starts to arrive while the receive
+ * start detection is armed; it is armed on registration and again by
+ * usart_async_check_rx_idle() once no data is pending.
+ *
  * \param[in] descr A USART descriptor which is used to communicate via USART
  * \param[in] type Callback type
  * \param[in] cb A callback function
@@ -213,6 +332,37 @@ int32_t usart_async_set_flow_control(struct usart_async_descriptor *const descr,
  */
 int32_t usart_async_set_baud_rate(struct usart_async_descriptor *const descr, const uint32_t baud_rate);
 
+/**
+ * \brief Find the USART baud rate setting closest to a baud rate
+ *
+ * Tries arithmetic and fractional baud rate generation with 16, 8 and 3
+ * samples per bit. More samples are preferred while the error stays below
+ * 0.1%. Nothing is written to the hardware.
+ *
+ * \param[in] baud Required baud rate
+ * \param[in] clock_rate Frequency of the SERCOM core clock
+ * \param[out] setting The best setting, with the actual baud rate and error
+ *
+ * \return ERR_NONE if a setting was found, ERR_INVALID_ARG if the baud rate is
+ * above a third of the clock rate or zero
+ */
+int32_t usart_async_solve_baud_rate(const uint32_t baud, const uint32_t clock_rate,
+                                    struct usart_baud_setting *const setting);
+
+/**
+ * \brief Apply a USART baud rate setting
+ *
+ * The baud rate is changed between characters only, the call fails while a
+ * transmission is in progress.
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ * \param[in] setting A setting found by usart_async_solve_baud_rate
+ *
+ * \return ERR_NONE on success, ERR_BUSY if a transmission is in progress
+ */
+int32_t usart_async_set_baud_setting(struct usart_async_descriptor *const    descr,
+                                     const struct usart_baud_setting *const setting);
+
 /**
  * \brief Set USART data order
  *
@@ -302,7 +452,7 @@ int32_t usart_async_is_tx_empty(const struct usart_async_descriptor *const descr
  * \retval 1 The USART receiver is not empty
  * \retval 0 The USART receiver is empty
  */
-int32_t usart_async_is_rx_not_empty(const struct usart_async_descriptor *const descr);
+int32_t usart_async_is_rx_not_empty(struct usart_async_descriptor *const descr);
 
 /**
  * \brief Retrieve the current interface status
@@ -314,6 +464,120 @@ int32_t usart_async_is_rx_not_empty(const struct usart_async_descriptor *const d
  */
 int32_t usart_async_get_status(struct usart_async_descriptor *const descr, struct usart_async_status *const status);
 
+/**
+ * \brief Set the RX buffer full strategy
+ *
+ * With RINGBUFFER_OVERWRITE_OLDEST (the default) the oldest received data is
+ * overwritten, with RINGBUFFER_REJECT_NEWEST newly received data is dropped.
+ * Both are counted in usart_async_status::rx_overflows.
+ * With RINGBUFFER_BLOCK the receive interrupt is disabled as soon as the RX
+ * buffer is full and USART_ASYNC_STATUS_RX_BLOCKED is set, leaving further
+ * data in the hardware; reception resumes when data is read from the buffer.
+ * When reception goes through the DMAC the oldest data is always overwritten,
+ * whatever the strategy. A DMA block interrupt held off while the DMAC goes
+ * a whole lap round the RX buffer is counted as a buffer full of lost data.
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ * \param[in] policy The RX buffer full strategy
+ *
+ * \return The status of strategy setting.
+ */
+int32_t usart_async_set_rx_overflow_policy(struct usart_async_descriptor *const  descr,
+                                           const enum ringbuffer_overflow_policy policy);
+
+/**
+ * \brief Clear the RX loss counters and high-water mark
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ *
+ * \return ERR_NONE
+ */
+int32_t usart_async_clear_rx_stats(struct usart_async_descriptor *const descr);
+
+/**
+ * \brief Parse received data into frames
+ *
+ * The framer is run in the receive path and hands complete frames to its
+ * callback straight from the RX buffer, before the RX callback is called.
+ * The framer has to be initialized on the RX buffer of the descriptor, and
+ * must be its only reader: io_read() must not be used while it is attached.
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ * \param[in] framer The framer to attach, NULL to detach the current one
+ *
+ * \return ERR_NONE
+ */
+int32_t usart_async_set_framer(struct usart_async_descriptor *const descr, struct framer *const framer);
+
+/**
+ * \brief Check the USART receiver for an idle line
+ *
+ * With DMA reception the RX callback is not called per character but when
+ * half of the RX buffer has been filled, or when the line turned idle after
+ * data was received. The SERCOM has no receive timeout, so this function has
+ * to be called again while it returns ERR_NOT_READY, e.g. from a one-shot
+ * timer task; the idle timeout is the calling period. Once it returns
+ * anything else, the USART_ASYNC_RX_START_CB callback is armed and can start
+ * the timer task again, so an idle line needs no polling.
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ *
+ * \return The status of idle checking.
+ * \retval ERR_NONE The line turned idle, the RX callback has been called
+ * \retval ERR_NOT_READY Data arrived since the previous check
+ * \retval ERR_NO_CHANGE No data is pending
+ * \retval ERR_UNSUPPORTED_OP Reception does not go through the DMAC
+ */
+int32_t usart_async_check_rx_idle(struct usart_async_descriptor *const descr);
+
+/**
+ * \brief Time stamp received frames
+ *
+ * The receive path reads the time stamp source when the first and the last
+ * character of a frame arrive. A frame ends when the framer hands it to its
+ * callback, or with each RX callback when no framer is attached. With DMA
+ * reception, characters are seen when a block is complete and at idle checks
+ * only. The first character after an idle line is stamped from the receive
+ * start interrupt while USART_ASYNC_RX_START_CB is registered, other time
+ * stamps are taken when the data is seen. The end of a frame is then late by
+ * up to one idle check period, and the latency measured from it is short by
+ * as much: it covers the time from the idle check or block interrupt that
+ * delivered the last character, not from its arrival.
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ * \param[in] timestamp The time stamp source, NULL to stop time stamping
+ *
+ * \return ERR_NONE
+ */
+int32_t usart_async_set_rx_timestamp(struct usart_async_descriptor *const descr, usart_timestamp_cb_t timestamp);
+
+/**
+ * \brief Retrieve the time stamps of the received frame
+ *
+ * To be called once from the RX or frame callback. The time from the end of
+ * the frame to this call is added to the latency statistics.
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ * \param[out] frame The time stamps of the frame being delivered
+ *
+ * \return ERR_NONE on success, ERR_UNSUPPORTED_OP if time stamping is off
+ */
+int32_t usart_async_get_rx_timestamp(struct usart_async_descriptor *const   descr,
+                                     struct usart_async_rx_timestamp *const frame);
+
+/**
+ * \brief Retrieve the receive latency statistics
+ *
+ * The statistics are reset by usart_async_clear_rx_stats().
+ *
+ * \param[in] descr A USART descriptor which is used to communicate via USART
+ * \param[out] latency The latency statistics, all zero if nothing was measured
+ *
+ * \return ERR_NONE
+ */
+int32_t usart_async_get_rx_latency(struct usart_async_descriptor *const descr,
+                                   struct usart_async_rx_latency *const latency);
+
 /**
  * \brief flush USART ringbuf
  *
@@ -0,0 +1,458 @@
+/**
+ * \file
+ *
+ * \brief Timer functionality implementation.
+ *
+ * Copyright (c) 2014-2018 Microchip Technology Inc. and its subsidiaries.
+ *
+ * \asf_license_start
+ *
+ * \page License
+ *
+ * Subject to your compliance with these terms, you may use Microchip
+ * software and any derivatives exclusively with Microchip products.
+ * It is your responsibility to comply with third party license terms applicable
+ * to your use of third party software (including open source software) that
+ * may accompany Microchip software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES,
+ * WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE,
+ * INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY,
+ * AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL MICROCHIP BE
+ * LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR CONSEQUENTIAL
+ * LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO THE
+ * SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE
+ * POSSIBILITY OR THE DAMAGES ARE FORESEEABLE.  TO THE FULLEST EXTENT
+ * ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN ANY WAY
+ * RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+ * THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+ *
+ * \asf_license_stop
+ *
+ */
+
+#include "hal_timer.h"
+#include <utils_assert.h>
+#include <utils.h>
+#include <hal_atomic.h>
+#include <hpl_irq.h>
+
+/**
+ * \brief Driver version
+ */
+#define DRIVER_VERSION 0x00000001u
+
+/**
+ * \brief Timer flags
+ */
+#define TIMER_FLAG_QUEUE_IS_TAKEN 1
+#define TIMER_FLAG_INTERRUPT_TRIGERRED 2
+#define TIMER_FLAG_PROCESSING 4
+
+#if (TIMER_WHEEL_SLOTS & (TIMER_WHEEL_SLOTS - 1)) != 0
+#error "TIMER_WHEEL_SLOTS must be a power of two"
+#endif
+
+static inline void             timer_task_set_due(struct timer_task *const task);
+static struct list_descriptor *timer_task_slot(struct timer_descriptor *const descr, const struct timer_task *const task);
+static void                    timer_process_counted(struct _timer_device *device);
+#if TIMER_TICKLESS
+static void timer_update_time(struct timer_descriptor *const descr);
+#endif
+
+/**
+ * \brief Initialize timer
+ */
+int32_t timer_init(struct timer_descriptor *const descr, void *const hw, struct _timer_hpl_interface *const func)
+{
+	uint8_t i;
+
+	ASSERT(descr && hw);
+	_timer_init(&descr->device, hw);
+	descr->time       = 0;
+	descr->wheel_time = 0;
+	for (i = 0; i < TIMER_WHEEL_SLOTS; i++) {
+		list_reset(&descr->wheel[i]);
+	}
+	descr->device.timer_cb.period_expired = timer_process_counted;
+#if TIMER_TICKLESS
+	/* A period of CC0 counts CC0 + 1 clock cycles */
+	descr->tick_cycles = _timer_get_period(&descr->device) + 1;
+	_timer_set_free_running(&descr->device);
+	descr->top    = _timer_get_counter_top(&descr->device);
+	descr->count  = _timer_get_counter(&descr->device);
+	descr->cycles = 0;
+#endif
+
+	return ERR_NONE;
+}
+
+/**
+ * \brief Deinitialize timer
+ */
+int32_t timer_deinit(struct timer_descriptor *const descr)
+{
+	ASSERT(descr);
+	_timer_deinit(&descr->device);
+
+	return ERR_NONE;
+}
+
+/**
+ * \brief Start timer
+ */
+int32_t timer_start(struct timer_descriptor *const descr)
+{
+	ASSERT(descr);
+	if (_timer_is_started(&descr->device)) {
+		return ERR_DENIED;
+	}
+	_timer_start(&descr->device);
+#if TIMER_TICKLESS
+	/* Set the compare for the first task due */
+	_timer_set_irq(&descr->device);
+#endif
+
+	return ERR_NONE;
+}
+
+/**
+ * \brief Stop timer
+ */
+int32_t timer_stop(struct timer_descriptor *const descr)
+{
+	ASSERT(descr);
+	if (!_timer_is_started(&descr->device)) {
+		return ERR_DENIED;
+	}
+	_timer_stop(&descr->device);
+
+	return ERR_NONE;
+}
+
+/**
+ * \brief Set amount of clock cycler per timer tick
+ */
+int32_t timer_set_clock_cycles_per_tick(struct timer_descriptor *const descr, const uint32_t clock_cycles)
+{
+	ASSERT(descr);
+#if TIMER_TICKLESS
+	CRITICAL_SECTION_ENTER()
+	timer_update_time(descr);
+	descr->tick_cycles = clock_cycles + 1;
+	descr->time += descr->cycles / descr->tick_cycles;
+	descr->cycles %= descr->tick_cycles;
+	CRITICAL_SECTION_LEAVE()
+	if (_timer_is_started(&descr->device)) {
+		_timer_set_irq(&descr->device);
+	}
+#else
+	_timer_set_period(&descr->device, clock_cycles);
+#endif
+
+	return ERR_NONE;
+}
+
+/**
+ * \brief Add timer task
+ */
+int32_t timer_add_task(struct timer_descriptor *const descr, struct timer_task *const task)
+{
+	ASSERT(descr && task);
+
+	descr->flags |= TIMER_FLAG_QUEUE_IS_TAKEN;
+	if (is_list_element(timer_task_slot(descr, task), task)) {
+		descr->flags &= ~TIMER_FLAG_QUEUE_IS_TAKEN;
+		ASSERT(false);
+		return ERR_ALREADY_INITIALIZED;
+	}
+#if TIMER_TICKLESS
+	CRITICAL_SECTION_ENTER()
+	timer_update_time(descr);
+	CRITICAL_SECTION_LEAVE()
+#endif
+	task->time_label = descr->time;
+	timer_task_set_due(task);
+	list_insert_as_head(timer_task_slot(descr, task), task);
+
+	descr->flags &= ~TIMER_FLAG_QUEUE_IS_TAKEN;
+	if (descr->flags & TIMER_FLAG_INTERRUPT_TRIGERRED) {
+		CRITICAL_SECTION_ENTER()
+		descr->flags &= ~TIMER_FLAG_INTERRUPT_TRIGERRED;
+		_timer_set_irq(&descr->device);
+		CRITICAL_SECTION_LEAVE()
+	}
+#if TIMER_TICKLESS
+	else if (!(descr->flags & TIMER_FLAG_PROCESSING) && _timer_is_started(&descr->device)) {
+		/* The task may be due before the compare set, the interrupt sets it again */
+		_timer_set_irq(&descr->device);
+	}
+#endif
+
+	return ERR_NONE;
+}
+
+/**
+ * \brief Remove timer task
+ */
+int32_t timer_remove_task(struct timer_descriptor *const descr, const struct timer_task *const task)
+{
+	ASSERT(descr && task);
+
+	descr->flags |= TIMER_FLAG_QUEUE_IS_TAKEN;
+	if (!list_delete_element(timer_task_slot(descr, task), task)) {
+		descr->flags &= ~TIMER_FLAG_QUEUE_IS_TAKEN;
+		ASSERT(false);
+		return ERR_NOT_FOUND;
+	}
+
+	descr->flags &= ~TIMER_FLAG_QUEUE_IS_TAKEN;
+	if (descr->flags & TIMER_FLAG_INTERRUPT_TRIGERRED) {
+		CRITICAL_SECTION_ENTER()
+		descr->flags &= ~TIMER_FLAG_INTERRUPT_TRIGERRED;
+		_timer_set_irq(&descr->device);
+		CRITICAL_SECTION_LEAVE()
+	}
+
+	return ERR_NONE;
+}
+
+/**
+ * \brief Retrieve the amount of clock cycles in a tick
+ */
+int32_t timer_get_clock_cycles_in_tick(const struct timer_descriptor *const descr, uint32_t *const cycles)
+{
+	ASSERT(descr && cycles);
+#if TIMER_TICKLESS
+	*cycles = descr->tick_cycles - 1;
+#else
+	*cycles = _timer_get_period(&descr->device);
+#endif
+	return ERR_NONE;
+}
+
+/**
+ * \brief Retrieve the number of clock cycles since the timer was started
+ */
+int32_t timer_get_timestamp(const struct timer_descriptor *const descr, uint32_t *const cycles)
+{
+	uint32_t time;
+	uint32_t count;
+
+	ASSERT(descr && cycles);
+
+#if TIMER_TICKLESS
+	CRITICAL_SECTION_ENTER()
+	time  = descr->time;
+	count = descr->cycles + ((_timer_get_counter(&descr->device) - descr->count) & descr->top);
+	CRITICAL_SECTION_LEAVE()
+
+	*cycles = time * descr->tick_cycles + count;
+	return ERR_NONE;
+#else
+	CRITICAL_SECTION_ENTER()
+	time  = descr->time;
+	count = _timer_get_counter(&descr->device);
+	if (_timer_is_period_pending(&descr->device)) {
+		/* The tick is not counted yet, the counter may have wrapped after it was read */
+		time++;
+		count = _timer_get_counter(&descr->device);
+	}
+	CRITICAL_SECTION_LEAVE()
+
+	*cycles = time * (_timer_get_period(&descr->device) + 1) + count;
+	return ERR_NONE;
+#endif
+}
+
+/**
+ * \brief Retrieve the current driver version
+ */
+uint32_t timer_get_version(void)
+{
+	return DRIVER_VERSION;
+}
+
+/**
+ * \internal Set the timer time a task is due on
+ *
+ * A task fires on the first tick at least interval ticks after it was added,
+ * so an interval of 0 is due on the next tick. The due time is kept in the
+ * task while it is queued, so it stays in its slot whatever the interval is
+ * changed to meanwhile.
+ *
+ * \param[in] task The pointer to the task
+ */
+static inline void timer_task_set_due(struct timer_task *const task)
+{
+	task->due = task->time_label + (task->interval ? task->interval : 1);
+}
+
+/**
+ * \internal Retrieve the wheel slot of a timer task
+ *
+ * \param[in] descr The timer descriptor
+ * \param[in] task The pointer to the task
+ */
+static struct list_descriptor *timer_task_slot(struct timer_descriptor *const descr, const struct timer_task *const task)
+{
+	return &descr->wheel[task->due & (TIMER_WHEEL_SLOTS - 1)];
+}
+
+#if TIMER_TICKLESS
+/**
+ * \internal Bring the timer time up to date from the free running counter
+ *
+ * Must be called at least once per counter wrap, with interrupts disabled
+ * outside of the timer interrupt.
+ *
+ * \param[in] descr The timer descriptor
+ */
+static void timer_update_time(struct timer_descriptor *const descr)
+{
+	uint32_t count   = _timer_get_counter(&descr->device);
+	uint32_t elapsed = (count - descr->count) & descr->top;
+
+	descr->count = count;
+	descr->time += elapsed / descr->tick_cycles;
+	descr->cycles += elapsed % descr->tick_cycles;
+	if (descr->cycles >= descr->tick_cycles) {
+		descr->cycles -= descr->tick_cycles;
+		descr->time++;
+	}
+}
+
+/**
+ * \internal Retrieve the number of ticks until the next task is due
+ *
+ * \param[in] descr The timer descriptor
+ *
+ * \return Ticks after the wheel time, 0xFFFFFFFF if there are no tasks
+ */
+static uint32_t timer_next_due(struct timer_descriptor *const descr)
+{
+	uint32_t next = 0xFFFFFFFF;
+	uint8_t  i;
+
+	for (i = 0; i < TIMER_WHEEL_SLOTS; i++) {
+		struct timer_task *it;
+
+		for (it = (struct timer_task *)list_get_head(&descr->wheel[i]); it;
+		     it = (struct timer_task *)list_get_next_element(it)) {
+			uint32_t ticks = it->due - descr->wheel_time;
+
+			if (ticks < next) {
+				next = ticks;
+			}
+		}
+	}
+
+	return next;
+}
+
+/**
+ * \internal Set the compare interrupt for the next task due
+ *
+ * The compare is never set more than half a counter wrap ahead, so the time
+ * is brought up to date before the counter can wrap past it. If the counter
+ * gets to the compare before it is set, the interrupt is raised straight away.
+ *
+ * \param[in] descr The timer descriptor
+ */
+static void timer_schedule(struct timer_descriptor *const descr)
+{
+	uint32_t limit = descr->top >> 1;
+	uint32_t next  = timer_next_due(descr);
+	uint32_t cycles;
+
+	/* Ticks came while the tasks were processed */
+	if (descr->wheel_time != descr->time) {
+		_timer_set_irq(&descr->device);
+		return;
+	}
+
+	if (next > limit / descr->tick_cycles) {
+		cycles = limit;
+	} else {
+		cycles = next * descr->tick_cycles - descr->cycles;
+	}
+	_timer_set_compare(&descr->device, (descr->count + cycles) & descr->top);
+
+	if (((_timer_get_counter(&descr->device) - descr->count) & descr->top) >= cycles) {
+		_timer_set_irq(&descr->device);
+	}
+}
+#endif
+
+/**
+ * \internal Process interrupts
+ *
+ * Every tick the slot of the tick is searched for the tasks due on it. Tasks
+ * further ahead share the slot until their turn comes round. Ticks that came
+ * while the task wheel was taken are caught up on the next one. A tickless
+ * timer gets here on the compare set for the next task due, and catches up on
+ * all the ticks since.
+ */
+static void timer_process_counted(struct _timer_device *device)
+{
+	struct timer_descriptor *timer = CONTAINER_OF(device, struct timer_descriptor, device);
+#if TIMER_TICKLESS
+	uint32_t time;
+
+	timer_update_time(timer);
+	time = timer->time;
+#else
+	uint32_t time = ++timer->time;
+#endif
+
+	if ((timer->flags & TIMER_FLAG_QUEUE_IS_TAKEN) || (timer->flags & TIMER_FLAG_INTERRUPT_TRIGERRED)) {
+		timer->flags |= TIMER_FLAG_INTERRUPT_TRIGERRED;
+		return;
+	}
+
+	timer->flags |= TIMER_FLAG_PROCESSING;
+	while (timer->wheel_time != time) {
+		uint32_t                now;
+		struct list_descriptor *slot;
+
+#if TIMER_TICKLESS
+		/* After a long sleep go straight to the tick before the next task due */
+		if (time - timer->wheel_time > TIMER_WHEEL_SLOTS) {
+			uint32_t next = timer_next_due(timer);
+
+			if (next > time - timer->wheel_time) {
+				next = time - timer->wheel_time;
+			}
+			timer->wheel_time += next - 1;
+		}
+#endif
+		now  = ++timer->wheel_time;
+		slot = &timer->wheel[now & (TIMER_WHEEL_SLOTS - 1)];
+
+		/* Callbacks may add and remove tasks, so look the slot up again after each */
+		for (;;) {
+			struct timer_task *it = (struct timer_task *)list_get_head(slot);
+
+			while (it && it->due != now) {
+				it = (struct timer_task *)list_get_next_element(it);
+			}
+			if (!it) {
+				break;
+			}
+
+			list_delete_element(slot, it);
+			if (TIMER_TASK_REPEAT == it->mode) {
+				it->time_label = time;
+				timer_task_set_due(it);
+				list_insert_as_head(timer_task_slot(timer, it), it);
+			}
+
+			it->cb(it);
+		}
+	}
+	timer->flags &= ~TIMER_FLAG_PROCESSING;
+
+#if TIMER_TICKLESS
+	timer_schedule(timer);
+#endif
+}
@@ -44,9 +44,20 @@
 static int32_t usart_async_write(struct io_descriptor *const io_descr, const uint8_t *const buf, const uint16_t length);
 static int32_t usart_async_read(struct io_descriptor *const io_descr, uint8_t *const buf, const uint16_t length);
 static void    usart_process_byte_sent(struct _usart_async_device *device);
+static void    usart_dma_tx_done(struct _usart_async_device *device);
+static void    usart_tx_start(struct usart_async_descriptor *const descr);
+static void    usart_tx_buffer_done(struct usart_async_descriptor *const descr);
 static void    usart_transmission_complete(struct _usart_async_device *device);
 static void    usart_error(struct _usart_async_device *device);
 static void    usart_fill_rx_buffer(struct _usart_async_device *device, uint8_t data);
+static void    usart_rx_error(struct _usart_async_device *device, uint8_t errors);
+static void    usart_resume_rx(struct usart_async_descriptor *const descr);
+static void    usart_dma_rx_block_done(struct _usart_async_device *device);
+static void    usart_rx_start(struct _usart_async_device *device);
+static void    usart_run_framer(struct usart_async_descriptor *const descr);
+static uint32_t usart_dma_rx_sync(struct usart_async_descriptor *const descr);
+static void    usart_rx_timestamp(struct usart_async_descriptor *const descr);
+static void    usart_rx_callback(struct usart_async_descriptor *const descr);
 
 /**
  * \brief Initialize usart interface
@@ -72,6 +83,22 @@ int32_t usart_async_init(struct usart_async_descriptor *const descr, void *const
 	descr->device.usart_cb.rx_done_cb   = usart_fill_rx_buffer;
 	descr->device.usart_cb.tx_done_cb   = usart_transmission_complete;
 	descr->device.usart_cb.error_cb     = usart_error;
+	descr->device.usart_cb.rx_error_cb  = usart_rx_error;
+
+	descr->device.usart_cb.rx_dma_block_cb = usart_dma_rx_block_done;
+	descr->device.usart_cb.tx_dma_done_cb  = usart_dma_tx_done;
+	descr->device.usart_cb.rx_start_cb     = usart_rx_start;
+	descr->tx_head                         = 0;
+	descr->tx_count                        = 0;
+	descr->framer                          = NULL;
+	descr->rx_dma_pos                      = 0;
+	descr->rx_dma_crossed                  = 0;
+	descr->rx_dma_ahead                    = false;
+	descr->rx_idle_pending                 = false;
+	descr->rx_timestamp                    = NULL;
+	descr->rx_frame_open                   = false;
+	usart_async_clear_rx_stats(descr);
+	descr->rx_dma = (ERR_NONE == _usart_async_dma_rx_start(&descr->device, rx_buffer, rx_buffer_length));
 
 	return ERR_NONE;
 }
@@ -111,6 +138,42 @@ int32_t usart_async_disable(struct usart_async_descriptor *const descr)
 	return ERR_NONE;
 }
 
+/**
+ * \brief Queue buffers for transmission
+ */
+int32_t usart_async_write_buffers(struct usart_async_descriptor *const descr,
+                                  const struct usart_async_tx_buffer *const bufs, const uint8_t count)
+{
+	int32_t rc = 0;
+	uint8_t i;
+
+	ASSERT(descr && bufs && count);
+
+	for (i = 0; i < count; i++) {
+		ASSERT(bufs[i].buf && bufs[i].length);
+		rc += bufs[i].length;
+	}
+
+	CRITICAL_SECTION_ENTER()
+	if (descr->tx_count + count > USART_ASYNC_TX_QUEUE_LENGTH) {
+		rc = ERR_NO_RESOURCE;
+	} else {
+		for (i = 0; i < count; i++) {
+			descr->tx_queue[(descr->tx_head + descr->tx_count + i) % USART_ASYNC_TX_QUEUE_LENGTH] = bufs[i];
+		}
+		descr->tx_count += count;
+		descr->stat |= USART_ASYNC_STATUS_BUSY;
+
+		/* Otherwise the queued buffers follow once the current ones are sent */
+		if (descr->tx_count == count) {
+			usart_tx_start(descr);
+		}
+	}
+	CRITICAL_SECTION_LEAVE()
+
+	return rc;
+}
+
 /**
  * \brief Retrieve I/O descriptor
  */
@@ -133,7 +196,10 @@ int32_t usart_async_register_callback(struct usart_async_descriptor *const descr
 	switch (type) {
 	case USART_ASYNC_RXC_CB:
 		descr->usart_cb.rx_done = cb;
-		_usart_async_set_irq_state(&descr->device, USART_ASYNC_RX_DONE, NULL != cb);
+		/* The DMAC drains the data register when reception goes through DMA */
+		if (!descr->rx_dma) {
+			_usart_async_set_irq_state(&descr->device, USART_ASYNC_RX_DONE, NULL != cb);
+		}
 		break;
 	case USART_ASYNC_TXC_CB:
 		descr->usart_cb.tx_done = cb;
@@ -143,6 +209,13 @@ int32_t usart_async_register_callback(struct usart_async_descriptor *const descr
 		descr->usart_cb.error = cb;
 		_usart_async_set_irq_state(&descr->device, USART_ASYNC_ERROR, NULL != cb);
 		break;
+	case USART_ASYNC_RX_START_CB:
+		if (!descr->rx_dma) {
+			return ERR_UNSUPPORTED_OP;
+		}
+		descr->usart_cb.rx_start = cb;
+		_usart_async_set_irq_state(&descr->device, USART_ASYNC_RX_START, NULL != cb);
+		break;
 	default:
 		return ERR_INVALID_ARG;
 	}
@@ -173,6 +246,33 @@ int32_t usart_async_set_baud_rate(struct usart_async_descriptor *const descr, co
 	return ERR_NONE;
 }
 
+/**
+ * \brief Find usart baud rate setting
+ */
+int32_t usart_async_solve_baud_rate(const uint32_t baud, const uint32_t clock_rate,
+                                    struct usart_baud_setting *const setting)
+{
+	ASSERT(setting);
+
+	return _usart_async_solve_baud_rate(baud, clock_rate, setting);
+}
+
+/**
+ * \brief Set usart baud rate setting
+ */
+int32_t usart_async_set_baud_setting(struct usart_async_descriptor *const    descr,
+                                     const struct usart_baud_setting *const setting)
+{
+	ASSERT(descr && setting);
+
+	if (descr->stat & USART_ASYNC_STATUS_BUSY) {
+		return ERR_BUSY;
+	}
+	_usart_async_set_baud_setting(&descr->device, setting);
+
+	return ERR_NONE;
+}
+
 /**
  * \brief Set usart data order
  */
@@ -252,10 +352,12 @@ int32_t usart_async_is_tx_empty(const struct usart_async_descriptor *const descr
 /**
  * \brief Check if the usart receiver is not empty
  */
-int32_t usart_async_is_rx_not_empty(const struct usart_async_descriptor *const descr)
+int32_t usart_async_is_rx_not_empty(struct usart_async_descriptor *const descr)
 {
 	ASSERT(descr);
 
+	usart_dma_rx_sync(descr);
+
 	return ringbuffer_num(&descr->rx) > 0;
 }
 
@@ -269,10 +371,18 @@ int32_t usart_async_get_status(struct usart_async_descriptor *const descr, struc
 	volatile uint32_t *tmp_stat  = &(descr->stat);
 	volatile uint16_t *tmp_txcnt = &(descr->tx_por);
 
+	usart_dma_rx_sync(descr);
+
 	if (status) {
 		status->flags = *tmp_stat;
 		status->txcnt = *tmp_txcnt;
-		status->rxcnt = ringbuffer_num(&descr->rx);
+		CRITICAL_SECTION_ENTER()
+		status->rxcnt           = ringbuffer_num(&descr->rx);
+		status->rx_high_water   = descr->rx.high_water;
+		status->rx_overflows    = descr->rx.overflows;
+		status->rx_hw_overflows = descr->rx_hw_overflows;
+		status->rx_errors       = descr->rx_errors;
+		CRITICAL_SECTION_LEAVE()
 	}
 	if (*tmp_stat & USART_ASYNC_STATUS_BUSY) {
 		return ERR_BUSY;
@@ -281,14 +391,188 @@ int32_t usart_async_get_status(struct usart_async_descriptor *const descr, struc
 	return ERR_NONE;
 }
 
+/**
+ * \brief Set usart rx buffer full strategy
+ */
+int32_t usart_async_set_rx_overflow_policy(struct usart_async_descriptor *const  descr,
+                                           const enum ringbuffer_overflow_policy policy)
+{
+	int32_t rc;
+
+	ASSERT(descr);
+
+	CRITICAL_SECTION_ENTER()
+	rc = ringbuffer_set_policy(&descr->rx, policy);
+	CRITICAL_SECTION_LEAVE()
+	usart_resume_rx(descr);
+
+	return rc;
+}
+
+/**
+ * \brief Clear usart rx statistics
+ */
+int32_t usart_async_clear_rx_stats(struct usart_async_descriptor *const descr)
+{
+	ASSERT(descr);
+
+	CRITICAL_SECTION_ENTER()
+	ringbuffer_clear_stats(&descr->rx);
+	descr->rx_hw_overflows  = 0;
+	descr->rx_errors        = 0;
+	descr->rx_latency_min   = UINT32_MAX;
+	descr->rx_latency_max   = 0;
+	descr->rx_latency_count = 0;
+	descr->rx_latency_sum   = 0;
+	CRITICAL_SECTION_LEAVE()
+
+	return ERR_NONE;
+}
+
+/**
+ * \brief Attach a framer to usart rx ringbuf
+ */
+int32_t usart_async_set_framer(struct usart_async_descriptor *const descr, struct framer *const framer)
+{
+	ASSERT(descr);
+	ASSERT(!framer || framer->rb == &descr->rx);
+
+	CRITICAL_SECTION_ENTER()
+	descr->framer = framer;
+	CRITICAL_SECTION_LEAVE()
+
+	return ERR_NONE;
+}
+
+/**
+ * \brief Check usart rx line for idle
+ */
+int32_t usart_async_check_rx_idle(struct usart_async_descriptor *const descr)
+{
+	bool received;
+	bool idle = false;
+
+	ASSERT(descr);
+
+	if (!descr->rx_dma) {
+		return ERR_UNSUPPORTED_OP;
+	}
+
+	CRITICAL_SECTION_ENTER()
+	received = usart_dma_rx_sync(descr);
+	if (!received && descr->usart_cb.rx_start) {
+		/* Arm the receive start, then catch a character that came just before */
+		_usart_async_set_irq_state(&descr->device, USART_ASYNC_RX_START, true);
+		received = usart_dma_rx_sync(descr);
+	}
+	if (received) {
+		descr->rx_idle_pending = true;
+	} else if (descr->rx_idle_pending) {
+		descr->rx_idle_pending = false;
+		idle                   = true;
+	}
+	CRITICAL_SECTION_LEAVE()
+
+	if (received) {
+		usart_run_framer(descr);
+	}
+	if (idle) {
+		usart_rx_callback(descr);
+	}
+
+	if (received) {
+		return ERR_NOT_READY;
+	}
+	return idle ? ERR_NONE : ERR_NO_CHANGE;
+}
+
+/**
+ * \brief Time stamp usart rx frames
+ */
+int32_t usart_async_set_rx_timestamp(struct usart_async_descriptor *const descr, usart_timestamp_cb_t timestamp)
+{
+	ASSERT(descr);
+
+	CRITICAL_SECTION_ENTER()
+	descr->rx_timestamp  = timestamp;
+	descr->rx_frame_open = false;
+	CRITICAL_SECTION_LEAVE()
+
+	return ERR_NONE;
+}
+
+/**
+ * \brief Retrieve usart rx frame time stamps
+ */
+int32_t usart_async_get_rx_timestamp(struct usart_async_descriptor *const   descr,
+                                     struct usart_async_rx_timestamp *const frame)
+{
+	uint32_t now;
+	uint32_t latency;
+
+	ASSERT(descr && frame);
+
+	if (!descr->rx_timestamp) {
+		return ERR_UNSUPPORTED_OP;
+	}
+	now = descr->rx_timestamp();
+
+	CRITICAL_SECTION_ENTER()
+	*frame  = descr->rx_frame;
+	latency = now - frame->end;
+	if (latency < descr->rx_latency_min) {
+		descr->rx_latency_min = latency;
+	}
+	if (latency > descr->rx_latency_max) {
+		descr->rx_latency_max = latency;
+	}
+	descr->rx_latency_count++;
+	descr->rx_latency_sum += latency;
+	CRITICAL_SECTION_LEAVE()
+
+	return ERR_NONE;
+}
+
+/**
+ * \brief Retrieve usart rx latency statistics
+ */
+int32_t usart_async_get_rx_latency(struct usart_async_descriptor *const descr,
+                                   struct usart_async_rx_latency *const latency)
+{
+	ASSERT(descr && latency);
+
+	CRITICAL_SECTION_ENTER()
+	latency->count = descr->rx_latency_count;
+	if (latency->count) {
+		latency->min = descr->rx_latency_min;
+		latency->max = descr->rx_latency_max;
+		latency->avg = (uint32_t)(descr->rx_latency_sum / latency->count);
+	} else {
+		latency->min = 0;
+		latency->max = 0;
+		latency->avg = 0;
+	}
+	CRITICAL_SECTION_LEAVE()
+
+	return ERR_NONE;
+}
+
 /**
  * \brief flush usart rx ringbuf
  */
 int32_t usart_async_flush_rx_buffer(struct usart_async_descriptor *const descr)
 {
+	int32_t rc;
+
 	ASSERT(descr);
 
-	return ringbuffer_flush(&descr->rx);
+	CRITICAL_SECTION_ENTER()
+	usart_dma_rx_sync(descr);
+	rc = ringbuffer_flush(&descr->rx);
+	CRITICAL_SECTION_LEAVE()
+	usart_resume_rx(descr);
+
+	return rc;
 }
 
 /**
@@ -311,19 +595,15 @@ uint32_t usart_async_get_version(void)
 static int32_t usart_async_write(struct io_descriptor *const io_descr, const uint8_t *const buf, const uint16_t length)
 {
 	struct usart_async_descriptor *descr = CONTAINER_OF(io_descr, struct usart_async_descriptor, io);
+	struct usart_async_tx_buffer   txb;
 
 	ASSERT(descr && buf && length);
 
-	if (descr->tx_por != descr->tx_buffer_length) {
-		return ERR_NO_RESOURCE;
-	}
-	descr->tx_buffer        = (uint8_t *)buf;
-	descr->tx_buffer_length = length;
-	descr->tx_por           = 0;
-	descr->stat             = USART_ASYNC_STATUS_BUSY;
-	_usart_async_enable_byte_sent_irq(&descr->device);
+	txb.buf    = buf;
+	txb.length = length;
+	txb.cb     = NULL;
 
-	return (int32_t)length;
+	return usart_async_write_buffers(descr, &txb, 1);
 }
 
 /*
@@ -337,21 +617,23 @@ static int32_t usart_async_write(struct io_descriptor *const io_descr, const uin
  */
 static int32_t usart_async_read(struct io_descriptor *const io_descr, uint8_t *const buf, const uint16_t length)
 {
-	uint16_t                       was_read = 0;
 	uint32_t                       num;
 	struct usart_async_descriptor *descr = CONTAINER_OF(io_descr, struct usart_async_descriptor, io);
 
 	ASSERT(descr && buf && length);
 
 	CRITICAL_SECTION_ENTER()
+	usart_dma_rx_sync(descr);
 	num = ringbuffer_num(&descr->rx);
 	CRITICAL_SECTION_LEAVE()
 
-	while ((was_read < num) && (was_read < length)) {
-		ringbuffer_get(&descr->rx, &buf[was_read++]);
+	if (num > length) {
+		num = length;
 	}
+	num = ringbuffer_read(&descr->rx, buf, num);
+	usart_resume_rx(descr);
 
-	return (int32_t)was_read;
+	return (int32_t)num;
 }
 
 /**
@@ -362,12 +644,78 @@ static int32_t usart_async_read(struct io_descriptor *const io_descr, uint8_t *c
 static void usart_process_byte_sent(struct _usart_async_device *device)
 {
 	struct usart_async_descriptor *descr = CONTAINER_OF(device, struct usart_async_descriptor, device);
+
+	/* The DMAC feeds the data register, nothing to do here */
+	if (descr->tx_dma) {
+		return;
+	}
 	if (descr->tx_por != descr->tx_buffer_length) {
 		_usart_async_write_byte(&descr->device, descr->tx_buffer[descr->tx_por++]);
+	}
+	if (descr->tx_por != descr->tx_buffer_length) {
 		_usart_async_enable_byte_sent_irq(&descr->device);
+	} else {
+		usart_tx_buffer_done(descr);
+	}
+}
+
+/**
+ * \brief Process completion of a DMA transmission
+ *
+ * \param[in] device The pointer to device structure
+ */
+static void usart_dma_tx_done(struct _usart_async_device *device)
+{
+	struct usart_async_descriptor *descr = CONTAINER_OF(device, struct usart_async_descriptor, device);
+
+	descr->tx_por = descr->tx_buffer_length;
+	usart_tx_buffer_done(descr);
+}
+
+/**
+ * \brief Start transmission of the buffer at the head of the transmit queue
+ *
+ * \param[in] descr The pointer to USART descriptor
+ */
+static void usart_tx_start(struct usart_async_descriptor *const descr)
+{
+	const struct usart_async_tx_buffer *txb = &descr->tx_queue[descr->tx_head];
+
+	descr->tx_buffer        = (uint8_t *)txb->buf;
+	descr->tx_buffer_length = txb->length;
+	descr->tx_por           = 0;
+
+	descr->tx_dma = true;
+	if (ERR_NONE != _usart_async_dma_write(&descr->device, txb->buf, txb->length)) {
+		descr->tx_dma = false;
+		_usart_async_enable_byte_sent_irq(&descr->device);
+	}
+}
+
+/**
+ * \brief Release the buffer at the head of the transmit queue
+ *
+ * The next buffer is started right away, the transmission complete interrupt
+ * is only waited for once the queue has run empty.
+ *
+ * \param[in] descr The pointer to USART descriptor
+ */
+static void usart_tx_buffer_done(struct usart_async_descriptor *const descr)
+{
+	struct usart_async_tx_buffer done = descr->tx_queue[descr->tx_head];
+
+	descr->tx_head = (descr->tx_head + 1) % USART_ASYNC_TX_QUEUE_LENGTH;
+	descr->tx_count--;
+
+	if (descr->tx_count) {
+		usart_tx_start(descr);
 	} else {
 		_usart_async_enable_tx_done_irq(&descr->device);
 	}
+
+	if (done.cb) {
+		done.cb(descr, done.buf);
+	}
 }
 
 /**
@@ -379,7 +727,12 @@ static void usart_transmission_complete(struct _usart_async_device *device)
 {
 	struct usart_async_descriptor *descr = CONTAINER_OF(device, struct usart_async_descriptor, device);
 
-	descr->stat = 0;
+	/* Buffers were queued while the last character was shifted out */
+	if (descr->tx_count) {
+		return;
+	}
+	descr->tx_dma = false;
+	descr->stat &= ~USART_ASYNC_STATUS_BUSY;
 	if (descr->usart_cb.tx_done) {
 		descr->usart_cb.tx_done(descr);
 	}
@@ -395,11 +748,191 @@ static void usart_fill_rx_buffer(struct _usart_async_device *device, uint8_t dat
 {
 	struct usart_async_descriptor *descr = CONTAINER_OF(device, struct usart_async_descriptor, device);
 
+	usart_rx_timestamp(descr);
 	ringbuffer_put(&descr->rx, data);
+	usart_run_framer(descr);
+
+	/* Hold further data back in the hardware until the buffer drains */
+	if (descr->rx.policy == RINGBUFFER_BLOCK && !ringbuffer_space(&descr->rx)) {
+		descr->stat |= USART_ASYNC_STATUS_RX_BLOCKED;
+		_usart_async_set_irq_state(&descr->device, USART_ASYNC_RX_DONE, false);
+	}
+
+	usart_rx_callback(descr);
+}
+
+/**
+ * \brief Process reception error
+ *
+ * \param[in] device The pointer to device structure
+ * \param[in] errors The receive error flags
+ */
+static void usart_rx_error(struct _usart_async_device *device, uint8_t errors)
+{
+	struct usart_async_descriptor *descr = CONTAINER_OF(device, struct usart_async_descriptor, device);
+
+	if (errors & USART_ASYNC_RX_ERROR_OVERFLOW) {
+		descr->rx_hw_overflows++;
+	}
+	if (errors & (USART_ASYNC_RX_ERROR_FRAME | USART_ASYNC_RX_ERROR_PARITY)) {
+		descr->rx_errors++;
+	}
+}
+
+/**
+ * \brief Re-enable reception held back by RINGBUFFER_BLOCK strategy
+ *
+ * \param[in] descr The pointer to USART descriptor
+ */
+static void usart_resume_rx(struct usart_async_descriptor *const descr)
+{
+	bool resume = false;
+
+	CRITICAL_SECTION_ENTER()
+	if ((descr->stat & USART_ASYNC_STATUS_RX_BLOCKED) && ringbuffer_space(&descr->rx)) {
+		descr->stat &= ~USART_ASYNC_STATUS_RX_BLOCKED;
+		resume = true;
+	}
+	CRITICAL_SECTION_LEAVE()
+
+	if (resume && descr->usart_cb.rx_done) {
+		_usart_async_set_irq_state(&descr->device, USART_ASYNC_RX_DONE, true);
+	}
+}
 
+/**
+ * \brief Move the bytes stored by the DMAC into the RX ring buffer
+ *
+ * The DMAC writes straight into the ring buffer storage, only the write index
+ * has to follow it. Unread data is overwritten once the DMAC laps the reader.
+ *
+ * \param[in] descr The pointer to USART descriptor
+ *
+ * \return The number of bytes received since the previous call
+ */
+static uint32_t usart_dma_rx_sync(struct usart_async_descriptor *const descr)
+{
+	uint16_t half = (descr->rx.size + 1) >> 1;
+	uint16_t pos;
+	uint32_t received;
+
+	if (!descr->rx_dma) {
+		return 0;
+	}
+
+	CRITICAL_SECTION_ENTER()
+	pos      = _usart_async_dma_rx_get_position(&descr->device, descr->rx.size + 1);
+	received = (uint16_t)(pos - descr->rx_dma_pos) & descr->rx.size;
+	if (received) {
+		descr->rx_dma_crossed += (descr->rx_dma_pos % half + received) / half;
+		descr->rx_dma_pos = pos;
+		ringbuffer_commit_overwrite(&descr->rx, received);
+		usart_rx_timestamp(descr);
+	}
+	CRITICAL_SECTION_LEAVE()
+
+	return received;
+}
+
+/**
+ * \brief Hand the frames completed in the RX buffer to the framer callback
+ *
+ * \param[in] descr The pointer to USART descriptor
+ */
+static void usart_run_framer(struct usart_async_descriptor *const descr)
+{
+	if (descr->framer && framer_process(descr->framer)) {
+		descr->rx_frame_open = false;
+	}
+}
+
+/**
+ * \brief Time stamp received data
+ *
+ * \param[in] descr The pointer to USART descriptor
+ */
+static void usart_rx_timestamp(struct usart_async_descriptor *const descr)
+{
+	uint32_t now;
+
+	if (!descr->rx_timestamp) {
+		return;
+	}
+	now = descr->rx_timestamp();
+
+	if (!descr->rx_frame_open) {
+		descr->rx_frame.start = now;
+		descr->rx_frame_open  = true;
+	}
+	descr->rx_frame.end = now;
+}
+
+/**
+ * \brief Call the RX callback
+ *
+ * Without a framer, every RX callback ends the time stamped frame.
+ *
+ * \param[in] descr The pointer to USART descriptor
+ */
+static void usart_rx_callback(struct usart_async_descriptor *const descr)
+{
 	if (descr->usart_cb.rx_done) {
 		descr->usart_cb.rx_done(descr);
 	}
+	if (!descr->framer) {
+		descr->rx_frame_open = false;
+	}
+}
+
+/**
+ * \brief Process DMA reception of a half of the RX buffer
+ *
+ * Every block interrupt follows at least one block boundary. When the DMA
+ * position has crossed none since the previous interrupt, this one was held
+ * off while the DMAC went a whole lap round the RX buffer, which the position
+ * alone cannot tell from no data at all; the lap is committed as lost data.
+ *
+ * \param[in] device The pointer to device structure
+ */
+static void usart_dma_rx_block_done(struct _usart_async_device *device)
+{
+	struct usart_async_descriptor *descr = CONTAINER_OF(device, struct usart_async_descriptor, device);
+
+	CRITICAL_SECTION_ENTER()
+	usart_dma_rx_sync(descr);
+	/* A boundary crossed ahead may belong to an interrupt still pending */
+	if (descr->rx_dma_crossed) {
+		descr->rx_dma_ahead = descr->rx_dma_crossed > 1;
+	} else if (descr->rx_dma_ahead) {
+		descr->rx_dma_ahead = false;
+	} else {
+		/* The position wrapped onto itself, the buffer was overwritten unseen */
+		ringbuffer_commit_overwrite(&descr->rx, descr->rx.size + 1);
+		usart_rx_timestamp(descr);
+	}
+	descr->rx_dma_crossed = 0;
+	CRITICAL_SECTION_LEAVE()
+
+	usart_run_framer(descr);
+	descr->rx_idle_pending = false;
+
+	usart_rx_callback(descr);
+}
+
+/**
+ * \brief Process receive start interrupt
+ *
+ * \param[in] device The pointer to device structure
+ */
+static void usart_rx_start(struct _usart_async_device *device)
+{
+	struct usart_async_descriptor *descr = CONTAINER_OF(device, struct usart_async_descriptor, device);
+
+	/* The DMAC moves the character only once it is complete, stamp it now */
+	usart_rx_timestamp(descr);
+	if (descr->usart_cb.rx_start) {
+		descr->usart_cb.rx_start(descr);
+	}
 }
 
 /**
@@ -411,7 +944,9 @@ static void usart_error(struct _usart_async_device *device)
 {
 	struct usart_async_descriptor *descr = CONTAINER_OF(device, struct usart_async_descriptor, device);
 
-	descr->stat = 0;
+	if (!descr->tx_count) {
+		descr->stat &= ~USART_ASYNC_STATUS_BUSY;
+	}
 	if (descr->usart_cb.error) {
 		descr->usart_cb.error(descr);
 	}
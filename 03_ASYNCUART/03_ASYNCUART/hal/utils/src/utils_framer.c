@@ -0,0 +1,252 @@
+/**
+ * \file
+ *
+ * \brief Framed message receiver implementation.
+ *
+ * Copyright (c) 2014-2018 Microchip Technology Inc. and its subsidiaries.
+ *
+ * \asf_license_start
+ *
+ * \page License
+ *
+ * Subject to your compliance with these terms, you may use Microchip
+ * software and any derivatives exclusively with Microchip products.
+ * It is your responsibility to comply with third party license terms applicable
+ * to your use of third party software (including open source software) that
+ * may accompany Microchip software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES,
+ * WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE,
+ * INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY,
+ * AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL MICROCHIP BE
+ * LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR CONSEQUENTIAL
+ * LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO THE
+ * SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE
+ * POSSIBILITY OR THE DAMAGES ARE FORESEEABLE.  TO THE FULLEST EXTENT
+ * ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN ANY WAY
+ * RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+ * THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+ *
+ * \asf_license_stop
+ *
+ */
+#include "utils_framer.h"
+#include <string.h>
+
+/** Size of the length field in FRAMER_LENGTH_PREFIX mode */
+#define FRAMER_LENGTH_SIZE 2
+
+/**
+ * \brief Release the parsed bytes and start a new frame
+ */
+static void framer_restart(struct framer *const fr)
+{
+	ringbuffer_commit_read(fr->rb, fr->scan - fr->rb->read_index);
+
+	fr->start     = fr->scan;
+	fr->out       = fr->scan;
+	fr->expected  = 0;
+	fr->cobs_run  = 0;
+	fr->cobs_zero = false;
+}
+
+/**
+ * \brief Hand a frame located in the ring buffer to the callback
+ */
+static void framer_deliver(struct framer *const fr, const uint32_t from, const uint16_t size)
+{
+	struct framer_frame frame;
+	uint32_t            offset = from & fr->rb->size;
+	uint32_t            chunk  = fr->rb->size + 1 - offset;
+
+	frame.data[0]   = &fr->rb->buf[offset];
+	frame.length[0] = (size < chunk) ? size : chunk;
+	frame.data[1]   = fr->rb->buf;
+	frame.length[1] = size - frame.length[0];
+	frame.size      = size;
+
+	fr->frames++;
+	if (fr->cb) {
+		fr->cb(fr, &frame);
+	}
+}
+
+/**
+ * \brief Parse one byte of a delimited frame
+ */
+static void framer_parse_delimited(struct framer *const fr, const uint8_t data)
+{
+	if (data == fr->delimiter) {
+		if (!fr->discard && fr->scan - 1 != fr->start) {
+			framer_deliver(fr, fr->start, fr->scan - 1 - fr->start);
+		}
+		fr->discard = false;
+		framer_restart(fr);
+	} else if (fr->discard) {
+		framer_restart(fr);
+	} else if (fr->scan - fr->start > fr->max_frame) {
+		fr->dropped++;
+		fr->discard = true;
+		framer_restart(fr);
+	}
+}
+
+/**
+ * \brief Parse one byte of a length-prefixed frame
+ */
+static void framer_parse_length_prefixed(struct framer *const fr, const uint8_t data)
+{
+	uint32_t num = fr->scan - fr->start;
+
+	if (fr->skip) {
+		fr->skip--;
+		framer_restart(fr);
+		return;
+	}
+	if (num < FRAMER_LENGTH_SIZE) {
+		fr->expected = (fr->expected << 8) | data;
+		return;
+	}
+	if (num == FRAMER_LENGTH_SIZE) {
+		fr->expected = (fr->expected << 8) | data;
+		if (fr->expected > fr->max_frame) {
+			fr->dropped++;
+			fr->skip = fr->expected;
+			framer_restart(fr);
+		} else if (!fr->expected) {
+			framer_restart(fr);
+		}
+		return;
+	}
+	if (num == FRAMER_LENGTH_SIZE + fr->expected) {
+		framer_deliver(fr, fr->start + FRAMER_LENGTH_SIZE, fr->expected);
+		framer_restart(fr);
+	}
+}
+
+/**
+ * \brief Parse one byte of a COBS encoded frame
+ *
+ * Decoded data never gets ahead of the encoded data, so frames are decoded
+ * in place.
+ */
+static void framer_parse_cobs(struct framer *const fr, const uint8_t data)
+{
+	if (!data) {
+		if (!fr->discard && fr->out != fr->start) {
+			if (fr->cobs_run) {
+				fr->dropped++;
+			} else {
+				framer_deliver(fr, fr->start, fr->out - fr->start);
+			}
+		}
+		fr->discard = false;
+		framer_restart(fr);
+		return;
+	}
+	if (fr->discard) {
+		framer_restart(fr);
+		return;
+	}
+
+	if (fr->cobs_run) {
+		fr->rb->buf[fr->out++ & fr->rb->size] = data;
+		fr->cobs_run--;
+	} else {
+		if (fr->cobs_zero) {
+			fr->rb->buf[fr->out++ & fr->rb->size] = 0;
+		}
+		fr->cobs_run  = data - 1;
+		fr->cobs_zero = (data != 0xFF);
+	}
+
+	if (fr->out - fr->start > fr->max_frame) {
+		fr->dropped++;
+		fr->discard = true;
+		framer_restart(fr);
+	}
+}
+
+/**
+ * \brief Framer initialization
+ */
+int32_t framer_init(struct framer *const fr, struct ringbuffer *const rb, const enum framer_mode mode,
+                    const uint8_t delimiter, const uint16_t max_frame, framer_cb_t cb)
+{
+	ASSERT(fr && rb && max_frame);
+
+	if (max_frame + FRAMER_LENGTH_SIZE > rb->size + 1) {
+		return ERR_INVALID_ARG;
+	}
+
+	fr->rb        = rb;
+	fr->cb        = cb;
+	fr->mode      = mode;
+	fr->delimiter = delimiter;
+	fr->max_frame = max_frame;
+	fr->scan      = rb->read_index;
+	fr->skip      = 0;
+	fr->discard   = false;
+	fr->frames    = 0;
+	fr->dropped   = 0;
+	framer_restart(fr);
+
+	return ERR_NONE;
+}
+
+/**
+ * \brief Parse the data added to the ring buffer since the previous call
+ */
+uint32_t framer_process(struct framer *const fr)
+{
+	uint32_t frames;
+	uint8_t  data;
+
+	ASSERT(fr);
+
+	frames = fr->frames;
+
+	/* The frame in progress has been overwritten or flushed */
+	if (fr->start != fr->rb->read_index) {
+		fr->scan    = fr->rb->read_index;
+		fr->skip    = 0;
+		fr->discard = (fr->mode != FRAMER_LENGTH_PREFIX);
+		framer_restart(fr);
+	}
+
+	while (fr->scan != fr->rb->write_index) {
+		data = fr->rb->buf[fr->scan++ & fr->rb->size];
+
+		switch (fr->mode) {
+		case FRAMER_DELIMITER:
+			framer_parse_delimited(fr, data);
+			break;
+		case FRAMER_LENGTH_PREFIX:
+			framer_parse_length_prefixed(fr, data);
+			break;
+		case FRAMER_COBS:
+			framer_parse_cobs(fr, data);
+			break;
+		}
+	}
+
+	return fr->frames - frames;
+}
+
+/**
+ * \brief Copy a received frame into a linear buffer
+ */
+uint16_t framer_frame_copy(const struct framer_frame *const frame, uint8_t *const buf, const uint16_t length)
+{
+	uint16_t first, second;
+
+	ASSERT(frame && buf);
+
+	first  = (frame->length[0] < length) ? frame->length[0] : length;
+	second = (frame->length[1] < length - first) ? frame->length[1] : length - first;
+
+	memcpy(buf, frame->data[0], first);
+	memcpy(buf + first, frame->data[1], second);
+
+	return first + second;
+}
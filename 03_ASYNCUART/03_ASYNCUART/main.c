@@ -1,76 +1,240 @@
 #include <atmel_start.h>
+#include <peripheral_clk_config.h>
+#include <string.h>
 
-// Serial Receiving & Complete Flags
-volatile uint8_t serial_receiving = 0;
+// Message Complete & Replying Flags
 volatile uint8_t serial_complete = 0;
+volatile uint8_t serial_replying = 0;
 
-// Bytes Received Counters
-volatile uint8_t serial_received_bytes_counter = 0;
+// Bytes in the Received Message
 volatile uint8_t total_bytes = 0;
 
 // Size of Receive Buffer
 #define SERIAL_BUFFER_SIZE	200
 
-// Receive and Transmit Buffers
-volatile uint8_t rx_buffer[SERIAL_BUFFER_SIZE] = { 0x00 };
-volatile uint8_t tx_buffer[SERIAL_BUFFER_SIZE + 14] = "Your message: ";
+// Receive Buffer
+uint8_t rx_buffer[SERIAL_BUFFER_SIZE] = { 0x00 };
+
+// Reply Header and Trailer
+static const uint8_t reply_header[] = "Your message: ";
+static const uint8_t reply_trailer[] = "\r\n";
+
+// Line Framer
+static struct framer serial_framer;
+
+// Baud Rate Change Command, Followed by the New Baud Rate
+static const uint8_t baud_command[] = "BAUD ";
+
+// Baud Rate Setting to Switch to Once the Reply has Been Sent
+static struct usart_baud_setting baud_setting;
+volatile uint8_t baud_pending = 0;
+
+// Latency Statistics Command
+static const uint8_t latency_command[] = "LATENCY";
+
+// Command Reply Text, Long Enough for the Latency Reply with Four 10 Digit Numbers
+static uint8_t text_reply[96];
 
 /**
- * Virtual COM Port Receive Callback Function
+ * Parse a baud rate change command.
  *
+ * @param const uint8_t *line		Received line
+ * @param uint8_t length			Number of characters in the line
+ * @param uint32_t *baud			Requested baud rate
+ *
+ * @return bool						True when the line is a baud rate command
  */
-static void serial_rx_cb(const struct usart_async_descriptor *const io_descr)
+static bool parse_baud_command(const uint8_t *line, uint8_t length, uint32_t *baud)
 {
-	// Counters
-	uint8_t ch, count;
-	
-	// Read a Character
-	count = io_read(&SERIAL.io, &ch, 1);
+	// Check the Command
+	uint8_t prefix = sizeof(baud_command) - 1;
+	if (length <= prefix || memcmp(line, baud_command, prefix) != 0)
+	{
+		return false;
+	}
 	
-	// Check if we're receiving
-	if (serial_receiving == 0)
+	// Read the Decimal Baud Rate
+	*baud = 0;
+	for (uint8_t i = prefix; i < length; i++)
 	{
-		// Check for New Line or Carriage Return
-		if (ch != '\r' && ch != '\n')
+		if (line[i] < '0' || line[i] > '9' || *baud > 100000000)
 		{
-			// Set Receiving Flag
-			serial_receiving = 1;
-			
-			// Reset Byte Counter
-			serial_received_bytes_counter = 0;
-			
-			// Start Filling the Buffer
-			rx_buffer[serial_received_bytes_counter] = ch;
-			
-			// Increment the Byte Counter
-			serial_received_bytes_counter += count;
+			return false;
 		}
+		*baud = (*baud * 10) + (line[i] - '0');
 	}
-	else
+	
+	return true;
+}
+
+/**
+ * Append an unsigned decimal number to a reply, clipped to the buffer.
+ *
+ * @param uint8_t *buf				Reply buffer
+ * @param uint8_t size				Size of the reply buffer
+ * @param uint8_t pos				Position to write the number to
+ * @param uint32_t value			Number to write
+ *
+ * @return uint8_t					Position after the number
+ */
+static uint8_t append_unsigned(uint8_t *buf, uint8_t size, uint8_t pos, uint32_t value)
+{
+	// Digits in Reverse Order
+	uint8_t digits[10];
+	uint8_t count = 0;
+	
+	// Split into Digits
+	do
 	{
-		// Continue Filling Buffer
-		rx_buffer[serial_received_bytes_counter] = ch;
-		
-		// Increment the Byte Counter
-		serial_received_bytes_counter += count;
-		
-		// Check for New Line or Carriage Return
-		if (ch == '\r' || ch == '\n')
-		{
-			// Set the Completion Flag
-			serial_complete = 1;
-			
-			// Total Bytes
-			total_bytes = serial_received_bytes_counter - 2;
-		}
-		
-		// Check for Buffer Overflow
-		if (serial_received_bytes_counter >= SERIAL_BUFFER_SIZE)
-		{
-			// Reset Buffer Counter
-			serial_received_bytes_counter = 0;
-		}
+		digits[count++] = '0' + (value % 10);
+		value /= 10;
+	} while (value > 0);
+	
+	// Write them Most Significant First
+	while (count > 0 && pos < size)
+	{
+		buf[pos++] = digits[--count];
+	}
+	
+	return pos;
+}
+
+/**
+ * Append a signed decimal number to a reply, clipped to the buffer.
+ *
+ * @param uint8_t *buf				Reply buffer
+ * @param uint8_t size				Size of the reply buffer
+ * @param uint8_t pos				Position to write the number to
+ * @param int32_t value				Number to write
+ *
+ * @return uint8_t					Position after the number
+ */
+static uint8_t append_number(uint8_t *buf, uint8_t size, uint8_t pos, int32_t value)
+{
+	// Write the Sign
+	if (value < 0 && pos < size)
+	{
+		buf[pos++] = '-';
+	}
+	
+	return append_unsigned(buf, size, pos, (value < 0) ? -(uint32_t)value : (uint32_t)value);
+}
+
+/**
+ * Append text to a reply, clipped to the buffer.
+ *
+ * @param uint8_t *buf				Reply buffer
+ * @param uint8_t size				Size of the reply buffer
+ * @param uint8_t pos				Position to write the text to
+ * @param const char *text			Text to write
+ *
+ * @return uint8_t					Position after the text
+ */
+static uint8_t append_text(uint8_t *buf, uint8_t size, uint8_t pos, const char *text)
+{
+	while (*text != '\0' && pos < size)
+	{
+		buf[pos++] = *text++;
 	}
+	
+	return pos;
+}
+
+/**
+ * Time Stamp Source for Received Lines, in Timer Clock Cycles (Microseconds)
+ *
+ */
+static uint32_t serial_timestamp(void)
+{
+	uint32_t cycles;
+	timer_get_timestamp(&TIMER, &cycles);
+	return cycles;
+}
+
+/**
+ * Virtual COM Port Line Received Callback Function
+ *
+ */
+static void serial_frame_cb(const struct framer *const fr, const struct framer_frame *const frame)
+{
+	// Measure the Time since the Line was Received
+	struct usart_async_rx_timestamp stamp;
+	usart_async_get_rx_timestamp(&SERIAL, &stamp);
+	
+	// Drop the Line if the Previous One is Still Being Answered
+	if (serial_complete == 1)
+	{
+		return;
+	}
+	
+	// Copy the Line out of the Receive Ring
+	total_bytes = framer_frame_copy(frame, rx_buffer, SERIAL_BUFFER_SIZE);
+	
+	// Strip a Carriage Return
+	if (total_bytes > 0 && rx_buffer[total_bytes - 1] == '\r')
+	{
+		total_bytes--;
+	}
+	
+	// Ignore Empty Lines
+	if (total_bytes > 0)
+	{
+		// Set the Completion Flag
+		serial_complete = 1;
+	}
+}
+
+/**
+ * Virtual COM Port Reply Sent Callback Function
+ *
+ */
+static void serial_reply_cb(const struct usart_async_descriptor *const descr, const uint8_t *const buf)
+{
+	// Receive Buffer can be Reused
+	serial_replying = 0;
+	serial_complete = 0;
+}
+
+// Receive Idle Check Timer Task, Queued Only While Received Data is Pending
+static struct timer_task serial_idle_task;
+volatile uint8_t serial_idle_armed = 0;
+
+/**
+ * Start the Receive Idle Timeout, Unless it is Running Already
+ *
+ */
+static void serial_idle_arm(void)
+{
+	if (!serial_idle_armed)
+	{
+		serial_idle_armed = 1;
+		timer_add_task(&TIMER, &serial_idle_task);
+	}
+}
+
+/**
+ * Receive Idle Check Timer Task
+ *
+ */
+static void serial_idle_task_cb(const struct timer_task *const timer_task)
+{
+	serial_idle_armed = 0;
+	
+	// Pass Received Bytes to the Framer, Check Again Until the Line Goes Idle
+	if (usart_async_check_rx_idle(&SERIAL) == ERR_NOT_READY)
+	{
+		serial_idle_arm();
+	}
+}
+
+/**
+ * Virtual COM Port Receive Start Callback Function
+ *
+ */
+static void serial_rx_start_cb(const struct usart_async_descriptor *const descr)
+{
+	// A Character is Arriving, Start the Idle Timeout
+	serial_idle_arm();
 }
 
 /**
@@ -89,31 +253,93 @@ int main(void)
 	
 	// Initialise ASYNC Driver
 	usart_async_register_callback(&SERIAL, USART_ASYNC_TXC_CB, serial_tx_cb);
-	usart_async_register_callback(&SERIAL, USART_ASYNC_RXC_CB, serial_rx_cb);
+	
+	// Split Received Data into Lines
+	framer_init(&serial_framer, &SERIAL.rx, FRAMER_DELIMITER, '\n', SERIAL_BUFFER_SIZE, serial_frame_cb);
+	usart_async_set_framer(&SERIAL, &serial_framer);
 	usart_async_enable(&SERIAL);
+	
+	// Time Stamp Received Lines to Measure the Receive Latency
+	usart_async_set_rx_timestamp(&SERIAL, serial_timestamp);
+	
+	// Check the Receive Line for Idle a Millisecond After Data Starts Arriving
+	serial_idle_task.interval = 1;
+	serial_idle_task.cb = serial_idle_task_cb;
+	serial_idle_task.mode = TIMER_TASK_ONE_SHOT;
+	usart_async_register_callback(&SERIAL, USART_ASYNC_RX_START_CB, serial_rx_start_cb);
+	timer_start(&TIMER);
+
+	// Reply: Header, the Received Line and a Line Break, Sent Back to Back
+	struct usart_async_tx_buffer reply[3] = {
+		{ reply_header, sizeof(reply_header) - 1, NULL },
+		{ rx_buffer, 0, serial_reply_cb },
+		{ reply_trailer, sizeof(reply_trailer) - 1, NULL },
+	};
+
+	// Reply to a Command, then the Line Break
+	struct usart_async_tx_buffer reply_text[2] = {
+		{ text_reply, 0, serial_reply_cb },
+		{ reply_trailer, sizeof(reply_trailer) - 1, NULL },
+	};
 
 	/* Replace with your application code */
 	while (1)
 	{
-		// Check if we're receiving
-		if (serial_receiving == 1)
+		// Check if a Line is Complete
+		if (serial_complete == 1 && serial_replying == 0)
 		{
-			// Check if we're complete
-			if (serial_complete == 1)
+			uint32_t baud;
+			
+			// Set Replying Flag
+			serial_replying = 1;
+			
+			// Check for a Baud Rate Change the Clock can Generate
+			if (parse_baud_command(rx_buffer, total_bytes, &baud)
+				&& usart_async_solve_baud_rate(baud, CONF_GCLK_SERCOM3_CORE_FREQUENCY, &baud_setting) == ERR_NONE)
 			{
-				// Reset Flags
-				serial_receiving = 0;
-				serial_complete = 0;
-				
-				// Copy Message to TX Buffer
-				memcpy(&tx_buffer[14], &rx_buffer[0], SERIAL_BUFFER_SIZE);
+				// Report the Baud Rate We will Actually Get
+				uint8_t pos = append_text(text_reply, sizeof(text_reply), 0, "Switching to ");
+				pos = append_unsigned(text_reply, sizeof(text_reply), pos, baud_setting.actual);
+				pos = append_text(text_reply, sizeof(text_reply), pos, " baud, error ");
+				pos = append_number(text_reply, sizeof(text_reply), pos, baud_setting.error);
+				pos = append_text(text_reply, sizeof(text_reply), pos, " ppm");
+				reply_text[0].length = pos;
 				
+				// Switch Once the Reply has Left the Line
+				baud_pending = 1;
+				usart_async_write_buffers(&SERIAL, reply_text, 2);
+			}
+			else if (total_bytes == sizeof(latency_command) - 1
+				&& memcmp(rx_buffer, latency_command, total_bytes) == 0)
+			{
+				// Report the Time from Seeing a Line to its Callback, Lines are Seen at the
+				// Idle Check, so the up to 1 ms Before it is not Included
+				struct usart_async_rx_latency latency;
+				usart_async_get_rx_latency(&SERIAL, &latency);
+				uint8_t pos = append_text(text_reply, sizeof(text_reply), 0, "Latency min ");
+				pos = append_unsigned(text_reply, sizeof(text_reply), pos, latency.min);
+				pos = append_text(text_reply, sizeof(text_reply), pos, " avg ");
+				pos = append_unsigned(text_reply, sizeof(text_reply), pos, latency.avg);
+				pos = append_text(text_reply, sizeof(text_reply), pos, " max ");
+				pos = append_unsigned(text_reply, sizeof(text_reply), pos, latency.max);
+				pos = append_text(text_reply, sizeof(text_reply), pos, " us over ");
+				pos = append_unsigned(text_reply, sizeof(text_reply), pos, latency.count);
+				pos = append_text(text_reply, sizeof(text_reply), pos, " lines");
+				reply_text[0].length = pos;
+				usart_async_write_buffers(&SERIAL, reply_text, 2);
+			}
+			else
+			{
 				// Print a Message
-				io_write(&SERIAL.io, tx_buffer, total_bytes + 16);
-				
-				// Clear Memory
-				memset(&rx_buffer, 0x00, SERIAL_BUFFER_SIZE);
+				reply[1].length = total_bytes;
+				usart_async_write_buffers(&SERIAL, reply, 3);
 			}
 		}
+		
+		// Change the Baud Rate when the Transmitter is Idle
+		if (baud_pending == 1 && usart_async_set_baud_setting(&SERIAL, &baud_setting) == ERR_NONE)
+		{
+			baud_pending = 0;
+		}
 	}
 }
@@ -180,6 +180,43 @@
 
 // </e>
 
+// <e> DMA transmit
+// <i> Transmit buffers through a DMAC channel instead of the data register empty interrupt
+// <id> usart_dma_tx_enable
+#ifndef CONF_SERCOM_3_USART_DMA_TX_ENABLE
+#define CONF_SERCOM_3_USART_DMA_TX_ENABLE 1
+#endif
+
+// <o> DMA transmit channel <0-11>
+// <i> DMAC channel configured with the SERCOM3 TX trigger
+// <id> usart_dma_tx_channel
+#ifndef CONF_SERCOM_3_USART_DMA_TX_CHANNEL
+#define CONF_SERCOM_3_USART_DMA_TX_CHANNEL 0
+#endif
+// </e>
+
+// <e> DMA receive
+// <i> Receive into the RX buffer through a DMAC channel instead of the receive complete interrupt
+// <id> usart_dma_rx_enable
+#ifndef CONF_SERCOM_3_USART_DMA_RX_ENABLE
+#define CONF_SERCOM_3_USART_DMA_RX_ENABLE 1
+#endif
+
+// <o> DMA receive channel <0-11>
+// <i> DMAC channel configured with the SERCOM3 RX trigger
+// <id> usart_dma_rx_channel
+#ifndef CONF_SERCOM_3_USART_DMA_RX_CHANNEL
+#define CONF_SERCOM_3_USART_DMA_RX_CHANNEL 1
+#endif
+
+// <o> DMA receive linked descriptor <0-11>
+// <i> DMAC channel whose descriptor holds the second half of the RX buffer, the channel itself must be left unused
+// <id> usart_dma_rx_link_channel
+#ifndef CONF_SERCOM_3_USART_DMA_RX_LINK_CHANNEL
+#define CONF_SERCOM_3_USART_DMA_RX_LINK_CHANNEL 2
+#endif
+// </e>
+
 #ifndef CONF_SERCOM_3_USART_CMODE
 #define CONF_SERCOM_3_USART_CMODE 0
 #endif
@@ -292,6 +329,24 @@
 
 // </h>
 
+// <h> DMA Configuration
+
+// <o> DMA receive channel <0-11>
+// <i> DMAC channel configured with the SERCOM5 RX trigger, its transfer complete interrupt ends a spi_m_dma transfer
+// <id> spi_master_dma_rx_channel
+#ifndef CONF_SERCOM_5_SPI_M_DMA_RX_CHANNEL
+#define CONF_SERCOM_5_SPI_M_DMA_RX_CHANNEL 3
+#endif
+
+// <o> DMA transmit channel <0-11>
+// <i> DMAC channel configured with the SERCOM5 TX trigger, a higher number than the receive channel lets RX win arbitration
+// <id> spi_master_dma_tx_channel
+#ifndef CONF_SERCOM_5_SPI_M_DMA_TX_CHANNEL
+#define CONF_SERCOM_5_SPI_M_DMA_TX_CHANNEL 4
+#endif
+
+// </h>
+
 // <e> Advanced Configuration
 // <id> spi_master_advanced
 #ifndef CONF_SERCOM_5_SPI_ADVANCED
@@ -0,0 +1,38 @@
+#ifndef CRC_H_
+#define CRC_H_
+
+// Include STD C Libraries
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Use the DMAC CRC unit, the table driven software path covers host builds
+// and calls made while the unit is taken
+#ifndef CRC_USE_DMAC
+#if defined(__arm__)
+#define CRC_USE_DMAC				1
+#else
+#define CRC_USE_DMAC				0
+#endif
+#endif
+
+// Initial Values of a new Checksum
+#define CRC16_INIT					0xFFFF		// CRC-16/CCITT-FALSE
+#define CRC32_INIT					0x00000000	// CRC-32 (IEEE 802.3), as zlib crc32()
+
+// Polynomials of the CRC Unit
+typedef enum
+{
+	CRC_16_CCITT = 0,				// x^16 + x^12 + x^5 + 1, not reflected
+	CRC_32							// IEEE 802.3, reflected and complemented
+} crcType_t;
+
+// Checksums of Data in RAM (pass the previous result to continue)
+extern uint16_t CRC_crc16(uint16_t crc, const void *data, size_t length);
+extern uint32_t CRC_crc32(uint32_t crc, const void *data, size_t length);
+
+// Checksum of the Data moved by a DMA Channel
+extern bool CRC_channelBegin(uint8_t channel, crcType_t type, uint32_t crc);
+extern uint32_t CRC_channelEnd(void);
+
+#endif
@@ -14,13 +14,15 @@
 #include <hpl_pm_base.h>
 
 /*! The buffer size for USART */
-#define DEBUGOUT_BUFFER_SIZE 16
+#define DEBUGOUT_BUFFER_SIZE 256
+
+struct timer_descriptor TIMER;
 
 struct usart_async_descriptor DEBUGOUT;
 
 static uint8_t DEBUGOUT_buffer[DEBUGOUT_BUFFER_SIZE];
 
-struct spi_m_async_descriptor SERIALFLASH;
+struct spi_m_dma_descriptor SERIALFLASH;
 
 /**
  * \brief USART Clock initialization function
@@ -109,10 +111,23 @@ void SERIALFLASH_CLOCK_init(void)
 void SERIALFLASH_init(void)
 {
 	SERIALFLASH_CLOCK_init();
-	spi_m_async_init(&SERIALFLASH, SERCOM5);
+	spi_m_dma_init(&SERIALFLASH, SERCOM5);
 	SERIALFLASH_PORT_init();
 }
 
+/**
+ * \brief Timer initialization function
+ *
+ * Enables Timer peripheral, clocks and initializes Timer driver
+ */
+static void TIMER_init(void)
+{
+	_pm_enable_bus_clock(PM_BUS_APBC, TC3);
+	_gclk_enable_channel(TC3_GCLK_ID, CONF_GCLK_TC3_SRC);
+
+	timer_init(&TIMER, TC3, _tc_get_timer());
+}
+
 void system_init(void)
 {
 	init_mcu();
@@ -148,4 +163,6 @@ void system_init(void)
 	DEBUGOUT_init();
 
 	SERIALFLASH_init();
+
+	TIMER_init();
 }
@@ -21,13 +21,18 @@ extern "C" {
 #include <hal_io.h>
 #include <hal_sleep.h>
 
+#include <hal_timer.h>
+#include <hpl_tc_base.h>
+
 #include <hal_usart_async.h>
 
-#include <hal_spi_m_async.h>
+#include <hal_spi_m_dma.h>
+
+extern struct timer_descriptor TIMER;
 
 extern struct usart_async_descriptor DEBUGOUT;
 
-extern struct spi_m_async_descriptor SERIALFLASH;
+extern struct spi_m_dma_descriptor SERIALFLASH;
 
 void DEBUGOUT_PORT_init(void);
 void DEBUGOUT_CLOCK_init(void);
@@ -1,13 +1,41 @@
 // Include EXT Flash Header File
 #include "ext_flash.h"
 
-// Supported Flash Devices
+// IO Descriptor for EXTFLASH SPI Comms
+struct io_descriptor *extflash_io;
+
+// SPI Bus on the EXTFLASH SERCOM, other devices wired to it register here
+spiBus_t extflash_bus;
+
+// Bus Settings of the EXTFLASH (AT25 parts run SPI modes 0 and 3)
+static spiBusDevice_t extflashDevice =
+{
+	.csPin = SERIALFLASH_CS,
+	.mode = SPI_MODE_0,
+	.baud = FLASH_SPI_FREQUENCY,
+	.charSize = SPI_CHAR_SIZE_8
+};
+
+// Supported Flash Devices, for parts without SFDP tables
 static const extFlashInfo_t flashInfo[] =
 {
 	{
 		.manuID = MF_ADESTO,		// Adesto
 		.devID = 0x01,				// Device ID
-		.deviceSize = 0x100000		// 1Mbyte (8Mbit)
+		.deviceSize = 0x100000,		// 1Mbyte (8Mbit)
+		.pageSize = FLASH_PROGRAM_PAGE_SIZE,
+		.programTimeout = FLASH_TIMEOUT_PROGRAM_MS,
+		.chipEraseTimeout = FLASH_TIMEOUT_CHIP_ERASE_MS,
+		.eraseTypes =
+		{
+			{ FLASH_ERASE_SECTOR_SIZE, FLASH_TIMEOUT_ERASE_MS, FLASH_CMD_SECTOR_ERASE },
+			{ FLASH_ERASE_BLOCK_32K_SIZE, FLASH_TIMEOUT_ERASE_32K_MS, FLASH_CMD_BLOCK_ERASE_32K },
+			{ FLASH_ERASE_BLOCK_64K_SIZE, FLASH_TIMEOUT_ERASE_64K_MS, FLASH_CMD_BLOCK_ERASE_64K }
+		},
+		.suspendCommand = FLASH_CMD_SUSPEND,
+		.resumeCommand = FLASH_CMD_SUSPEND_RESUME,
+		.suspendLatency = FLASH_SUSPEND_LATENCY_US,
+		.suspendInterval = FLASH_SUSPEND_INTERVAL_US
 	},
 	{
 		.manuID = 0x0,
@@ -16,21 +44,151 @@ static const extFlashInfo_t flashInfo[] =
 	}
 };
 
-// Flash Information
-static const extFlashInfo_t *pFlashInfo = NULL;
+// Geometry assumed until a device has been identified (size unknown)
+static const extFlashInfo_t genericFlashInfo =
+{
+	.pageSize = FLASH_PROGRAM_PAGE_SIZE,
+	.programTimeout = FLASH_TIMEOUT_PROGRAM_MS,
+	.chipEraseTimeout = FLASH_TIMEOUT_CHIP_ERASE_MS,
+	.eraseTypes =
+	{
+		{ FLASH_ERASE_SECTOR_SIZE, FLASH_TIMEOUT_ERASE_MS, FLASH_CMD_SECTOR_ERASE },
+		{ FLASH_ERASE_BLOCK_32K_SIZE, FLASH_TIMEOUT_ERASE_32K_MS, FLASH_CMD_BLOCK_ERASE_32K },
+		{ FLASH_ERASE_BLOCK_64K_SIZE, FLASH_TIMEOUT_ERASE_64K_MS, FLASH_CMD_BLOCK_ERASE_64K }
+	}
+};
+
+// Flash Information (the SFDP tables of the device if it has them)
+static const extFlashInfo_t *pFlashInfo = &genericFlashInfo;
+static extFlashInfo_t sfdpFlashInfo;
 static uint8_t infoBuf[2];
 static uint8_t rxBuff[FLASH_PROGRAM_PAGE_SIZE + FLASH_MAX_COMMAND_SIZE];
 
+// States of the Asynchronous Erase / Program Sequence
+typedef enum
+{
+	EXTFLASH_ASYNC_IDLE = 0,
+	EXTFLASH_ASYNC_POLL,			// Waiting for the next status poll
+	EXTFLASH_ASYNC_STATUS,			// Status register read in flight
+	EXTFLASH_ASYNC_WRITE_ENABLE,	// Write enable in flight
+	EXTFLASH_ASYNC_COMMAND			// Instruction, address (and page data) in flight
+} extFlashAsyncState_t;
+
+// Asynchronous Erase / Program Operation
+static struct
+{
+	volatile extFlashAsyncState_t state;
+	uint8_t command;					// Erase or program instruction
+	size_t offset;						// Address of the next instruction
+	size_t length;						// Bytes left to erase / program
+	const uint8_t *buf;					// Data left to program
+	size_t ilen;						// Bytes covered by the current instruction
+	uint32_t timeout;					// Status polls allowed for the current instruction
+	uint32_t polls;						// Status polls spent on the current instruction
+	extFlashCallback_t cb;				// Completion callback
+	volatile bool paused;				// A read holds off the next instruction
+	uint8_t wbuf[FLASH_MAX_COMMAND_SIZE];
+	uint8_t rbuf[2];
+	spiBusSegment_t segments[2];		// Instruction, then page data
+	spiBusTransaction_t transaction;
+} asyncOp;
+
+// Timer Task for the Status Polls
+static struct timer_task asyncPollTask;
+
+// TIMER time of the last Program / Erase Resume
+static uint32_t resumedAt;
+
+// Advance or End the Asynchronous Operation
+static void EXTFLASH_asyncStep(void);
+static void EXTFLASH_asyncFinish(extFlashResult_t result);
+
+#if FLASH_POWER_DOWN_MS > 0
+// Deep Power-Down, entered from TIMER once the device has been idle for FLASH_POWER_DOWN_MS
+static struct
+{
+	volatile bool down;					// Device in deep power-down
+	volatile bool armed;				// Idle task queued
+	uint32_t idleSince;					// TIMER time of the last access
+	uint32_t downSince;					// TIMER time the device was powered down
+	uint8_t wbuf[2];
+	uint8_t rbuf[2];
+	spiBusSegment_t segment;
+	spiBusTransaction_t transaction;
+} powerOp;
+
+// Timer Task for the Idle Period
+static struct timer_task powerTask;
+
+// Resume the Device, start and check the Idle Period
+static void EXTFLASH_wake(void);
+static void EXTFLASH_idleStart(void);
+static void EXTFLASH_idle_cb(const struct timer_task *const timer_task);
+#endif
+
+// Deep Power-Down Counters
+static extFlashPowerStats_t powerStats;
+
+#if FLASH_CACHE_PAGES > 0
+// Page held in the Read Cache
+typedef struct
+{
+	size_t page;						// Page number (offset / FLASH_PROGRAM_PAGE_SIZE)
+	bool valid;
+	bool referenced;					// Read since the clock hand last passed
+	uint8_t data[FLASH_PROGRAM_PAGE_SIZE];
+} extFlashCacheLine_t;
+
+// Read Cache and the Clock Hand for Replacement
+static extFlashCacheLine_t cache[FLASH_CACHE_PAGES];
+static uint16_t cacheHand;
+#endif
+
+// Read Cache Counters
+static extFlashCacheStats_t cacheStats;
+
+#if FLASH_WRITE_COMBINE
+// Write Combining Stage, one page of sequential writes not yet programmed
+static struct
+{
+	size_t page;						// Page number (offset / FLASH_PROGRAM_PAGE_SIZE)
+	uint16_t start;						// First staged byte in the page
+	uint16_t end;						// One past the last staged byte, equal to start when empty
+	uint8_t data[FLASH_PROGRAM_PAGE_SIZE];
+} stage;
+
+#if FLASH_WRITE_FLUSH_MS > 0
+// Timer Task for the Auto Flush
+static struct timer_task flushTask;
+static volatile bool flushArmed = false;
+
+// Flush the Stage from TIMER
+static void EXTFLASH_autoFlush_cb(const struct timer_task *const timer_task);
+static void EXTFLASH_autoFlushDone(extFlashResult_t result);
+#endif
+#endif
+
+// Set while a blocking call owns the SPI bus, so the auto flush keeps off it
+static volatile bool locked = false;
+
 /**
- * Callback fucntion for SPI transfer completed on EXTFLASH SPI.
+ * Completion of a bus transaction of the asynchronous operation.
  *
- * @param spi_m_async_descriptor		IO descriptor for SPI object.
+ * @param spiBusTransaction_t *transaction	The transaction.
  *
  * @return void
  */
-static void SPI_EXTFLASH_complete_cb(const struct spi_m_async_descriptor *const io_descr)
+static void EXTFLASH_async_cb(spiBusTransaction_t *transaction)
 {
-	/* Transfer Completed */
+	// Move the Operation on to its next Step
+	if (transaction->status != ERR_NONE)
+	{
+		EXTFLASH_asyncFinish(EXTFLASH_ERROR);
+	}
+	else
+	{
+		EXTFLASH_asyncStep();
+	}
 }
 
 /**
@@ -41,13 +199,56 @@ static void SPI_EXTFLASH_complete_cb(const struct spi_m_async_descriptor *const
 void EXTFLASH_init()
 {
 	// Get the IO Descriptor
-	spi_m_async_get_io_descriptor(&SERIALFLASH, &extflash_io);
+	spi_m_dma_get_io_descriptor(&SERIALFLASH, &extflash_io);
+	
+	// Put the SERCOM under the Bus Manager (it enables it) and join the Bus
+	SPIBUS_init(&extflash_bus, &SERIALFLASH, CONF_GCLK_SERCOM5_CORE_FREQUENCY);
+	SPIBUS_register(&extflash_bus, &extflashDevice);
+}
+
+/**
+ * Send an instruction and clock data after it as one bus transaction, so
+ * CS stays asserted from the instruction to the end of the data. Without a
+ * write buffer the dummy byte is sent, without a read buffer the received
+ * data is dropped, so the payload of a read lands straight in the caller's
+ * buffer. With {hold} the device stays selected and the next transaction
+ * carries on where this one ended.
+ *
+ * @param uint8_t *cmd					Instruction bytes, or NULL.
+ * @param uint8_t cmdLength				Number of instruction bytes.
+ * @param uint8_t *wbuf					Write buffer, or NULL.
+ * @param uint8_t *rbuf					Read buffer, or NULL.
+ * @param size_t length					Length of the data.
+ * @param bool hold						Keep CS asserted afterwards.
+ *
+ * @return bool
+ */
+static bool EXTFLASH_command(const uint8_t *cmd, uint8_t cmdLength, const uint8_t *wbuf, uint8_t *rbuf, size_t length, bool hold)
+{
+	// Instruction, then Data
+	spiBusSegment_t segments[2] =
+	{
+		{ cmd, NULL, cmdLength },
+		{ wbuf, rbuf, length }
+	};
+	spiBusTransaction_t transaction =
+	{
+		.device = &extflashDevice,
+		.segments = segments,
+		.segmentCount = 2,
+		.hold = hold
+	};
 	
-	// Register the Callback Function
-	spi_m_async_register_callback(&SERIALFLASH, SPI_M_ASYNC_CB_XFER, (FUNC_PTR)SPI_EXTFLASH_complete_cb);
+#if FLASH_POWER_DOWN_MS > 0
+	// Bring the Device out of Deep Power-Down first
+	if (powerOp.down)
+	{
+		EXTFLASH_wake();
+	}
+#endif
 	
-	// Enable Asynchronous SPI
-	spi_m_async_enable(&SERIALFLASH);
+	// Run it on the Bus and wait for it
+	return (SPIBUS_transfer(&transaction) == ERR_NONE);
 }
 
 /**
@@ -61,33 +262,7 @@ void EXTFLASH_init()
  */
 static bool EXTFLASH_transfer(const uint8_t *wbuf, uint8_t *rbuf, const uint16_t length)
 {
-	// Set the Initial Return Value
-	bool returnVal = false;
-	
-	// Struct for the SPI Status
-	struct spi_m_async_status p_stat;
-	
-	// Enable SPI
-	gpio_set_pin_level(SERIALFLASH_CS, 0);
-	
-	// Perform ASYNC Transfer (send and receive)
-	spi_m_async_transfer(&SERIALFLASH, &wbuf[0], &rbuf[0], length);
-	
-	// Wait until transfer completes...
-	while (spi_m_async_get_status(&SERIALFLASH, &p_stat) == ERR_BUSY)
-	{
-		// Delay a bit before checking again
-		delay_us(10);
-	}
-	
-	// Set the Return Value
-	returnVal = true;
-	
-	// Disable SPI
-	gpio_set_pin_level(SERIALFLASH_CS, 1);
-	
-	// Return the Function
-	return returnVal;
+	return EXTFLASH_command(NULL, 0, wbuf, rbuf, length, false);
 }
 
 /**
@@ -116,6 +291,211 @@ static bool EXTFLASH_readInfo(void)
 	return returnVal;
 }
 
+/**
+ * Read from the SFDP tables of the flash device.
+ *
+ * @param size_t offset					The byte offset in the SFDP area.
+ * @param size_t length					The number of bytes to read.
+ * @param uint8_t *buf					The buffer where data is stored.
+ *
+ * @return bool
+ */
+static bool EXTFLASH_readSfdp(size_t offset, size_t length, uint8_t *buf)
+{
+	// Instruction, 24 bit address and one dummy byte
+	const uint8_t wbuf[5] = { FLASH_CMD_READ_SFDP, (offset >> 16) & 0xFF, (offset >> 8) & 0xFF, offset & 0xFF, 0x00 };
+	
+	// Send the Command, then Stream the Table into the Buffer
+	return EXTFLASH_command(wbuf, sizeof(wbuf), NULL, buf, length, false);
+}
+
+/**
+ * Time limit of an erase instruction when the device does not give one.
+ *
+ * @param uint32_t size					Bytes erased by the instruction.
+ *
+ * @return uint32_t						Timeout in milliseconds
+ */
+static uint32_t EXTFLASH_defaultEraseTimeout(uint32_t size)
+{
+	if (size <= FLASH_ERASE_SECTOR_SIZE)
+	{
+		return FLASH_TIMEOUT_ERASE_MS;
+	}
+	if (size <= FLASH_ERASE_BLOCK_32K_SIZE)
+	{
+		return FLASH_TIMEOUT_ERASE_32K_MS;
+	}
+	
+	// Scale the 64K Block Time for anything larger
+	return FLASH_TIMEOUT_ERASE_64K_MS * ((size + FLASH_ERASE_BLOCK_64K_SIZE - 1) / FLASH_ERASE_BLOCK_64K_SIZE);
+}
+
+/**
+ * Describe the flash device from its JEDEC Basic Flash Parameter Table
+ * (JESD216): density, erase instructions and their times, page size, program
+ * and chip erase times and Dual Output Fast Read support. Timeouts are the
+ * typical times scaled by the maximum multipliers of the table.
+ *
+ * @param extFlashInfo_t *info			Where the description is stored.
+ *
+ * @return bool							false if the device has no usable SFDP tables
+ */
+static bool EXTFLASH_readSfdpInfo(extFlashInfo_t *info)
+{
+	// SFDP Header and the first Parameter Header (always the Basic Table)
+	uint8_t header[16];
+	
+	// Basic Flash Parameter Table, little endian like the Cortex-M0+
+	uint32_t dword[FLASH_SFDP_BFPT_DWORDS];
+	uint8_t dwords;
+	uint8_t i, n;
+	
+	// Units of the Time Fields in Milliseconds
+	static const uint16_t eraseUnits[4] = { 1, 16, 128, 1000 };
+	static const uint32_t chipEraseUnits[4] = { 16, 256, 4000, 64000 };
+	
+	// Read and Check the Headers
+	if (!EXTFLASH_readSfdp(0, sizeof(header), header))
+	{
+		return false;
+	}
+	if ((header[0] | (header[1] << 8) | (header[2] << 16) | ((uint32_t)header[3] << 24)) != FLASH_SFDP_SIGNATURE || header[5] != 1 || header[8] != FLASH_SFDP_BFPT_ID)
+	{
+		return false;
+	}
+	
+	// JESD216 tables have at least 9 DWORDs, later revisions add the times
+	dwords = header[11];
+	if (dwords < 9)
+	{
+		return false;
+	}
+	if (dwords > FLASH_SFDP_BFPT_DWORDS)
+	{
+		dwords = FLASH_SFDP_BFPT_DWORDS;
+	}
+	
+	// Read the Table
+	memset(dword, 0, sizeof(dword));
+	if (!EXTFLASH_readSfdp(header[12] | (header[13] << 8) | ((size_t)header[14] << 16), dwords * 4, (uint8_t *)dword))
+	{
+		return false;
+	}
+	
+	// Density (DWORD 2) in bits, beyond 24-bit addressing only the first 16 Mbytes are used
+	memset(info, 0, sizeof(*info));
+	if (dword[1] & 0x80000000)
+	{
+		n = dword[1] & 0x7F;
+		info->deviceSize = (n >= 27) ? FLASH_MAX_ADDRESSABLE_SIZE : (1UL << n) / 8;
+	}
+	else
+	{
+		info->deviceSize = (dword[1] / 8) + 1;
+	}
+	if (info->deviceSize > FLASH_MAX_ADDRESSABLE_SIZE)
+	{
+		info->deviceSize = FLASH_MAX_ADDRESSABLE_SIZE;
+	}
+	
+	// Erase Types (DWORDs 8 and 9) with their times (DWORD 10)
+	for (i = 0, n = 0; i < FLASH_ERASE_TYPES; i++)
+	{
+		uint8_t exponent = (dword[7 + i / 2] >> ((i % 2) * 16)) & 0xFF;
+		
+		// Unused Type
+		if (exponent == 0 || exponent > 24)
+		{
+			continue;
+		}
+		
+		info->eraseTypes[n].size = 1UL << exponent;
+		info->eraseTypes[n].command = (dword[7 + i / 2] >> ((i % 2) * 16 + 8)) & 0xFF;
+		if (dwords >= 10)
+		{
+			uint32_t field = dword[9] >> (4 + 7 * i);
+			info->eraseTypes[n].timeout = ((field & 0x1F) + 1) * eraseUnits[(field >> 5) & 0x3] * 2 * ((dword[9] & 0xF) + 1);
+		}
+		else
+		{
+			info->eraseTypes[n].timeout = EXTFLASH_defaultEraseTimeout(info->eraseTypes[n].size);
+		}
+		n++;
+	}
+	
+	// Fall back on the 4K Erase of DWORD 1
+	if (n == 0 && (dword[0] & 0x3) == 0x1)
+	{
+		info->eraseTypes[0].size = FLASH_ERASE_SECTOR_SIZE;
+		info->eraseTypes[0].command = (dword[0] >> 8) & 0xFF;
+		info->eraseTypes[0].timeout = FLASH_TIMEOUT_ERASE_MS;
+		n = 1;
+	}
+	if (n == 0)
+	{
+		return false;
+	}
+	
+	// Sort the Erase Types, smallest first
+	for (i = 1; i < n; i++)
+	{
+		extFlashEraseType_t type = info->eraseTypes[i];
+		uint8_t j = i;
+		
+		while (j > 0 && info->eraseTypes[j - 1].size > type.size)
+		{
+			info->eraseTypes[j] = info->eraseTypes[j - 1];
+			j--;
+		}
+		info->eraseTypes[j] = type;
+	}
+	
+	// Page Size, Program and Chip Erase Times (DWORD 11)
+	if (dwords >= 11)
+	{
+		uint32_t multiplier = 2 * ((dword[10] & 0xF) + 1);
+		uint32_t programUs = (((dword[10] >> 8) & 0x1F) + 1) * ((dword[10] & (1UL << 13)) ? 64 : 8) * multiplier;
+		
+		info->pageSize = 1U << ((dword[10] >> 4) & 0xF);
+		info->programTimeout = (programUs + 999) / 1000;
+		info->chipEraseTimeout = (((dword[10] >> 24) & 0x1F) + 1) * chipEraseUnits[(dword[10] >> 29) & 0x3] * multiplier;
+	}
+	else
+	{
+		info->pageSize = FLASH_PROGRAM_PAGE_SIZE;
+		info->programTimeout = FLASH_TIMEOUT_PROGRAM_MS;
+		info->chipEraseTimeout = FLASH_TIMEOUT_CHIP_ERASE_MS;
+	}
+	
+	// Dual Output Fast Read (DWORD 1 support bit, DWORD 4 instruction)
+	if (dword[0] & (1UL << 16))
+	{
+		info->dualReadCommand = (dword[3] >> 8) & 0xFF;
+		info->dualReadDummy = (dword[3] & 0x1F) + ((dword[3] >> 5) & 0x7);
+	}
+	
+	// Program / Erase Suspend (DWORD 12 support and times, DWORD 13 instructions)
+	if (dwords >= 13 && !(dword[11] & FLASH_SFDP_NO_SUSPEND) && (dword[12] >> 24) != 0)
+	{
+		static const uint32_t suspendUnits[4] = { 128, 1000, 8000, 64000 };
+		uint32_t eraseNs = (((dword[11] >> 24) & 0x1F) + 1) * suspendUnits[(dword[11] >> 29) & 0x3];
+		uint32_t programNs = (((dword[11] >> 13) & 0x1F) + 1) * suspendUnits[(dword[11] >> 18) & 0x3];
+		uint32_t eraseInterval = (((dword[11] >> 20) & 0xF) + 1) * 64;
+		uint32_t programInterval = (((dword[11] >> 9) & 0xF) + 1) * 64;
+		
+		// The same instructions suspend programs and erases, so allow for the slower of the two
+		info->suspendCommand = (dword[12] >> 24) & 0xFF;
+		info->resumeCommand = (dword[12] >> 16) & 0xFF;
+		info->suspendLatency = ((eraseNs > programNs ? eraseNs : programNs) + 999) / 1000;
+		info->suspendInterval = (eraseInterval > programInterval) ? eraseInterval : programInterval;
+	}
+	
+	// Return TRUE
+	info->sfdp = true;
+	return true;
+}
+
 /**
  * Verify that the flash component is valid.
  *
@@ -123,12 +503,24 @@ static bool EXTFLASH_readInfo(void)
  */
 static bool _extFlashVerifyPart(void)
 {
+	// Forget the previous Device
+	pFlashInfo = &genericFlashInfo;
+	
 	// Check that we can read the info in
 	if (!EXTFLASH_readInfo())
 	{
 		return false;
 	}
 	
+	// A device that describes itself needs no table entry
+	if (EXTFLASH_readSfdpInfo(&sfdpFlashInfo))
+	{
+		sfdpFlashInfo.manuID = infoBuf[0];
+		sfdpFlashInfo.devID = infoBuf[1];
+		pFlashInfo = &sfdpFlashInfo;
+		return true;
+	}
+	
 	// Point pFlashInfo to FlashInfo Array
 	pFlashInfo = flashInfo;
 	
@@ -142,8 +534,15 @@ static bool _extFlashVerifyPart(void)
 		pFlashInfo++;
 	}
 	
-	// Return whether we found a matching device
-	return (pFlashInfo->deviceSize > 0);
+	// No matching device
+	if (pFlashInfo->deviceSize == 0)
+	{
+		pFlashInfo = &genericFlashInfo;
+		return false;
+	}
+	
+	// Return TRUE
+	return true;
 }
 
 /**
@@ -180,23 +579,33 @@ static bool EXTFLASH_readStatus(uint8_t *buf)
  */
 static int EXTFLASH_waitReady(void)
 {
-	// Return Value
-	int returnValue;
+	// Poll Counter
+	uint32_t polls;
 	
-	for (;;)
+	// A chip erase is the longest operation to wait for
+	for (polls = 0; polls < pFlashInfo->chipEraseTimeout; polls++)
 	{
 		uint8_t buf;
-		returnValue = EXTFLASH_readStatus(&buf);
+		
+		// Read the Status Register
+		if (!EXTFLASH_readStatus(&buf))
+		{
+			return -1;
+		}
 		
 		// Check if Status Register Bit Busy
 		if (!(buf & FLASH_STATUS_BIT_BUSY))
 		{
 			// Now Ready
-			break;
+			return 0;
 		}
+		
+		// Wait before Polling Again
+		delay_ms(1);
 	}
 	
-	return 0;
+	// Timed Out
+	return -2;
 }
 
 /**
@@ -222,117 +631,856 @@ static int EXTFLASH_writeEnable(void)
 }
 
 /**
- * Configures the flash device for user.
+ * Pick the largest erase instruction of the device that starts at {offset}
+ * and stays inside the range, so only the edges of a range fall back to the
+ * smallest erase.
  *
- * @return bool
+ * @param size_t offset					Aligned address of the next erase.
+ * @param size_t length					Aligned number of bytes left to erase.
+ * @param size_t *ilen					Number of bytes the instruction erases.
+ * @param uint32_t *timeout				Time limit of the instruction in milliseconds.
+ *
+ * @return uint8_t						Erase instruction
  */
-bool EXTFLASH_open(void)
+static uint8_t EXTFLASH_eraseCommand(size_t offset, size_t length, size_t *ilen, uint32_t *timeout)
 {
-	// Return Value (default to FALSE)
-	bool returnValue = false;
+	uint8_t i;
 	
-	// Buffer for the Status Register
-	uint8_t buf[1];
+	// Whole Device
+	if (pFlashInfo->deviceSize > 0 && offset == 0 && length >= pFlashInfo->deviceSize)
+	{
+		*ilen = pFlashInfo->deviceSize;
+		*timeout = pFlashInfo->chipEraseTimeout;
+		return FLASH_CMD_CHIP_ERASE;
+	}
 	
-	// Verify the manufacturer and device ID
-	if (_extFlashVerifyPart())
+	// Largest aligned Block that fits
+	for (i = FLASH_ERASE_TYPES - 1; i > 0; i--)
 	{
-		// Read the Status Register
-		returnValue = EXTFLASH_readStatus(buf);
+		const extFlashEraseType_t *type = &pFlashInfo->eraseTypes[i];
+		
+		if (type->size > 0 && (offset % type->size) == 0 && length >= type->size)
+		{
+			break;
+		}
 	}
 	
-	// Return
-	return returnValue;
+	// Smallest Erase otherwise
+	*ilen = pFlashInfo->eraseTypes[i].size;
+	*timeout = pFlashInfo->eraseTypes[i].timeout;
+	return pFlashInfo->eraseTypes[i].command;
 }
 
 /**
- * Send a read request using 24-bit addressing.
+ * Get the description of the flash device found by EXTFLASH_open.
  *
- * @param size_t offset		The byte offset in flash to begin reading from.
- * @param size_t length		The number of bytes to read.
- * @param uint8_t *buf		The buffer where data is stored. Must be at least {length} bytes in size.
+ * @return extFlashInfo_t *
+ */
+const extFlashInfo_t *EXTFLASH_getInfo(void)
+{
+	return pFlashInfo;
+}
+
+#if FLASH_CACHE_PAGES > 0
+/**
+ * Find the part of a cached page that overlaps a range of the flash.
  *
- * @return bool
+ * @param extFlashCacheLine_t *line		Cached page.
+ * @param size_t offset					Start of the range.
+ * @param size_t length					Length of the range.
+ * @param size_t *pos					Offset of the overlap in the page.
+ * @param size_t *ilen					Length of the overlap.
+ *
+ * @return bool							false if the page is outside the range
  */
-bool EXTFLASH_read(size_t offset, size_t length, uint8_t *buf)
+static bool EXTFLASH_cacheOverlap(const extFlashCacheLine_t *line, size_t offset, size_t length, size_t *pos, size_t *ilen)
 {
-	// Write Buffer for Command
-	uint8_t wbuf[4];
-	
-	// Return Value (default to FALSE)
-	bool returnValue = false;
+	size_t start = line->page * FLASH_PROGRAM_PAGE_SIZE;
+	size_t end = start + FLASH_PROGRAM_PAGE_SIZE;
 	
-	// Wait until previous command completes
-	int ret = EXTFLASH_waitReady();
-	
-	if (ret)
+	// Clip the Range to the Page
+	if (!line->valid || offset >= end || offset + length <= start)
 	{
 		return false;
 	}
-	
-	// SPI is driven with low frequency (1Mhz), so not necessary to use fast read.
-	wbuf[0] = FLASH_CMD_READ;
-	wbuf[1] = (offset >> 16) & 0xFF;
-	wbuf[2] = (offset >> 8) & 0xFF;
-	wbuf[3] = offset & 0xFF;
-	
-	// Send the Read Command and Get the Response
-	if (EXTFLASH_transfer(wbuf, rxBuff, length + 4))
+	if (offset > start)
 	{
-		// Copy the data over
-		memcpy(&buf[0], &rxBuff[4], length);
-		
-		// Set the Return Value
-		returnValue = true;
+		start = offset;
+	}
+	if (offset + length < end)
+	{
+		end = offset + length;
 	}
 	
-	// Return the Function
-	return returnValue;
+	*pos = start - line->page * FLASH_PROGRAM_PAGE_SIZE;
+	*ilen = end - start;
+	return true;
 }
 
 /**
- * Send a write request using 24-bit addressing.
+ * Look a page up in the read cache.
  *
- * @param size_t offset		The byte offset in flash to begin writing to.
- * @param size_t length		The number of bytes to write.
- * @param uint8_t *buf		The buffer where data to be written is stored. Must be at least {length} bytes in size.
+ * @param size_t page					Page number.
  *
- * @return bool
+ * @return extFlashCacheLine_t *		Cached page, or NULL on a miss
  */
-bool EXTFLASH_write(size_t offset, size_t length, const uint8_t *buf)
+static extFlashCacheLine_t *EXTFLASH_cacheLookup(size_t page)
 {
-	// Write Buffer for Command
-	uint8_t wbuf[4];
+	uint16_t i;
 	
-	// Status of SPI async
-	struct spi_m_async_status p_stat;
-	
-	// Begin Write Loop
-	while (length > 0)
+	for (i = 0; i < FLASH_CACHE_PAGES; i++)
 	{
-		// Wait until the previous operation is completed.
-		int ret = EXTFLASH_waitReady();
-		
-		// If the device isn't ready, return false
-		if (ret)
+		if (cache[i].valid && cache[i].page == page)
 		{
-			return false;
+			return &cache[i];
 		}
+	}
+	
+	return NULL;
+}
+
+/**
+ * Pick the cache line to reuse with the clock algorithm: the hand skips
+ * (and clears) pages read since it last passed, so hot pages stay cached.
+ *
+ * @return extFlashCacheLine_t *
+ */
+static extFlashCacheLine_t *EXTFLASH_cacheVictim(void)
+{
+	extFlashCacheLine_t *line;
+	
+	while (1)
+	{
+		line = &cache[cacheHand];
+		cacheHand = (cacheHand + 1) % FLASH_CACHE_PAGES;
 		
-		// Enable Writing on the Flash Device
-		ret = EXTFLASH_writeEnable();
-		
-		// If the device isn't ready, return false
-		if (ret)
+		// Free or Cold Page
+		if (!line->valid || !line->referenced)
 		{
-			return false;
+			return line;
 		}
 		
-		// Interim length per instruction
-		size_t ilen;
-		
+		// Give the Page another Round
+		line->referenced = false;
+	}
+}
+#endif
+
+/**
+ * Write a programmed range through to the read cache. Programming can only
+ * clear bits, so the cached data is ANDed with the new data just like the
+ * flash array.
+ *
+ * @param size_t offset					The byte offset in flash that was written.
+ * @param size_t length					The number of bytes written.
+ * @param uint8_t *buf					The data written.
+ *
+ * @return void
+ */
+static void EXTFLASH_cacheProgram(size_t offset, size_t length, const uint8_t *buf)
+{
+#if FLASH_CACHE_PAGES > 0
+	size_t pos, ilen, i;
+	uint16_t n;
+	
+	for (n = 0; n < FLASH_CACHE_PAGES; n++)
+	{
+		if (EXTFLASH_cacheOverlap(&cache[n], offset, length, &pos, &ilen))
+		{
+			const uint8_t *src = &buf[cache[n].page * FLASH_PROGRAM_PAGE_SIZE + pos - offset];
+			
+			for (i = 0; i < ilen; i++)
+			{
+				cache[n].data[pos + i] &= src[i];
+			}
+		}
+	}
+#endif
+}
+
+/**
+ * Write an erased range through to the read cache.
+ *
+ * @param size_t offset					Sector aligned byte offset in flash that was erased.
+ * @param size_t length					Sector aligned number of bytes erased.
+ *
+ * @return void
+ */
+static void EXTFLASH_cacheErase(size_t offset, size_t length)
+{
+#if FLASH_CACHE_PAGES > 0
+	size_t pos, ilen;
+	uint16_t n;
+	
+	for (n = 0; n < FLASH_CACHE_PAGES; n++)
+	{
+		if (EXTFLASH_cacheOverlap(&cache[n], offset, length, &pos, &ilen))
+		{
+			memset(&cache[n].data[pos], 0xFF, ilen);
+		}
+	}
+#endif
+}
+
+/**
+ * Drop the cached pages of a range whose contents are no longer known, after
+ * a failed write or while an asynchronous operation changes it.
+ *
+ * @param size_t offset					The byte offset in flash.
+ * @param size_t length					The number of bytes.
+ *
+ * @return void
+ */
+static void EXTFLASH_cacheDrop(size_t offset, size_t length)
+{
+#if FLASH_CACHE_PAGES > 0
+	size_t pos, ilen;
+	uint16_t n;
+	
+	for (n = 0; n < FLASH_CACHE_PAGES; n++)
+	{
+		if (EXTFLASH_cacheOverlap(&cache[n], offset, length, &pos, &ilen))
+		{
+			cache[n].valid = false;
+		}
+	}
+#endif
+}
+
+/**
+ * Drop every page from the read cache.
+ *
+ * @return void
+ */
+void EXTFLASH_cacheInvalidate(void)
+{
+#if FLASH_CACHE_PAGES > 0
+	uint16_t n;
+	
+	for (n = 0; n < FLASH_CACHE_PAGES; n++)
+	{
+		cache[n].valid = false;
+	}
+#endif
+}
+
+/**
+ * Get the read cache hit and miss counters.
+ *
+ * @param extFlashCacheStats_t *stats	Where the counters are stored.
+ *
+ * @return void
+ */
+void EXTFLASH_cacheStats(extFlashCacheStats_t *stats)
+{
+	*stats = cacheStats;
+}
+
+/**
+ * Reset the read cache hit and miss counters.
+ *
+ * @return void
+ */
+void EXTFLASH_cacheClearStats(void)
+{
+	cacheStats.hits = 0;
+	cacheStats.misses = 0;
+}
+
+/**
+ * Send Resume from Deep Power-Down and wait until the device accepts
+ * instructions again. A device in standby ignores it.
+ *
+ * @return void
+ */
+static void EXTFLASH_resume(void)
+{
+	uint8_t wbuf[1] = { FLASH_CMD_RESUME };
+	
+	EXTFLASH_transfer(wbuf, NULL, 1);
+	delay_us(FLASH_RESUME_US);
+}
+
+#if FLASH_POWER_DOWN_MS > 0
+/**
+ * Resume the device from deep power-down before a blocking call uses it.
+ * Only called with the bus taken, so TIMER cannot power it down again.
+ *
+ * @return void
+ */
+static void EXTFLASH_wake(void)
+{
+	powerOp.down = false;
+	EXTFLASH_resume();
+	
+	powerStats.wakes++;
+	powerStats.downMs += TIMER.time - powerOp.downSince;
+}
+
+/**
+ * Queue the idle task to run once the idle period could be over.
+ *
+ * @param uint32_t interval				TIMER ticks (milliseconds) from now.
+ *
+ * @return void
+ */
+static void EXTFLASH_idleArm(uint32_t interval)
+{
+	powerOp.armed = true;
+	powerTask.interval = interval;
+	powerTask.cb = EXTFLASH_idle_cb;
+	powerTask.mode = TIMER_TASK_ONE_SHOT;
+	timer_add_task(&TIMER, &powerTask);
+}
+
+/**
+ * Start the idle period after an access to the device.
+ *
+ * @return void
+ */
+static void EXTFLASH_idleStart(void)
+{
+	powerOp.idleSince = TIMER.time;
+	
+	// A queued Idle Task checks the Time again before it acts
+	if (!powerOp.armed && !powerOp.down)
+	{
+		EXTFLASH_idleArm(FLASH_POWER_DOWN_MS);
+	}
+}
+
+/**
+ * Status register read by the idle task. The device is powered down unless
+ * it is still programming / erasing, or the driver took it meanwhile.
+ *
+ * @param spiBusTransaction_t *transaction	The transaction.
+ *
+ * @return void
+ */
+static void EXTFLASH_idleStatus_cb(spiBusTransaction_t *transaction)
+{
+	if (transaction->status != ERR_NONE || locked || EXTFLASH_isBusy() || (powerOp.rbuf[1] & FLASH_STATUS_BIT_BUSY))
+	{
+		// Try again after another Idle Period
+		EXTFLASH_idleStart();
+		return;
+	}
+	
+	// Enter Deep Power-Down, a blocking call queued after it wakes the Device
+	powerOp.down = true;
+	powerOp.downSince = TIMER.time;
+	powerStats.powerDowns++;
+	powerOp.wbuf[0] = FLASH_CMD_DEEP_POWER_DOWN;
+	powerOp.segment.length = 1;
+	powerOp.transaction.cb = NULL;
+	SPIBUS_submit(&powerOp.transaction);
+}
+
+/**
+ * Timer task that powers the device down once it has been idle for
+ * FLASH_POWER_DOWN_MS. Staged data is flushed by its own task first.
+ *
+ * @return void
+ */
+static void EXTFLASH_idle_cb(const struct timer_task *const timer_task)
+{
+	uint32_t idle = TIMER.time - powerOp.idleSince;
+	
+	powerOp.armed = false;
+	
+	// Accessed since the Task was queued
+	if (idle < FLASH_POWER_DOWN_MS)
+	{
+		EXTFLASH_idleArm(FLASH_POWER_DOWN_MS - idle);
+		return;
+	}
+	
+	// Still in Use
+#if FLASH_WRITE_COMBINE
+	if (locked || EXTFLASH_isBusy() || stage.end > stage.start)
+#else
+	if (locked || EXTFLASH_isBusy())
+#endif
+	{
+		EXTFLASH_idleStart();
+		return;
+	}
+	
+	// Check the Device has finished its last Program / Erase
+	powerOp.wbuf[0] = FLASH_CMD_READ_STATUS;
+	powerOp.wbuf[1] = 0x00;
+	powerOp.segment.wbuf = powerOp.wbuf;
+	powerOp.segment.rbuf = powerOp.rbuf;
+	powerOp.segment.length = 2;
+	powerOp.transaction.device = &extflashDevice;
+	powerOp.transaction.segments = &powerOp.segment;
+	powerOp.transaction.segmentCount = 1;
+	powerOp.transaction.hold = false;
+	powerOp.transaction.cb = EXTFLASH_idleStatus_cb;
+	if (SPIBUS_submit(&powerOp.transaction) != ERR_NONE)
+	{
+		EXTFLASH_idleStart();
+	}
+}
+#endif
+
+/**
+ * Get the deep power-down counters.
+ *
+ * @param extFlashPowerStats_t *stats	Where the counters are stored.
+ *
+ * @return void
+ */
+void EXTFLASH_powerStats(extFlashPowerStats_t *stats)
+{
+	*stats = powerStats;
+	
+#if FLASH_POWER_DOWN_MS > 0
+	// Count the Time of a running Power Down as well
+	if (powerOp.down)
+	{
+		stats->downMs += TIMER.time - powerOp.downSince;
+	}
+#endif
+}
+
+/**
+ * Reset the deep power-down counters.
+ *
+ * @return void
+ */
+void EXTFLASH_powerClearStats(void)
+{
+	powerStats.powerDowns = 0;
+	powerStats.wakes = 0;
+	powerStats.downMs = 0;
+	
+#if FLASH_POWER_DOWN_MS > 0
+	powerOp.downSince = TIMER.time;
+#endif
+}
+
+/**
+ * Take the SPI bus for a blocking call. A flush already running in the
+ * background is waited for, rather than failing the call as busy.
+ *
+ * @return void
+ */
+static void EXTFLASH_lock(void)
+{
+	// Keep the Auto Flush from starting
+	locked = true;
+	
+#if FLASH_WRITE_COMBINE && FLASH_WRITE_FLUSH_MS > 0
+	// Let a running one finish
+	while (EXTFLASH_isBusy() && asyncOp.cb == EXTFLASH_autoFlushDone)
+	{
+		delay_us(10);
+	}
+#endif
+}
+
+/**
+ * Release the SPI bus after a blocking call, the device is powered down
+ * once it has been idle for FLASH_POWER_DOWN_MS from here.
+ *
+ * @return void
+ */
+static void EXTFLASH_unlock(void)
+{
+	locked = false;
+	
+#if FLASH_POWER_DOWN_MS > 0
+	EXTFLASH_idleStart();
+#endif
+}
+
+/**
+ * Configures the flash device for user.
+ *
+ * @return bool
+ */
+bool EXTFLASH_open(void)
+{
+	// Take the Bus
+	EXTFLASH_lock();
+	
+	// The SPI bus belongs to a running asynchronous operation
+	if (EXTFLASH_isBusy())
+	{
+		EXTFLASH_unlock();
+		return false;
+	}
+	
+	// Return Value (default to FALSE)
+	bool returnValue = false;
+	
+	// Buffer for the Status Register
+	uint8_t buf[1];
+	
+	// A reset of the MCU may have left the Device in Deep Power-Down
+	EXTFLASH_resume();
+	
+	// Verify the manufacturer and device ID
+	if (_extFlashVerifyPart())
+	{
+		// Nothing cached before can be trusted
+		EXTFLASH_cacheInvalidate();
+		
+		// Read the Status Register
+		returnValue = EXTFLASH_readStatus(buf);
+	}
+	
+	// Release the Bus
+	EXTFLASH_unlock();
+	
+	// Return
+	return returnValue;
+}
+
+/**
+ * Build the read instruction for an address using 24-bit addressing.
+ *
+ * @param size_t offset		The byte offset in flash to begin reading from.
+ * @param uint8_t *wbuf		Buffer for the instruction, FLASH_MAX_COMMAND_SIZE bytes.
+ *
+ * @return uint8_t						Instruction length
+ */
+static uint8_t EXTFLASH_readInstruction(size_t offset, uint8_t *wbuf)
+{
+	// Read Data is only specified up to FLASH_READ_MAX_FREQUENCY, above it use Fast Read
+	wbuf[0] = (FLASH_SPI_FREQUENCY > FLASH_READ_MAX_FREQUENCY) ? FLASH_CMD_FAST_READ : FLASH_CMD_READ;
+	wbuf[1] = (offset >> 16) & 0xFF;
+	wbuf[2] = (offset >> 8) & 0xFF;
+	wbuf[3] = offset & 0xFF;
+	
+	// Fast Read needs one dummy byte before the data
+	if (wbuf[0] == FLASH_CMD_FAST_READ)
+	{
+		wbuf[4] = 0x00;
+		return 5;
+	}
+	
+	return 4;
+}
+
+/**
+ * Suspend a program / erase in progress so the device can be read. The
+ * operation gets at least suspendInterval to run after its last resume
+ * first, so a stream of reads cannot starve it. A device that did not
+ * suspend is waited for.
+ *
+ * @return int								0 on success, < 0 on failure
+ */
+static int EXTFLASH_suspend(void)
+{
+	const uint8_t wbuf[] = { pFlashInfo->suspendCommand };
+	
+	// Resumed within the last Tick (or two), let it run
+	if (TIMER.time - resumedAt < 2)
+	{
+		delay_us(pFlashInfo->suspendInterval);
+	}
+	
+	// Send the Suspend, and give it time to take effect
+	if (!EXTFLASH_transfer(wbuf, NULL, 1))
+	{
+		return -3;
+	}
+	delay_us(pFlashInfo->suspendLatency);
+	
+	// The Device is ready once suspended
+	return EXTFLASH_waitReady();
+}
+
+/**
+ * Resume a program / erase suspended by EXTFLASH_suspend.
+ *
+ * @return bool
+ */
+static bool EXTFLASH_resumeSuspended(void)
+{
+	const uint8_t wbuf[] = { pFlashInfo->resumeCommand };
+	
+	resumedAt = TIMER.time;
+	return EXTFLASH_transfer(wbuf, NULL, 1);
+}
+
+/**
+ * Send a read request using 24-bit addressing. The whole read is one
+ * transaction with CS held low, so any length can be read and the data is
+ * received straight into {buf}. On parts that support it a program / erase
+ * in progress (also of an asynchronous operation) is suspended for the read
+ * and resumed after it, rather than waited for. Data inside the range being
+ * programmed / erased reads back undefined until the operation is done.
+ *
+ * @param size_t offset		The byte offset in flash to begin reading from.
+ * @param size_t length		The number of bytes to read.
+ * @param uint8_t *buf		The buffer where data is stored. Must be at least {length} bytes in size.
+ *
+ * @return bool
+ */
+static bool EXTFLASH_readDevice(size_t offset, size_t length, uint8_t *buf)
+{
+	bool returnValue = false;
+	uint8_t status;
+	
+	// Without Suspend the SPI bus belongs to a running asynchronous operation
+	if (pFlashInfo->suspendCommand == 0)
+	{
+		if (EXTFLASH_isBusy() || EXTFLASH_waitReady())
+		{
+			return false;
+		}
+		
+		// Send the Command, then Stream the Data into the Caller's Buffer
+		uint8_t wbuf[FLASH_MAX_COMMAND_SIZE];
+		return EXTFLASH_command(wbuf, EXTFLASH_readInstruction(offset, wbuf), NULL, buf, length, false);
+	}
+	
+	// Keep an Asynchronous Operation from starting another Instruction
+	asyncOp.paused = true;
+	
+	// Suspend a Program / Erase in Progress
+	if (EXTFLASH_readStatus(&status))
+	{
+		bool busy = (status & FLASH_STATUS_BIT_BUSY) != 0;
+		
+		if (!busy || EXTFLASH_suspend() == 0)
+		{
+			uint8_t wbuf[FLASH_MAX_COMMAND_SIZE];
+			returnValue = EXTFLASH_command(wbuf, EXTFLASH_readInstruction(offset, wbuf), NULL, buf, length, false);
+		}
+		
+		// Let it carry on
+		if (busy && !EXTFLASH_resumeSuspended())
+		{
+			returnValue = false;
+		}
+	}
+	
+	// Let the Asynchronous Operation carry on
+	asyncOp.paused = false;
+	
+	return returnValue;
+}
+
+/**
+ * Read through the read cache. Every page touched is looked up, and a miss
+ * reads the whole page from the device into the cache. Reads larger than
+ * the cache go straight to the device.
+ *
+ * @param size_t offset		The byte offset in flash to begin reading from.
+ * @param size_t length		The number of bytes to read.
+ * @param uint8_t *buf		The buffer where data is stored. Must be at least {length} bytes in size.
+ *
+ * @return bool
+ */
+static bool EXTFLASH_readCached(size_t offset, size_t length, uint8_t *buf)
+{
+#if FLASH_CACHE_PAGES > 0
+	extFlashCacheLine_t *line;
+	
+	// Streaming the data is cheaper than cycling it through the cache
+	if (length > FLASH_CACHE_PAGES * FLASH_PROGRAM_PAGE_SIZE)
+	{
+		return EXTFLASH_readDevice(offset, length, buf);
+	}
+	
+	while (length > 0)
+	{
+		// Part of the Read inside this Page
+		size_t page = offset / FLASH_PROGRAM_PAGE_SIZE;
+		size_t pos = offset % FLASH_PROGRAM_PAGE_SIZE;
+		size_t ilen = FLASH_PROGRAM_PAGE_SIZE - pos;
+		if (length < ilen)
+		{
+			ilen = length;
+		}
+		
+		// Look the Page up, fill a Line on a Miss
+		line = EXTFLASH_cacheLookup(page);
+		if (line)
+		{
+			cacheStats.hits++;
+		}
+		else if (EXTFLASH_isBusy())
+		{
+			// The Page may change under the running Operation, read it past the Cache
+			cacheStats.misses++;
+			if (!EXTFLASH_readDevice(offset, ilen, buf))
+			{
+				return false;
+			}
+			offset += ilen;
+			length -= ilen;
+			buf += ilen;
+			continue;
+		}
+		else
+		{
+			cacheStats.misses++;
+			line = EXTFLASH_cacheVictim();
+			line->valid = false;
+			if (!EXTFLASH_readDevice(page * FLASH_PROGRAM_PAGE_SIZE, FLASH_PROGRAM_PAGE_SIZE, line->data))
+			{
+				return false;
+			}
+			line->page = page;
+			line->valid = true;
+		}
+		
+		// Copy the Data out
+		line->referenced = true;
+		memcpy(buf, &line->data[pos], ilen);
+		
+		// Move on to the next Page
+		offset += ilen;
+		length -= ilen;
+		buf += ilen;
+	}
+	
+	// Return TRUE
+	return true;
+#else
+	return EXTFLASH_readDevice(offset, length, buf);
+#endif
+}
+
+/**
+ * Lay data that is still staged over data read from the flash. Programming
+ * can only clear bits, so ANDing gives what the flash will hold after the
+ * flush, and data the cache already holds it for is unchanged.
+ *
+ * @param size_t offset		The byte offset in flash that was read.
+ * @param size_t length		The number of bytes read.
+ * @param uint8_t *buf		The data read.
+ *
+ * @return void
+ */
+static void EXTFLASH_stageOverlay(size_t offset, size_t length, uint8_t *buf)
+{
+#if FLASH_WRITE_COMBINE
+	size_t start = stage.page * FLASH_PROGRAM_PAGE_SIZE + stage.start;
+	size_t end = stage.page * FLASH_PROGRAM_PAGE_SIZE + stage.end;
+	size_t i;
+	
+	// Clip the Stage to the Read
+	if (start < offset)
+	{
+		start = offset;
+	}
+	if (end > offset + length)
+	{
+		end = offset + length;
+	}
+	
+	for (i = start; i < end; i++)
+	{
+		buf[i - offset] &= stage.data[i % FLASH_PROGRAM_PAGE_SIZE];
+	}
+#endif
+}
+
+/**
+ * Read from the flash through the read cache, including data still staged
+ * by EXTFLASH_write.
+ *
+ * @param size_t offset		The byte offset in flash to begin reading from.
+ * @param size_t length		The number of bytes to read.
+ * @param uint8_t *buf		The buffer where data is stored. Must be at least {length} bytes in size.
+ *
+ * @return bool
+ */
+bool EXTFLASH_read(size_t offset, size_t length, uint8_t *buf)
+{
+	bool returnValue;
+	
+	// Read with the Bus taken
+	EXTFLASH_lock();
+	returnValue = EXTFLASH_readCached(offset, length, buf);
+	if (returnValue)
+	{
+		EXTFLASH_stageOverlay(offset, length, buf);
+	}
+	EXTFLASH_unlock();
+	
+	return returnValue;
+}
+
+/**
+ * Read from the flash bypassing the read cache, including data still staged
+ * by EXTFLASH_write. Use it for data read once, such as a scan, so it does
+ * not push hot pages out of the cache.
+ *
+ * @param size_t offset		The byte offset in flash to begin reading from.
+ * @param size_t length		The number of bytes to read.
+ * @param uint8_t *buf		The buffer where data is stored. Must be at least {length} bytes in size.
+ *
+ * @return bool
+ */
+bool EXTFLASH_read_uncached(size_t offset, size_t length, uint8_t *buf)
+{
+	bool returnValue;
+	
+	// Read with the Bus taken
+	EXTFLASH_lock();
+	returnValue = EXTFLASH_readDevice(offset, length, buf);
+	if (returnValue)
+	{
+		EXTFLASH_stageOverlay(offset, length, buf);
+	}
+	EXTFLASH_unlock();
+	
+	return returnValue;
+}
+
+/**
+ * Send page program requests using 24-bit addressing.
+ *
+ * @param size_t offset		The byte offset in flash to begin writing to.
+ * @param size_t length		The number of bytes to write.
+ * @param uint8_t *buf		The buffer where data to be written is stored. Must be at least {length} bytes in size.
+ *
+ * @return bool
+ */
+static bool EXTFLASH_program(size_t offset, size_t length, const uint8_t *buf)
+{
+	// The SPI bus belongs to a running asynchronous operation
+	if (EXTFLASH_isBusy())
+	{
+		return false;
+	}
+	
+	// Write Buffer for Command
+	uint8_t wbuf[4];
+	
+	// Begin Write Loop
+	while (length > 0)
+	{
+		// Wait until the previous operation is completed.
+		int ret = EXTFLASH_waitReady();
+		
+		// If the device isn't ready, return false
+		if (ret)
+		{
+			return false;
+		}
+		
+		// Enable Writing on the Flash Device
+		ret = EXTFLASH_writeEnable();
+		
+		// If the device isn't ready, return false
+		if (ret)
+		{
+			return false;
+		}
+		
+		// Interim length per instruction
+		size_t ilen;
+		
 		// Work out the Instruction Length
-		ilen = FLASH_PROGRAM_PAGE_SIZE - (offset % FLASH_PROGRAM_PAGE_SIZE);
+		ilen = pFlashInfo->pageSize - (offset % pFlashInfo->pageSize);
 		
 		// Bound Checking
 		if (length < ilen)
@@ -350,82 +1498,318 @@ bool EXTFLASH_write(size_t offset, size_t length, const uint8_t *buf)
 		offset += ilen;
 		length -= ilen;
 		
-		// Start the Combined Write Sequence
-		gpio_set_pin_level(SERIALFLASH_CS, 0);
+		// Write the Page Program Command and the Page of Data in one Sequence
+		if (!EXTFLASH_command(wbuf, sizeof(wbuf), buf, NULL, ilen, false))
+		{
+			return false;
+		}
+		
+		// Increment the Buffer
+		buf += ilen;
+	}
+	
+	// Return TRUE
+	return true;
+}
+
+/**
+ * Program data and write it through to the read cache.
+ *
+ * @param size_t offset		The byte offset in flash to begin writing to.
+ * @param size_t length		The number of bytes to write.
+ * @param uint8_t *buf		The buffer where data to be written is stored. Must be at least {length} bytes in size.
+ *
+ * @return bool
+ */
+static bool EXTFLASH_programThrough(size_t offset, size_t length, const uint8_t *buf)
+{
+	// Program the Device
+	if (!EXTFLASH_program(offset, length, buf))
+	{
+		// Part of the range may have been programmed
+		EXTFLASH_cacheDrop(offset, length);
+		return false;
+	}
+	
+	// Update the Cached Pages
+	EXTFLASH_cacheProgram(offset, length, buf);
+	
+	// Return TRUE
+	return true;
+}
+
+/**
+ * Program the staged data, the stage is empty afterwards even on a failure.
+ *
+ * @return bool
+ */
+static bool EXTFLASH_flushStage(void)
+{
+#if FLASH_WRITE_COMBINE
+	bool returnValue = true;
+	
+	// Program the staged Run
+	if (stage.end > stage.start)
+	{
+		returnValue = EXTFLASH_programThrough(stage.page * FLASH_PROGRAM_PAGE_SIZE + stage.start, stage.end - stage.start, &stage.data[stage.start]);
+	}
+	
+	// Empty the Stage
+	stage.start = 0;
+	stage.end = 0;
+	return returnValue;
+#else
+	return true;
+#endif
+}
+
+/**
+ * Send a write request using 24-bit addressing. With FLASH_WRITE_COMBINE a
+ * write that does not fill a page is staged in RAM, and the following
+ * sequential writes are added to it until the page is full, so a run of
+ * small records costs one page program. Staged data reads back straight
+ * away; it is programmed when its page fills, on EXTFLASH_flush, before an
+ * asynchronous operation, or FLASH_WRITE_FLUSH_MS after it was staged. A
+ * program failure of staged data is reported by the call that flushes it.
+ *
+ * @param size_t offset		The byte offset in flash to begin writing to.
+ * @param size_t length		The number of bytes to write.
+ * @param uint8_t *buf		The buffer where data to be written is stored. Must be at least {length} bytes in size.
+ *
+ * @return bool
+ */
+bool EXTFLASH_write(size_t offset, size_t length, const uint8_t *buf)
+{
+	bool returnValue = true;
+	
+	// Take the Bus
+	EXTFLASH_lock();
+	
+	// The SPI bus belongs to a running asynchronous operation
+	if (EXTFLASH_isBusy())
+	{
+		EXTFLASH_unlock();
+		return false;
+	}
+	
+#if FLASH_WRITE_COMBINE
+	while (length > 0 && returnValue)
+	{
+		// Part of the Write inside this Page
+		size_t page = offset / FLASH_PROGRAM_PAGE_SIZE;
+		uint16_t pos = offset % FLASH_PROGRAM_PAGE_SIZE;
+		size_t ilen = FLASH_PROGRAM_PAGE_SIZE - pos;
+		if (length < ilen)
+		{
+			ilen = length;
+		}
 		
-		// First, write the page program command
-		if (spi_m_async_transfer(&SERIALFLASH, wbuf, rxBuff, 4) == ERR_NONE)
+		// Only a write carrying on from the staged data is combined with it
+		if (stage.end > stage.start && (page != stage.page || pos != stage.end))
 		{
-			// Wait until transfer completes
-			while (spi_m_async_get_status(&SERIALFLASH, &p_stat) == ERR_BUSY)
+			if (!EXTFLASH_flushStage())
 			{
-				// Delay and Re-Check
-				delay_us(10);
+				returnValue = false;
+				break;
 			}
 		}
+		
+		if (ilen == FLASH_PROGRAM_PAGE_SIZE)
+		{
+			// Whole Pages gain nothing from the Stage
+			returnValue = EXTFLASH_programThrough(offset, ilen, buf);
+		}
 		else
 		{
-			// Failure
-			gpio_set_pin_level(SERIALFLASH_CS, 1);
-			
-			// Return FALSE
-			return false;
+			// Add to the Stage, the cache sees the data straight away
+			if (stage.end == stage.start)
+			{
+#if FLASH_POWER_DOWN_MS > 0
+				// The auto flush goes to the Bus without waking the Device
+				if (powerOp.down)
+				{
+					EXTFLASH_wake();
+				}
+#endif
+				stage.page = page;
+				stage.start = pos;
+				stage.end = pos;
+			}
+			memcpy(&stage.data[pos], buf, ilen);
+			stage.end += ilen;
+			EXTFLASH_cacheProgram(offset, ilen, buf);
+			
+			// Program the Page once it is full
+			if (stage.end == FLASH_PROGRAM_PAGE_SIZE)
+			{
+				returnValue = EXTFLASH_flushStage();
+			}
+#if FLASH_WRITE_FLUSH_MS > 0
+			// Otherwise have TIMER flush it
+			else if (!flushArmed)
+			{
+				flushArmed = true;
+				flushTask.interval = FLASH_WRITE_FLUSH_MS;
+				flushTask.cb = EXTFLASH_autoFlush_cb;
+				flushTask.mode = TIMER_TASK_ONE_SHOT;
+				timer_add_task(&TIMER, &flushTask);
+			}
+#endif
+		}
+		
+		// Move on to the next Page
+		offset += ilen;
+		length -= ilen;
+		buf += ilen;
+	}
+#else
+	returnValue = EXTFLASH_programThrough(offset, length, buf);
+#endif
+	
+	// Release the Bus
+	EXTFLASH_unlock();
+	
+	// Return
+	return returnValue;
+}
+
+/**
+ * Program any data staged by EXTFLASH_write.
+ *
+ * @return bool							false if the program failed or an asynchronous operation is running
+ */
+bool EXTFLASH_flush(void)
+{
+	bool returnValue = false;
+	
+	// Take the Bus
+	EXTFLASH_lock();
+	
+	// Flush unless the Bus belongs to an Asynchronous Operation
+	if (!EXTFLASH_isBusy())
+	{
+		returnValue = EXTFLASH_flushStage();
+	}
+	
+	// Release the Bus
+	EXTFLASH_unlock();
+	
+	// Return
+	return returnValue;
+}
+
+/**
+ * CRC-16/CCITT of a range of the flash, to check data once it has been
+ * programmed. Staged data is flushed first so the device holds it. The DMAC
+ * CRC unit checksums the data as the SPI receive channel moves it, and the
+ * data itself is dropped; while the unit is taken (and in host builds) the
+ * data is read a page at a time and run through CRC_crc16.
+ *
+ * @param size_t offset		The byte offset in flash to begin from.
+ * @param size_t length		The number of bytes to checksum.
+ * @param uint16_t *crc		CRC so far (CRC16_INIT to start), updated on success.
+ *
+ * @return bool
+ */
+bool EXTFLASH_crc16(size_t offset, size_t length, uint16_t *crc)
+{
+	bool returnValue = false;
+	
+	// Write Buffer for Command (plus the Fast Read dummy byte)
+	uint8_t wbuf[FLASH_MAX_COMMAND_SIZE];
+	
+	// Take the Flash, program the Stage so the Device holds it, then send the
+	// Read Command and keep the Device selected for the Data
+	EXTFLASH_lock();
+	if (EXTFLASH_isBusy() || !EXTFLASH_flushStage() || EXTFLASH_waitReady()
+		|| !EXTFLASH_command(wbuf, EXTFLASH_readInstruction(offset, wbuf), NULL, NULL, 0, length > 0))
+	{
+		EXTFLASH_unlock();
+		return false;
+	}
+	
+	if (length == 0)
+	{
+		// Nothing to Checksum
+		returnValue = true;
+	}
+	else if (CRC_channelBegin(CONF_SERCOM_5_SPI_M_DMA_RX_CHANNEL, CRC_16_CCITT, *crc))
+	{
+		// Checksum the Data in Flight
+		returnValue = EXTFLASH_command(NULL, 0, NULL, NULL, length, false);
+		uint16_t result = (uint16_t)CRC_channelEnd();
+		if (returnValue)
+		{
+			*crc = result;
 		}
+	}
+	else
+	{
+		uint16_t result = *crc;
+		returnValue = true;
 		
-		// Now write out the page of data
-		if (spi_m_async_transfer(&SERIALFLASH, buf, rxBuff, ilen) == ERR_NONE)
+		// Checksum the Data a Page at a Time
+		while (returnValue && length > 0)
 		{
-			// Wait until transfer completes
-			while (spi_m_async_get_status(&SERIALFLASH, &p_stat) == ERR_BUSY)
-			{
-				// Delay and Re-Check
-				delay_us(10);
-			}
+			size_t ilen = (length > FLASH_PROGRAM_PAGE_SIZE) ? FLASH_PROGRAM_PAGE_SIZE : length;
+			
+			length -= ilen;
+			returnValue = EXTFLASH_command(NULL, 0, NULL, rxBuff, ilen, length > 0);
+			result = CRC_crc16(result, rxBuff, ilen);
 		}
-		else
+		if (returnValue)
 		{
-			// Failure
-			gpio_set_pin_level(SERIALFLASH_CS, 1);
-			
-			// Return FALSE
-			return false;
+			*crc = result;
 		}
-		
-		// Complete the combined write sequence
-		gpio_set_pin_level(SERIALFLASH_CS, 1);
-		
-		// Increment the Buffer
-		buf += ilen;
 	}
 	
-	// Return TRUE
-	return true;
+	// The last Transaction deselected the Device, release the Flash
+	EXTFLASH_unlock();
+	
+	return returnValue;
 }
 
 /**
- * Send an erase request using 24-bit addressing.
+ * Send erase requests using 24-bit addressing. Every sector touched by the
+ * range is erased, using the largest block erase that fits at each step, and
+ * the read cache is updated.
  *
  * @param size_t offset				The byte offset in flash to begin erasing from.
  * @param size_t length				The number of bytes to erase.
  *
  * @return bool
  */
-bool EXTFLASH_erase(size_t offset, size_t length)
+static bool EXTFLASH_eraseRange(size_t offset, size_t length)
 {
+	// The SPI bus belongs to a running asynchronous operation
+	if (EXTFLASH_isBusy())
+	{
+		return false;
+	}
+	
 	// Write Buffer for Command
 	uint8_t wbuf[4];
-	size_t i, numsectors;
+	size_t ilen;
+	uint32_t timeout;
 	
-	// Set the Erase Command
-	wbuf[0] = FLASH_CMD_SECTOR_ERASE;
+	// Nothing to Erase
+	if (length == 0)
+	{
+		return true;
+	}
 	
-	// Set the Offsets
-	size_t endoffset = offset + length - 1;
-	offset = (offset / FLASH_ERASE_SECTOR_SIZE) * FLASH_ERASE_SECTOR_SIZE;
-	numsectors = (endoffset - offset + FLASH_ERASE_SECTOR_SIZE - 1) / FLASH_ERASE_SECTOR_SIZE;
+	// Round out to the smallest Erase of the Device
+	size_t sector = pFlashInfo->eraseTypes[0].size;
+	size_t endoffset = offset + length;
+	offset = (offset / sector) * sector;
+	length = ((endoffset + sector - 1) / sector) * sector - offset;
 	
-	// Loop through each sector to erase
-	for (i = 0; i < numsectors; i++)
+	// Whole Range, for the Cache if an Erase fails
+	size_t first = offset;
+	size_t total = length;
+	
+	// Loop until the whole range is erased
+	while (length > 0)
 	{
 		// Wait until the previous operation is complete
 		int ret = EXTFLASH_waitReady();
@@ -433,6 +1817,7 @@ bool EXTFLASH_erase(size_t offset, size_t length)
 		// If not complete, return FALSE
 		if (ret)
 		{
+			EXTFLASH_cacheDrop(first, total);
 			return false;
 		}
 		
@@ -442,18 +1827,475 @@ bool EXTFLASH_erase(size_t offset, size_t length)
 		// If not complete, return FALSE
 		if (ret)
 		{
+			EXTFLASH_cacheDrop(first, total);
 			return false;
 		}
 		
-		// 24 bit sector address
+		// Largest erase that fits, with its 24 bit address
+		wbuf[0] = EXTFLASH_eraseCommand(offset, length, &ilen, &timeout);
 		wbuf[1] = (offset >> 16) & 0xFF;
 		wbuf[2] = (offset >> 8) & 0xFF;
 		wbuf[3] = offset & 0xFF;
 		
-		// Send the Erase Command and Get the Response
-		if (EXTFLASH_transfer(wbuf, rxBuff, 4)) {}
+		// Send the Erase Command, a chip erase has no address
+		if (!EXTFLASH_transfer(wbuf, rxBuff, (wbuf[0] == FLASH_CMD_CHIP_ERASE) ? 1 : 4))
+		{
+			EXTFLASH_cacheDrop(first, total);
+			return false;
+		}
+		
+		// The Block reads back erased from here on
+		EXTFLASH_cacheErase(offset, ilen);
+		
+		// Move on past the erased Block
+		offset += ilen;
+		length -= ilen;
+	}
+	
+	// Return TRUE
+	return true;
+}
+
+/**
+ * Send erase requests using 24-bit addressing. Every sector touched by the
+ * range is erased, using the largest block erase that fits at each step.
+ *
+ * @param size_t offset				The byte offset in flash to begin erasing from.
+ * @param size_t length				The number of bytes to erase.
+ *
+ * @return bool
+ */
+bool EXTFLASH_erase(size_t offset, size_t length)
+{
+	bool returnValue;
+	
+	// Take the Bus
+	EXTFLASH_lock();
+	
+#if FLASH_WRITE_COMBINE
+	// Staged data inside the range would be erased, so it is dropped
+	if (!EXTFLASH_isBusy() && stage.end > stage.start)
+	{
+		size_t sector = pFlashInfo->eraseTypes[0].size;
+		size_t staged = stage.page * FLASH_PROGRAM_PAGE_SIZE;
+		
+		if (length > 0 && staged >= (offset / sector) * sector && staged < ((offset + length + sector - 1) / sector) * sector)
+		{
+			stage.start = 0;
+			stage.end = 0;
+		}
+	}
+#endif
+	
+	// Erase the Range
+	returnValue = EXTFLASH_eraseRange(offset, length);
+	
+	// Release the Bus
+	EXTFLASH_unlock();
+	
+	// Return
+	return returnValue;
+}
+
+/**
+ * Check whether an asynchronous erase / program operation is running.
+ *
+ * @return bool
+ */
+bool EXTFLASH_isBusy(void)
+{
+	return (asyncOp.state != EXTFLASH_ASYNC_IDLE);
+}
+
+/**
+ * End the asynchronous operation and report the result.
+ *
+ * @param extFlashResult_t result		Result of the operation.
+ *
+ * @return void
+ */
+static void EXTFLASH_asyncFinish(extFlashResult_t result)
+{
+	// Keep the Callback, the operation slot is free from here on
+	extFlashCallback_t cb = asyncOp.cb;
+	
+	// Free the Operation Slot
+	asyncOp.state = EXTFLASH_ASYNC_IDLE;
+	
+#if FLASH_POWER_DOWN_MS > 0
+	// Start the Idle Period
+	EXTFLASH_idleStart();
+#endif
+	
+	// Report the Result
+	if (cb)
+	{
+		cb(result);
+	}
+}
+
+/**
+ * Queue the next bus transaction of the asynchronous operation. The data of
+ * a page program goes in the same transaction as its command, so CS stays
+ * low between them.
+ *
+ * @param extFlashAsyncState_t state	State while the transaction is in flight.
+ * @param uint8_t *wbuf					Write buffer.
+ * @param uint8_t *rbuf					Read buffer, or NULL.
+ * @param uint16_t length				Length of bytes to transfer.
+ * @param uint8_t *data					Page data following the command, or NULL.
+ * @param size_t dataLength				Length of the page data.
+ *
+ * @return void
+ */
+static void EXTFLASH_asyncTransfer(extFlashAsyncState_t state, const uint8_t *wbuf, uint8_t *rbuf, uint16_t length, const uint8_t *data, size_t dataLength)
+{
+	asyncOp.state = state;
+	
+	// Command, then Data
+	asyncOp.segments[0].wbuf = wbuf;
+	asyncOp.segments[0].rbuf = rbuf;
+	asyncOp.segments[0].length = length;
+	asyncOp.segments[1].wbuf = data;
+	asyncOp.segments[1].rbuf = NULL;
+	asyncOp.segments[1].length = dataLength;
+	asyncOp.transaction.device = &extflashDevice;
+	asyncOp.transaction.segments = asyncOp.segments;
+	asyncOp.transaction.segmentCount = 2;
+	asyncOp.transaction.hold = false;
+	asyncOp.transaction.cb = EXTFLASH_async_cb;
+	
+	// Queue it, completion comes back through EXTFLASH_async_cb
+	if (SPIBUS_submit(&asyncOp.transaction) != ERR_NONE)
+	{
+		EXTFLASH_asyncFinish(EXTFLASH_ERROR);
+	}
+}
+
+/**
+ * Timer task that reads the status register of the busy device.
+ *
+ * @return void
+ */
+static void EXTFLASH_asyncPoll_cb(const struct timer_task *const timer_task)
+{
+	EXTFLASH_asyncStep();
+}
+
+// Queue a Status Poll
+static void EXTFLASH_asyncQueuePoll(void);
+
+/**
+ * Schedule the next status poll, or give up once the instruction has taken
+ * longer than its timeout.
+ *
+ * @return void
+ */
+static void EXTFLASH_asyncSchedulePoll(void)
+{
+	// Check the Timeout
+	if (asyncOp.polls++ >= asyncOp.timeout)
+	{
+		EXTFLASH_asyncFinish(EXTFLASH_TIMEOUT);
+		return;
 	}
 	
+	EXTFLASH_asyncQueuePoll();
+}
+
+/**
+ * Queue the next status poll without counting it towards the timeout.
+ *
+ * @return void
+ */
+static void EXTFLASH_asyncQueuePoll(void)
+{
+	// Poll again on a later Timer Tick
+	asyncOp.state = EXTFLASH_ASYNC_POLL;
+	asyncPollTask.interval = FLASH_POLL_INTERVAL_MS;
+	asyncPollTask.cb = EXTFLASH_asyncPoll_cb;
+	asyncPollTask.mode = TIMER_TASK_ONE_SHOT;
+	timer_add_task(&TIMER, &asyncPollTask);
+}
+
+/**
+ * Advance the asynchronous operation after an SPI transfer or a status poll.
+ * Each instruction goes through write enable, command (and page data), then
+ * status polls until the device is ready for the next one.
+ *
+ * @return void
+ */
+static void EXTFLASH_asyncStep(void)
+{
+	switch (asyncOp.state)
+	{
+		case EXTFLASH_ASYNC_POLL:
+			// Read the Status Register
+			asyncOp.wbuf[0] = FLASH_CMD_READ_STATUS;
+			asyncOp.wbuf[1] = 0x00;
+			EXTFLASH_asyncTransfer(EXTFLASH_ASYNC_STATUS, asyncOp.wbuf, asyncOp.rbuf, 2, NULL, 0);
+			break;
+			
+		case EXTFLASH_ASYNC_STATUS:
+			// Still Busy with the previous Instruction
+			if (asyncOp.rbuf[1] & FLASH_STATUS_BIT_BUSY)
+			{
+				EXTFLASH_asyncSchedulePoll();
+				break;
+			}
+			
+			// A read may have the Instruction suspended, look again once it is done
+			if (asyncOp.paused)
+			{
+				EXTFLASH_asyncQueuePoll();
+				break;
+			}
+			
+			// Everything Done
+			if (asyncOp.length == 0)
+			{
+				EXTFLASH_asyncFinish(EXTFLASH_OK);
+				break;
+			}
+			
+			// Enable Writing for the next Instruction
+			asyncOp.polls = 0;
+			asyncOp.wbuf[0] = FLASH_CMD_WRITE_ENABLE;
+			EXTFLASH_asyncTransfer(EXTFLASH_ASYNC_WRITE_ENABLE, asyncOp.wbuf, NULL, 1, NULL, 0);
+			break;
+			
+		case EXTFLASH_ASYNC_WRITE_ENABLE:
+			// A read started meanwhile, the Instruction waits for it
+			if (asyncOp.paused)
+			{
+				EXTFLASH_asyncQueuePoll();
+				break;
+			}
+			
+			// Work out the Instruction Length, a page program must not cross a page
+			if (asyncOp.command == FLASH_CMD_PROGRAM)
+			{
+				asyncOp.wbuf[0] = FLASH_CMD_PROGRAM;
+				asyncOp.ilen = pFlashInfo->pageSize - (asyncOp.offset % pFlashInfo->pageSize);
+				if (asyncOp.length < asyncOp.ilen)
+				{
+					asyncOp.ilen = asyncOp.length;
+				}
+				asyncOp.timeout = pFlashInfo->programTimeout / FLASH_POLL_INTERVAL_MS;
+			}
+			else
+			{
+				asyncOp.wbuf[0] = EXTFLASH_eraseCommand(asyncOp.offset, asyncOp.length, &asyncOp.ilen, &asyncOp.timeout);
+				asyncOp.timeout /= FLASH_POLL_INTERVAL_MS;
+			}
+			
+			// Add the 24 bit address, a chip erase has none
+			asyncOp.wbuf[1] = (asyncOp.offset >> 16) & 0xFF;
+			asyncOp.wbuf[2] = (asyncOp.offset >> 8) & 0xFF;
+			asyncOp.wbuf[3] = asyncOp.offset & 0xFF;
+			if (asyncOp.command == FLASH_CMD_PROGRAM)
+			{
+				// The page data follows the program command
+				EXTFLASH_asyncTransfer(EXTFLASH_ASYNC_COMMAND, asyncOp.wbuf, NULL, 4, asyncOp.buf, asyncOp.ilen);
+			}
+			else
+			{
+				EXTFLASH_asyncTransfer(EXTFLASH_ASYNC_COMMAND, asyncOp.wbuf, NULL, (asyncOp.wbuf[0] == FLASH_CMD_CHIP_ERASE) ? 1 : 4, NULL, 0);
+			}
+			break;
+			
+		case EXTFLASH_ASYNC_COMMAND:
+			// Program / Erase Started
+			asyncOp.offset += asyncOp.ilen;
+			asyncOp.length -= asyncOp.ilen;
+			if (asyncOp.command == FLASH_CMD_PROGRAM)
+			{
+				asyncOp.buf += asyncOp.ilen;
+			}
+			EXTFLASH_asyncSchedulePoll();
+			break;
+			
+		default:
+			break;
+	}
+}
+
+/**
+ * Start an asynchronous operation by polling the status register, so a
+ * previous erase / program is allowed to finish first.
+ *
+ * @param uint8_t command				FLASH_CMD_PROGRAM, or FLASH_CMD_SECTOR_ERASE for any erase.
+ * @param size_t offset					Address of the first instruction.
+ * @param size_t length					Bytes to erase / program.
+ * @param uint8_t *buf					Data to program, or NULL.
+ * @param extFlashCallback_t cb			Completion callback.
+ *
+ * @return bool
+ */
+static bool EXTFLASH_asyncStart(uint8_t command, size_t offset, size_t length, const uint8_t *buf, extFlashCallback_t cb)
+{
+	// Only one Operation at a Time
+	if (EXTFLASH_isBusy() || length == 0)
+	{
+		return false;
+	}
+	
+	// Set up the Operation
+	asyncOp.command = command;
+	asyncOp.offset = offset;
+	asyncOp.length = length;
+	asyncOp.buf = buf;
+	asyncOp.polls = 0;
+	
+	// The previous operation may have been anything up to a chip erase
+	asyncOp.timeout = pFlashInfo->chipEraseTimeout / FLASH_POLL_INTERVAL_MS;
+	asyncOp.cb = cb;
+	
+	// Begin with a Status Poll
+	asyncOp.state = EXTFLASH_ASYNC_POLL;
+	EXTFLASH_asyncStep();
+	
 	// Return TRUE
 	return true;
-}
\ No newline at end of file
+}
+
+/**
+ * Start an asynchronous operation for the application. Staged writes are
+ * programmed first so they keep their order, and the range is dropped from
+ * the read cache as it changes under it until the operation is done.
+ *
+ * @param uint8_t command				FLASH_CMD_PROGRAM, or FLASH_CMD_SECTOR_ERASE for any erase.
+ * @param size_t offset					Address of the first instruction.
+ * @param size_t length					Bytes to erase / program.
+ * @param uint8_t *buf					Data to program, or NULL.
+ * @param extFlashCallback_t cb			Completion callback.
+ *
+ * @return bool
+ */
+static bool EXTFLASH_asyncBegin(uint8_t command, size_t offset, size_t length, const uint8_t *buf, extFlashCallback_t cb)
+{
+	bool returnValue = false;
+	
+	// Take the Bus
+	EXTFLASH_lock();
+	
+	// Flush the Stage, then start the Operation
+	if (!EXTFLASH_isBusy() && EXTFLASH_flushStage())
+	{
+#if FLASH_POWER_DOWN_MS > 0
+		// The Operation goes to the Bus without waking the Device
+		if (powerOp.down)
+		{
+			EXTFLASH_wake();
+		}
+#endif
+		EXTFLASH_cacheDrop(offset, length);
+		returnValue = EXTFLASH_asyncStart(command, offset, length, buf, cb);
+	}
+	
+	// Release the Bus
+	EXTFLASH_unlock();
+	
+	// Return
+	return returnValue;
+}
+
+#if FLASH_WRITE_COMBINE && FLASH_WRITE_FLUSH_MS > 0
+/**
+ * Completion of an auto flush.
+ *
+ * @param extFlashResult_t result		Result of the program.
+ *
+ * @return void
+ */
+static void EXTFLASH_autoFlushDone(extFlashResult_t result)
+{
+	size_t offset = stage.page * FLASH_PROGRAM_PAGE_SIZE + stage.start;
+	size_t length = stage.end - stage.start;
+	
+	// The cache already holds the data, unless the program failed
+	if (result != EXTFLASH_OK)
+	{
+		EXTFLASH_cacheDrop(offset, length);
+	}
+	
+	// Empty the Stage
+	stage.start = 0;
+	stage.end = 0;
+}
+
+/**
+ * Timer task that programs the stage in the background once it has waited
+ * FLASH_WRITE_FLUSH_MS. A blocking call or another operation on the bus
+ * puts it off for another period.
+ *
+ * @return void
+ */
+static void EXTFLASH_autoFlush_cb(const struct timer_task *const timer_task)
+{
+	flushArmed = false;
+	
+	// Already flushed
+	if (stage.end == stage.start)
+	{
+		return;
+	}
+	
+	// Try again later
+	if (locked || EXTFLASH_isBusy())
+	{
+		flushArmed = true;
+		timer_add_task(&TIMER, &flushTask);
+		return;
+	}
+	
+	// Program the Stage, it stays untouched as blocking calls fail until the end
+	EXTFLASH_asyncStart(FLASH_CMD_PROGRAM, stage.page * FLASH_PROGRAM_PAGE_SIZE + stage.start, stage.end - stage.start, &stage.data[stage.start], EXTFLASH_autoFlushDone);
+}
+#endif
+
+/**
+ * Start an erase of every sector touched by the given range, using the
+ * largest block erase that fits at each step. The function
+ * returns straight away, {cb} is called from interrupt context when the last
+ * sector is erased, or on a failure.
+ *
+ * @param size_t offset					The byte offset in flash to begin erasing from.
+ * @param size_t length					The number of bytes to erase.
+ * @param extFlashCallback_t cb			Completion callback.
+ *
+ * @return bool							false if another operation is running
+ */
+bool EXTFLASH_erase_async(size_t offset, size_t length, extFlashCallback_t cb)
+{
+	// Nothing to Erase
+	if (length == 0)
+	{
+		return false;
+	}
+	
+	// Round out to the smallest Erase of the Device
+	size_t sector = pFlashInfo->eraseTypes[0].size;
+	size_t first = offset / sector;
+	size_t last = (offset + length - 1) / sector;
+	
+	// Start the Erase
+	return EXTFLASH_asyncBegin(FLASH_CMD_SECTOR_ERASE, first * sector, (last - first + 1) * sector, NULL, cb);
+}
+
+/**
+ * Start programming the given data. The function returns straight away, {cb}
+ * is called from interrupt context when the last page is programmed, or on a
+ * failure.
+ *
+ * @param size_t offset					The byte offset in flash to begin writing to.
+ * @param size_t length					The number of bytes to write.
+ * @param uint8_t *buf					The data to write, it must stay valid until {cb} is called.
+ * @param extFlashCallback_t cb			Completion callback.
+ *
+ * @return bool							false if another operation is running
+ */
+bool EXTFLASH_write_async(size_t offset, size_t length, const uint8_t *buf, extFlashCallback_t cb)
+{
+	return EXTFLASH_asyncBegin(FLASH_CMD_PROGRAM, offset, length, buf, cb);
+}
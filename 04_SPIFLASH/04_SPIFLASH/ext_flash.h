@@ -9,13 +9,32 @@
 #include "driver_init.h"
 #include "string.h"
 
+// SPI Clock and DMA Channels of the EXTFLASH SERCOM
+#include <hpl_sercom_config.h>
+#include <peripheral_clk_config.h>
+
+// SPI Bus Manager, the EXTFLASH shares its SERCOM through it
+#include "spi_bus.h"
+
+// CRC Routines for EXTFLASH_crc16
+#include "crc.h"
+
 // Instruction Codes
 #define FLASH_CMD_MDID				0x9F	// Manufacturer Device ID
 #define FLASH_CMD_READ_STATUS		0x05	// Read Status Register
 #define FLASH_CMD_PROGRAM			0x02	// Page Program
 #define FLASH_CMD_READ				0x03	// Read Data
+#define FLASH_CMD_FAST_READ			0x0B	// Fast Read (one dummy byte)
 #define FLASH_CMD_WRITE_ENABLE		0x06	// Write Enable
-#define FLASH_CMD_SECTOR_ERASE		0x20	// Sector Erase
+#define FLASH_CMD_SECTOR_ERASE		0x20	// Sector Erase (4K)
+#define FLASH_CMD_BLOCK_ERASE_32K	0x52	// Block Erase (32K)
+#define FLASH_CMD_BLOCK_ERASE_64K	0xD8	// Block Erase (64K)
+#define FLASH_CMD_CHIP_ERASE		0x60	// Chip Erase
+#define FLASH_CMD_READ_SFDP			0x5A	// Read SFDP Tables (one dummy byte)
+#define FLASH_CMD_DEEP_POWER_DOWN	0xB9	// Deep Power-Down
+#define FLASH_CMD_RESUME			0xAB	// Resume from Deep Power-Down
+#define FLASH_CMD_SUSPEND			0xB0	// Program / Erase Suspend (Adesto)
+#define FLASH_CMD_SUSPEND_RESUME	0xD0	// Program / Erase Resume (Adesto)
 
 // Bitmask of the Status Register
 #define FLASH_STATUS_BIT_BUSY		0x1		// Busy Bit of Status Register
@@ -23,21 +42,111 @@
 // Part Specific Constants
 #define FLASH_PROGRAM_PAGE_SIZE		0x100	// 256 bytes
 #define FLASH_ERASE_SECTOR_SIZE		0x1000	// 4096 bytes
+#define FLASH_ERASE_BLOCK_32K_SIZE	0x8000	// 32768 bytes
+#define FLASH_ERASE_BLOCK_64K_SIZE	0x10000	// 65536 bytes
 #define FLASH_MAX_COMMAND_SIZE		0x5		// Allow 5 bytes for a command
+#define FLASH_READ_MAX_FREQUENCY	33000000	// Highest SPI clock for Read Data (0x03)
+#define FLASH_TIMEOUT_PROGRAM_MS	5		// Page program time limit
+#define FLASH_TIMEOUT_ERASE_MS		400		// Sector erase time limit
+#define FLASH_TIMEOUT_ERASE_32K_MS	1000	// 32K block erase time limit
+#define FLASH_TIMEOUT_ERASE_64K_MS	1600	// 64K block erase time limit
+#define FLASH_TIMEOUT_CHIP_ERASE_MS	30000	// Chip erase time limit
+#define FLASH_POLL_INTERVAL_MS		1		// Status poll period of the asynchronous operations
+#define FLASH_RESUME_US				30		// Resume from deep power-down time (tRDPD)
+#define FLASH_SUSPEND_LATENCY_US	30		// Program / erase suspend time (tSUSP)
+#define FLASH_SUSPEND_INTERVAL_US	500		// Run time after a resume before the next suspend
+
+// SFDP Constants (JESD216)
+#define FLASH_SFDP_SIGNATURE		0x50444653	// "SFDP"
+#define FLASH_SFDP_BFPT_ID			0x00	// ID of the JEDEC Basic Flash Parameter Table
+#define FLASH_SFDP_BFPT_DWORDS		16		// Table DWORDs used
+#define FLASH_MAX_ADDRESSABLE_SIZE	0x1000000	// Reach of 24-bit addressing
+#define FLASH_ERASE_TYPES			4		// Erase instructions described per device
+#define FLASH_SFDP_NO_SUSPEND		0x80000000	// DWORD 12, program / erase suspend not supported
+
+// SPI Bus Constants
+#define FLASH_SPI_FREQUENCY			CONF_SERCOM_5_SPI_BAUD	// SPI clock in Hz
+#define FLASH_MAX_TRANSFER_SIZE		0xFFFF	// Largest single DMA transfer
+
+// Read Cache Size in Pages of FLASH_PROGRAM_PAGE_SIZE bytes (0 to disable)
+#ifndef FLASH_CACHE_PAGES
+#define FLASH_CACHE_PAGES			8		// 2 Kbytes of SRAM
+#endif
+
+// Write Combining of small sequential EXTFLASH_write calls (0 to disable)
+#ifndef FLASH_WRITE_COMBINE
+#define FLASH_WRITE_COMBINE			1
+#endif
+
+// Staged data is flushed this long after it was written (0 for EXTFLASH_flush only)
+#ifndef FLASH_WRITE_FLUSH_MS
+#define FLASH_WRITE_FLUSH_MS		20
+#endif
+
+// Deep power-down is entered once the device has been idle this long (0 to stay in standby)
+#ifndef FLASH_POWER_DOWN_MS
+#define FLASH_POWER_DOWN_MS			50
+#endif
 
 // Manufacturer DID
 #define MF_ADESTO					0x1F
 
+// Erase Instruction of a Memory Device
+typedef struct
+{
+	uint32_t size;							// Bytes erased, 0 if not supported
+	uint32_t timeout;						// Time limit in milliseconds
+	uint8_t command;
+} extFlashEraseType_t;
+
 // Structure for the Memory Device
 typedef struct 
 {
 	uint32_t deviceSize;
 	uint8_t manuID;
 	uint8_t devID;
+	uint16_t pageSize;						// Page program size
+	uint32_t programTimeout;				// Page program time limit in milliseconds
+	uint32_t chipEraseTimeout;				// Chip erase time limit in milliseconds
+	extFlashEraseType_t eraseTypes[FLASH_ERASE_TYPES];	// Smallest first
+	uint8_t dualReadCommand;				// Dual Output Fast Read (1-1-2), 0 if not supported
+	uint8_t dualReadDummy;					// Dummy clocks of the Dual Output Fast Read
+	uint8_t suspendCommand;					// Program / Erase Suspend, 0 if not supported
+	uint8_t resumeCommand;					// Program / Erase Resume
+	uint16_t suspendLatency;				// Time for a suspend to take effect in microseconds
+	uint16_t suspendInterval;				// Least run time between a resume and the next suspend in microseconds
+	bool sfdp;								// Parameters read from the SFDP tables
 } extFlashInfo_t;
 
+// Result of an Asynchronous Operation
+typedef enum
+{
+	EXTFLASH_OK = 0,
+	EXTFLASH_ERROR,			// SPI transfer could not be started
+	EXTFLASH_TIMEOUT		// Device stayed busy for too long
+} extFlashResult_t;
+
+// Read Cache Counters (one lookup per page touched by a read)
+typedef struct
+{
+	uint32_t hits;
+	uint32_t misses;
+} extFlashCacheStats_t;
+
+// Deep Power-Down Counters
+typedef struct
+{
+	uint32_t powerDowns;					// Times the device was powered down
+	uint32_t wakes;							// Times an access resumed it
+	uint32_t downMs;						// Time spent powered down
+} extFlashPowerStats_t;
+
+// Completion Callback of an Asynchronous Operation
+typedef void (*extFlashCallback_t)(extFlashResult_t result);
+
 // IO Descriptor for EXTFLASH SPI Comms
-struct io_descriptor *extflash_io;
+extern struct io_descriptor *extflash_io;
+extern spiBus_t extflash_bus;
 
 // Function for Initialising SPI on ExtFlash
 void EXTFLASH_init(void);
@@ -45,8 +154,26 @@ void EXTFLASH_init(void);
 // ExtFlash Methods
 extern void EXTFLASH_setup(void);
 extern bool EXTFLASH_open(void);
+extern const extFlashInfo_t *EXTFLASH_getInfo(void);
 extern bool EXTFLASH_read(size_t offset, size_t length, uint8_t *buf);
+extern bool EXTFLASH_read_uncached(size_t offset, size_t length, uint8_t *buf);
 extern bool EXTFLASH_write(size_t offset, size_t length, const uint8_t *buf);
 extern bool EXTFLASH_erase(size_t offset, size_t length);
+extern bool EXTFLASH_flush(void);
+extern bool EXTFLASH_crc16(size_t offset, size_t length, uint16_t *crc);
+
+// Read Cache Methods
+extern void EXTFLASH_cacheInvalidate(void);
+extern void EXTFLASH_cacheStats(extFlashCacheStats_t *stats);
+extern void EXTFLASH_cacheClearStats(void);
+
+// Deep Power-Down Methods
+extern void EXTFLASH_powerStats(extFlashPowerStats_t *stats);
+extern void EXTFLASH_powerClearStats(void);
+
+// Asynchronous ExtFlash Methods (status polls run on TIMER)
+extern bool EXTFLASH_isBusy(void);
+extern bool EXTFLASH_erase_async(size_t offset, size_t length, extFlashCallback_t cb);
+extern bool EXTFLASH_write_async(size_t offset, size_t length, const uint8_t *buf, extFlashCallback_t cb);
 
 #endif
\ No newline at end of file
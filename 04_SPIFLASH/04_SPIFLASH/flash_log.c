@@ -0,0 +1,364 @@
+// Include Record Log Header File
+#include "flash_log.h"
+
+// Sector Index Value for a Sector not in the Log
+#define FLASHLOG_SECTOR_FREE		0xFFFFFFFF
+
+// In-RAM Index of the Sector Heads (sequence number of every sector)
+static uint32_t sectorSeq[FLASHLOG_SECTOR_COUNT];
+
+// Sector being Appended to and its next free Slot
+static uint16_t headSector;
+static uint16_t headSlot;
+
+// Sequence Number of the next Record
+static uint32_t nextSeq;
+
+// Set once the Index has been built
+static bool mounted = false;
+
+/**
+ * Flash address of a slot in the log area.
+ *
+ * @param uint16_t sector				Sector within the log.
+ * @param uint16_t slot					Slot within the sector.
+ *
+ * @return size_t
+ */
+static size_t FLASHLOG_address(uint16_t sector, uint16_t slot)
+{
+	return (size_t)(FLASHLOG_FIRST_SECTOR + sector) * FLASH_ERASE_SECTOR_SIZE + (size_t)slot * FLASHLOG_SLOT_SIZE;
+}
+
+/**
+ * CRC of a record, covering its sequence number, length and data.
+ *
+ * @param flashLogRecordHeader_t *header	Record header.
+ * @param uint8_t *data						Record data.
+ *
+ * @return uint16_t
+ */
+static uint16_t FLASHLOG_recordCrc(const flashLogRecordHeader_t *header, const uint8_t *data)
+{
+	// seq and length sit next to each other in front of crc
+	uint16_t crc = CRC_crc16(CRC16_INIT, header, offsetof(flashLogRecordHeader_t, crc));
+	
+	return CRC_crc16(crc, data, header->length);
+}
+
+/**
+ * Check whether a record header has never been programmed.
+ *
+ * @param flashLogRecordHeader_t *header	Record header.
+ *
+ * @return bool
+ */
+static bool FLASHLOG_isBlank(const flashLogRecordHeader_t *header)
+{
+	return (header->seq == 0xFFFFFFFF && header->length == 0xFFFF && header->crc == 0xFFFF);
+}
+
+/**
+ * Erase a sector and make it the head of the log. Its records, the oldest in
+ * the rotation, are dropped.
+ *
+ * @param uint16_t sector				Sector within the log.
+ * @param uint32_t seq					Sequence number of the sector.
+ *
+ * @return bool
+ */
+static bool FLASHLOG_takeSector(uint16_t sector, uint32_t seq)
+{
+	// Sector Header
+	flashLogSectorHeader_t header;
+	
+	// The sector leaves the index until its new header is written
+	sectorSeq[sector] = FLASHLOG_SECTOR_FREE;
+	
+	// Erase the Sector
+	if (!EXTFLASH_erase(FLASHLOG_address(sector, 0), FLASH_ERASE_SECTOR_SIZE))
+	{
+		return false;
+	}
+	
+	// Write the Sector Header
+	header.magic = FLASHLOG_MAGIC;
+	header.seq = seq;
+	header.seqInv = ~seq;
+	if (!EXTFLASH_write(FLASHLOG_address(sector, 0), sizeof(header), (const uint8_t *)&header))
+	{
+		return false;
+	}
+	
+	// Move the Head
+	sectorSeq[sector] = seq;
+	headSector = sector;
+	headSlot = 1;
+	
+	// Return TRUE
+	return true;
+}
+
+/**
+ * Build the sector index from the flash and find the end of the log. A record
+ * torn by a power failure fails its CRC and is skipped, the blank slots after
+ * it are used as normal.
+ *
+ * @return bool
+ */
+bool FLASHLOG_mount(void)
+{
+	// Headers for the Scan
+	flashLogSectorHeader_t sectorHeader;
+	flashLogRecordHeader_t recordHeader;
+	flashLogRecord_t record;
+	uint16_t sector;
+	uint32_t back;
+	bool found = false;
+	
+	// Not Mounted until the Index is complete
+	mounted = false;
+	
+	// Read every Sector Header into the Index, past the read cache as each is read once
+	for (sector = 0; sector < FLASHLOG_SECTOR_COUNT; sector++)
+	{
+		if (!EXTFLASH_read_uncached(FLASHLOG_address(sector, 0), sizeof(sectorHeader), (uint8_t *)&sectorHeader))
+		{
+			return false;
+		}
+		
+		// Blank or torn headers mark free sectors
+		if (sectorHeader.magic != FLASHLOG_MAGIC || sectorHeader.seqInv != ~sectorHeader.seq)
+		{
+			sectorSeq[sector] = FLASHLOG_SECTOR_FREE;
+			continue;
+		}
+		
+		// The newest Sector is the Head
+		sectorSeq[sector] = sectorHeader.seq;
+		if (!found || (int32_t)(sectorHeader.seq - sectorSeq[headSector]) > 0)
+		{
+			headSector = sector;
+			found = true;
+		}
+	}
+	
+	// Empty Log, start in the first Sector
+	if (!found)
+	{
+		nextSeq = 1;
+		mounted = FLASHLOG_takeSector(0, 1);
+		return mounted;
+	}
+	
+	// Records are appended in order, so search for the first blank Slot
+	uint16_t lo = 1;
+	uint16_t hi = FLASHLOG_SLOTS_PER_SECTOR;
+	while (lo < hi)
+	{
+		uint16_t mid = (lo + hi) / 2;
+		
+		if (!EXTFLASH_read_uncached(FLASHLOG_address(headSector, mid), sizeof(recordHeader), (uint8_t *)&recordHeader))
+		{
+			return false;
+		}
+		
+		if (FLASHLOG_isBlank(&recordHeader))
+		{
+			hi = mid;
+		}
+		else
+		{
+			lo = mid + 1;
+		}
+	}
+	headSlot = lo;
+	mounted = true;
+	
+	// Carry on from the newest intact Record
+	nextSeq = 1;
+	for (back = 0; back < FLASHLOG_RECORDS_PER_SECTOR && back < FLASHLOG_count(); back++)
+	{
+		if (FLASHLOG_read(back, &record))
+		{
+			nextSeq = record.seq + 1;
+			break;
+		}
+	}
+	
+	// Return TRUE
+	return true;
+}
+
+/**
+ * Append a record to the log. When the head sector is full the next sector
+ * in the rotation is erased and taken over, so wear is spread over the whole
+ * log area.
+ *
+ * @param uint8_t *data					Record data.
+ * @param uint16_t length				Number of bytes, at most FLASHLOG_MAX_DATA.
+ *
+ * @return bool
+ */
+bool FLASHLOG_append(const uint8_t *data, uint16_t length)
+{
+	// Slot Image
+	uint8_t slot[FLASHLOG_SLOT_SIZE];
+	flashLogRecordHeader_t header;
+	
+	// Check the Record fits
+	if (!mounted || length > FLASHLOG_MAX_DATA)
+	{
+		return false;
+	}
+	
+	// Head Sector Full, rotate onto the next one
+	if (headSlot >= FLASHLOG_SLOTS_PER_SECTOR)
+	{
+		if (!FLASHLOG_takeSector((headSector + 1) % FLASHLOG_SECTOR_COUNT, sectorSeq[headSector] + 1))
+		{
+			return false;
+		}
+	}
+	
+	// Build the Record
+	header.seq = nextSeq;
+	header.length = length;
+	header.crc = FLASHLOG_recordCrc(&header, data);
+	memcpy(&slot[0], &header, sizeof(header));
+	memcpy(&slot[sizeof(header)], data, length);
+	
+	// The slot is used up even if the write fails, it may be partly programmed
+	size_t address = FLASHLOG_address(headSector, headSlot);
+	headSlot++;
+	nextSeq++;
+	
+	// Program the Record
+	return EXTFLASH_write(address, sizeof(header) + length, slot);
+}
+
+/**
+ * Read a record counting back from the newest one. The sector index gives
+ * its position directly, so this is a single flash read.
+ *
+ * @param uint32_t back					0 for the newest record, 1 for the one before...
+ * @param flashLogRecord_t *record		Where the record is stored.
+ *
+ * @return bool							false if out of range, unreadable or torn
+ */
+bool FLASHLOG_read(uint32_t back, flashLogRecord_t *record)
+{
+	// Slot Image
+	uint8_t slot[FLASHLOG_SLOT_SIZE];
+	flashLogRecordHeader_t header;
+	uint16_t sector = headSector;
+	uint16_t index;
+	
+	if (!mounted)
+	{
+		return false;
+	}
+	
+	// Find the Slot
+	if (back < (uint32_t)(headSlot - 1))
+	{
+		// Record in the Head Sector
+		index = headSlot - 1 - back;
+	}
+	else
+	{
+		// Record in a full older Sector
+		back -= headSlot - 1;
+		uint32_t k = back / FLASHLOG_RECORDS_PER_SECTOR + 1;
+		if (k >= FLASHLOG_SECTOR_COUNT)
+		{
+			return false;
+		}
+		
+		// The sector must still hold the records from k rotations ago
+		sector = (headSector + FLASHLOG_SECTOR_COUNT - k) % FLASHLOG_SECTOR_COUNT;
+		if (sectorSeq[sector] != sectorSeq[headSector] - k)
+		{
+			return false;
+		}
+		index = FLASHLOG_RECORDS_PER_SECTOR - (back % FLASHLOG_RECORDS_PER_SECTOR);
+	}
+	
+	// Read the whole Slot
+	if (!EXTFLASH_read(FLASHLOG_address(sector, index), FLASHLOG_SLOT_SIZE, slot))
+	{
+		return false;
+	}
+	
+	// Check the Record
+	memcpy(&header, &slot[0], sizeof(header));
+	if (header.length > FLASHLOG_MAX_DATA || header.crc != FLASHLOG_recordCrc(&header, &slot[sizeof(header)]))
+	{
+		return false;
+	}
+	
+	// Copy the Record out
+	record->seq = header.seq;
+	record->length = header.length;
+	memcpy(record->data, &slot[sizeof(header)], header.length);
+	
+	// Return TRUE
+	return true;
+}
+
+/**
+ * Read up to {n} of the newest records, newest first. Torn records are
+ * skipped.
+ *
+ * @param flashLogRecord_t *records		Where the records are stored.
+ * @param uint16_t n					Number of records wanted.
+ *
+ * @return uint16_t						Number of records read
+ */
+uint16_t FLASHLOG_readLatest(flashLogRecord_t *records, uint16_t n)
+{
+	uint16_t found = 0;
+	uint32_t count = FLASHLOG_count();
+	uint32_t back;
+	
+	for (back = 0; back < count && found < n; back++)
+	{
+		if (FLASHLOG_read(back, &records[found]))
+		{
+			found++;
+		}
+	}
+	
+	return found;
+}
+
+/**
+ * Number of record slots in the log, including torn records.
+ *
+ * @return uint32_t
+ */
+uint32_t FLASHLOG_count(void)
+{
+	uint32_t count;
+	uint16_t k;
+	
+	if (!mounted)
+	{
+		return 0;
+	}
+	
+	// Head Sector, then every older Sector still in the Rotation
+	count = headSlot - 1;
+	for (k = 1; k < FLASHLOG_SECTOR_COUNT; k++)
+	{
+		uint16_t sector = (headSector + FLASHLOG_SECTOR_COUNT - k) % FLASHLOG_SECTOR_COUNT;
+		
+		if (sectorSeq[sector] != sectorSeq[headSector] - k)
+		{
+			break;
+		}
+		count += FLASHLOG_RECORDS_PER_SECTOR;
+	}
+	
+	return count;
+}
@@ -0,0 +1,55 @@
+#ifndef FLASH_LOG_H_
+#define FLASH_LOG_H_
+
+// Include STD C Libraries
+#include <stdint.h>
+#include <stdbool.h>
+
+// Include the EXT Flash Driver
+#include "ext_flash.h"
+
+// Log Area (whole sectors)
+#define FLASHLOG_FIRST_SECTOR		0		// First sector used by the log
+#define FLASHLOG_SECTOR_COUNT		64		// Sectors in the rotation (256 Kbytes)
+
+// Record Layout
+#define FLASHLOG_SLOT_SIZE			64		// Flash space taken by every record
+#define FLASHLOG_SLOTS_PER_SECTOR	(FLASH_ERASE_SECTOR_SIZE / FLASHLOG_SLOT_SIZE)
+#define FLASHLOG_RECORDS_PER_SECTOR	(FLASHLOG_SLOTS_PER_SECTOR - 1)	// Slot 0 holds the sector header
+#define FLASHLOG_MAX_DATA			(FLASHLOG_SLOT_SIZE - sizeof(flashLogRecordHeader_t))
+
+// Sector Header Magic ("FLOG")
+#define FLASHLOG_MAGIC				0x474F4C46
+
+// Header in front of every Record
+typedef struct
+{
+	uint32_t seq;			// Record sequence number
+	uint16_t length;		// Number of data bytes
+	uint16_t crc;			// CRC-16/CCITT of seq, length and data
+} flashLogRecordHeader_t;
+
+// Header in Slot 0 of every Sector in use
+typedef struct
+{
+	uint32_t magic;			// FLASHLOG_MAGIC
+	uint32_t seq;			// Sector sequence number, one higher for every sector taken
+	uint32_t seqInv;		// ~seq, catches a header torn by a power failure
+} flashLogSectorHeader_t;
+
+// Record as handed to the Application
+typedef struct
+{
+	uint32_t seq;
+	uint16_t length;
+	uint8_t data[FLASHLOG_SLOT_SIZE - sizeof(flashLogRecordHeader_t)];
+} flashLogRecord_t;
+
+// Record Log Methods
+extern bool FLASHLOG_mount(void);
+extern bool FLASHLOG_append(const uint8_t *data, uint16_t length);
+extern bool FLASHLOG_read(uint32_t back, flashLogRecord_t *record);
+extern uint16_t FLASHLOG_readLatest(flashLogRecord_t *records, uint16_t n);
+extern uint32_t FLASHLOG_count(void);
+
+#endif
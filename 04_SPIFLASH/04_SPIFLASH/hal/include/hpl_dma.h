@@ -65,6 +65,19 @@ struct _dma_callbacks {
 	void (*error)(struct _dma_resource *resource);
 };
 
+/**
+ * \brief DMA CRC polynomial types
+ */
+enum _dma_crc_polynomial {
+	DMA_CRC_16, /*!< CRC-16-CCITT (0x1021) */
+	DMA_CRC_32  /*!< CRC-32 (IEEE 802.3) */
+};
+
+/**
+ * \brief DMA CRC source for data written by the CPU instead of a channel
+ */
+#define DMA_CRC_SOURCE_IO -1
+
 /**
  * \brief DMA resource structure
  */
@@ -150,6 +163,44 @@ int32_t _dma_set_data_amount(const uint8_t channel, const uint32_t amount);
  */
 int32_t _dma_enable_transaction(const uint8_t channel, const bool software_trigger);
 
+/**
+ * \brief Abort the transaction on the given channel
+ *
+ * Waits until the channel has finished the beat in progress and reads back
+ * disabled.
+ *
+ * \param[in] channel DMA channel to disable
+ *
+ * \return status of operation
+ */
+int32_t _dma_disable_transaction(const uint8_t channel);
+
+/**
+ * \brief Mark the descriptor of the given channel valid or invalid
+ *
+ * Needed for descriptors which are only reached through
+ * _dma_set_next_descriptor(), as _dma_enable_transaction() only validates the
+ * first descriptor of a channel.
+ *
+ * \param[in] channel DMA channel whose descriptor to mark
+ * \param[in] valid True to mark valid, false to mark invalid
+ *
+ * \return status of operation
+ */
+int32_t _dma_set_descriptor_valid(const uint8_t channel, const bool valid);
+
+/**
+ * \brief Retrieve the progress of the transaction on the given channel
+ *
+ * \param[in] channel DMA channel to query
+ * \param[out] remaining The number of beats left in the current block
+ * \param[out] next_channel The channel whose descriptor follows the current
+ *                          block, or -1 if the current block is the last one
+ *
+ * \return status of operation
+ */
+int32_t _dma_get_transfer_progress(const uint8_t channel, uint32_t *const remaining, int8_t *const next_channel);
+
 /**
  * \brief Retrieves DMA resource structure
  *
@@ -160,6 +211,39 @@ int32_t _dma_enable_transaction(const uint8_t channel, const bool software_trigg
  */
 int32_t _dma_get_channel_resource(struct _dma_resource **resource, const uint8_t channel);
 
+/**
+ * \brief Take the CRC unit and start a checksum
+ *
+ * The unit either checksums every beat moved by a DMA channel, or the data
+ * passed to _dma_crc_write(). Both work on byte beats. For CRC-32 the
+ * checksum reads back bit-reversed and complemented, so the initial value of
+ * a new checksum is 0xFFFFFFFF for either polynomial.
+ *
+ * \param[in] channel DMA channel to checksum, or DMA_CRC_SOURCE_IO
+ * \param[in] polynomial The polynomial to use
+ * \param[in] checksum Initial value of the checksum register
+ *
+ * \return ERR_BUSY if the CRC unit is already in use, ERR_NONE otherwise
+ */
+int32_t _dma_crc_enable(const int8_t channel, const enum _dma_crc_polynomial polynomial, const uint32_t checksum);
+
+/**
+ * \brief Feed data to a checksum started with DMA_CRC_SOURCE_IO
+ *
+ * \param[in] data The data to checksum
+ * \param[in] length The number of bytes
+ */
+void _dma_crc_write(const uint8_t *data, uint32_t length);
+
+/**
+ * \brief Release the CRC unit
+ *
+ * A checksum of a channel is complete once the transfer is done.
+ *
+ * \return The checksum
+ */
+uint32_t _dma_crc_disable(void);
+
 /**
  * \brief Enable/disable DMA interrupt
  *
@@ -45,6 +45,7 @@
 
 #include "hpl_usart.h"
 #include "hpl_irq.h"
+#include "hpl_dma.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -53,7 +54,40 @@ extern "C" {
 /**
  * \brief USART callback types
  */
-enum _usart_async_callback_type { USART_ASYNC_BYTE_SENT, USART_ASYNC_RX_DONE, USART_ASYNC_TX_DONE, USART_ASYNC_ERROR };
+enum _usart_async_callback_type {
+	USART_ASYNC_BYTE_SENT,
+	USART_ASYNC_RX_DONE,
+	USART_ASYNC_TX_DONE,
+	USART_ASYNC_ERROR,
+	USART_ASYNC_RX_START
+};
+
+/**
+ * \brief USART receive error flags
+ */
+enum _usart_async_rx_error {
+	USART_ASYNC_RX_ERROR_OVERFLOW = 0x01,
+	USART_ASYNC_RX_ERROR_FRAME    = 0x02,
+	USART_ASYNC_RX_ERROR_PARITY   = 0x04
+};
+
+/**
+ * \brief USART baud rate generator setting
+ */
+struct usart_baud_setting {
+	/** Arithmetic or fractional baud rate generation */
+	enum usart_baud_rate_mode mode;
+	/** Samples per bit: 16, 8 or 3 */
+	uint8_t samples;
+	/** Fractional part of the BAUD value in 1/8 steps */
+	uint8_t fraction;
+	/** BAUD register value, integer part only in fractional mode */
+	uint16_t baud;
+	/** Baud rate the setting gives */
+	uint32_t actual;
+	/** Deviation of the actual from the requested baud rate, in ppm */
+	int32_t error;
+};
 
 /**
  * \brief USART device structure
@@ -70,6 +104,10 @@ struct _usart_async_callbacks {
 	void (*rx_done_cb)(struct _usart_async_device *device, uint8_t data);
 	void (*tx_done_cb)(struct _usart_async_device *device);
 	void (*error_cb)(struct _usart_async_device *device);
+	void (*rx_error_cb)(struct _usart_async_device *device, uint8_t errors);
+	void (*rx_dma_block_cb)(struct _usart_async_device *device);
+	void (*tx_dma_done_cb)(struct _usart_async_device *device);
+	void (*rx_start_cb)(struct _usart_async_device *device);
 };
 
 /**
@@ -79,6 +117,8 @@ struct _usart_async_device {
 	struct _usart_async_callbacks usart_cb;
 	struct _irq_descriptor        irq;
 	void *                        hw;
+	struct _dma_resource *        dma_tx;
+	struct _dma_resource *        dma_rx;
 };
 /**
  * \name HPL functions
@@ -145,6 +185,31 @@ uint16_t _usart_async_calculate_baud_rate(const uint32_t baud, const uint32_t cl
  */
 void _usart_async_set_baud_rate(struct _usart_async_device *const device, const uint32_t baud_rate);
 
+/**
+ * \brief Find the baud rate generator setting closest to a baud rate
+ *
+ * \param[in] baud Required baud rate
+ * \param[in] clock_rate SERCOM core clock frequency
+ * \param[out] setting The best setting found
+ *
+ * \return ERR_NONE if a setting was found, ERR_INVALID_ARG if the baud rate
+ * cannot be generated from the clock
+ */
+int32_t _usart_async_solve_baud_rate(const uint32_t baud, const uint32_t clock_rate,
+                                     struct usart_baud_setting *const setting);
+
+/**
+ * \brief Apply a baud rate generator setting
+ *
+ * Sample rate and BAUD register are changed together with the module
+ * disabled for a moment.
+ *
+ * \param[in] device The pointer to USART device instance
+ * \param[in] setting The setting to apply
+ */
+void _usart_async_set_baud_setting(struct _usart_async_device *const        device,
+                                   const struct usart_baud_setting *const setting);
+
 /**
  * \brief Set data order
  *
@@ -243,6 +308,55 @@ void _usart_async_enable_byte_sent_irq(struct _usart_async_device *const device)
  */
 void _usart_async_enable_tx_done_irq(struct _usart_async_device *const device);
 
+/**
+ * \brief Transmit a buffer through the DMAC
+ *
+ * tx_dma_done_cb is called once the DMAC has moved the whole buffer, the
+ * buffer may then be reused while the last character is still being shifted
+ * out. Without tx_dma_done_cb the transmission complete interrupt is enabled
+ * instead, so tx_done_cb is called once per buffer.
+ *
+ * \param[in] device The pointer to USART device instance
+ * \param[in] buf The data to transmit, must stay valid until tx_dma_done_cb
+ * \param[in] length The number of bytes to transmit
+ *
+ * \return The status of DMA transmission start.
+ * \retval ERR_UNSUPPORTED_OP No DMAC channel is configured for this USART
+ */
+int32_t _usart_async_dma_write(struct _usart_async_device *const device, const uint8_t *const buf,
+                               const uint16_t length);
+
+/**
+ * \brief Start circular reception through the DMAC
+ *
+ * The buffer is split in two halves, each described by its own DMA
+ * descriptor, and the descriptors are linked into a ring. rx_dma_block_cb is
+ * called whenever a half has been filled. The receive complete interrupt is
+ * not used while DMA reception is active. Start of frame detection is enabled,
+ * so the USART_ASYNC_RX_START interrupt can report a character arriving; it
+ * calls rx_start_cb once and disables itself.
+ *
+ * \param[in] device The pointer to USART device instance
+ * \param[in] buf The receive buffer
+ * \param[in] length The size of the receive buffer, must be even
+ *
+ * \return The status of DMA reception start.
+ * \retval ERR_UNSUPPORTED_OP No DMAC channel is configured for this USART
+ */
+int32_t _usart_async_dma_rx_start(struct _usart_async_device *const device, uint8_t *const buf,
+                                  const uint16_t length);
+
+/**
+ * \brief Retrieve the DMA receive position
+ *
+ * \param[in] device The pointer to USART device instance
+ * \param[in] length The size of the receive buffer given to
+ *                   _usart_async_dma_rx_start()
+ *
+ * \return The offset in the receive buffer the next byte will be stored at
+ */
+uint16_t _usart_async_dma_rx_get_position(const struct _usart_async_device *const device, const uint16_t length);
+
 /**
  * \brief Retrieve ordinal number of the given USART hardware instance
  *
@@ -0,0 +1,279 @@
+/**
+ * \file
+ *
+ * \brief I/O SPI related functionality implementation.
+ *
+ * Copyright (c) 2016-2018 Microchip Technology Inc. and its subsidiaries.
+ *
+ * \asf_license_start
+ *
+ * \page License
+ *
+ * Subject to your compliance with these terms, you may use Microchip
+ * software and any derivatives exclusively with Microchip products.
+ * It is your responsibility to comply with third party license terms applicable
+ * to your use of third party software (including open source software) that
+ * may accompany Microchip software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES,
+ * WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE,
+ * INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY,
+ * AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL MICROCHIP BE
+ * LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR CONSEQUENTIAL
+ * LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO THE
+ * SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE
+ * POSSIBILITY OR THE DAMAGES ARE FORESEEABLE.  TO THE FULLEST EXTENT
+ * ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN ANY WAY
+ * RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+ * THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+ *
+ * \asf_license_stop
+ *
+ */
+
+#include "hal_atomic.h"
+#include "hal_spi_m_dma.h"
+#include <utils_assert.h>
+#include <utils.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Driver version
+ */
+#define SPI_DRIVER_VERSION 0x00000001u
+
+static int32_t _spi_m_dma_io_write(struct io_descriptor *const io, const uint8_t *const buf, const uint16_t length);
+static int32_t _spi_m_dma_io_read(struct io_descriptor *const io, uint8_t *const buf, const uint16_t length);
+
+/**
+ *  \brief Callback for RX, the end of the whole transfer
+ *  \param[in] resource Pointer to the DMA resource of the receive channel.
+ */
+static void _spi_dev_rx(struct _dma_resource *resource)
+{
+	struct _spi_m_dma_dev *      dev = (struct _spi_m_dma_dev *)resource->back;
+	struct spi_m_dma_descriptor *spi = CONTAINER_OF(dev, struct spi_m_dma_descriptor, dev);
+
+	spi->xfercnt = spi->size;
+	spi->stat    = SPI_M_DMA_STATUS_COMPLETE;
+
+	if (spi->callbacks.cb_xfer) {
+		spi->callbacks.cb_xfer(spi);
+	}
+}
+
+/**
+ *  \brief Callback for error
+ *  \param[in] resource Pointer to the DMA resource of the failing channel.
+ */
+static void _spi_dev_error(struct _dma_resource *resource)
+{
+	struct _spi_m_dma_dev *      dev = (struct _spi_m_dma_dev *)resource->back;
+	struct spi_m_dma_descriptor *spi = CONTAINER_OF(dev, struct spi_m_dma_descriptor, dev);
+
+	/* Stop the other channel too, the transfer cannot complete */
+	_spi_m_dma_disable(dev);
+	_spi_m_dma_enable(dev);
+	spi->stat = SPI_M_DMA_STATUS_ERR_IO;
+
+	if (spi->callbacks.cb_error) {
+		spi->callbacks.cb_error(spi, ERR_IO);
+	}
+}
+
+int32_t spi_m_dma_init(struct spi_m_dma_descriptor *spi, void *const hw)
+{
+	int32_t rc;
+
+	ASSERT(spi && hw);
+	spi->dev.prvt = (void *)hw;
+	rc            = _spi_m_dma_init(&spi->dev, hw);
+
+	if (rc < 0) {
+		return rc;
+	}
+
+	spi->stat               = 0;
+	spi->size               = 0;
+	spi->xfercnt            = 0;
+	spi->callbacks.cb_xfer  = NULL;
+	spi->callbacks.cb_error = NULL;
+	_spi_m_dma_register_callback(&spi->dev, SPI_DEV_CB_DMA_RX, _spi_dev_rx);
+	_spi_m_dma_register_callback(&spi->dev, SPI_DEV_CB_DMA_ERROR, _spi_dev_error);
+
+	spi->io.read  = _spi_m_dma_io_read;
+	spi->io.write = _spi_m_dma_io_write;
+
+	return ERR_NONE;
+}
+
+void spi_m_dma_deinit(struct spi_m_dma_descriptor *spi)
+{
+	ASSERT(spi);
+	_spi_m_dma_deinit(&spi->dev);
+	spi->callbacks.cb_error = NULL;
+	spi->callbacks.cb_xfer  = NULL;
+	spi->stat               = 0;
+}
+
+void spi_m_dma_enable(struct spi_m_dma_descriptor *spi)
+{
+	ASSERT(spi);
+	_spi_m_dma_enable(&spi->dev);
+}
+
+void spi_m_dma_disable(struct spi_m_dma_descriptor *spi)
+{
+	ASSERT(spi);
+	_spi_m_dma_disable(&spi->dev);
+	spi->stat = 0;
+}
+
+int32_t spi_m_dma_set_baudrate(struct spi_m_dma_descriptor *spi, const uint32_t baud_val)
+{
+	ASSERT(spi);
+
+	if (spi->stat & SPI_M_DMA_STATUS_BUSY) {
+		return ERR_BUSY;
+	}
+	return _spi_m_dma_set_baudrate(&spi->dev, baud_val);
+}
+
+int32_t spi_m_dma_set_mode(struct spi_m_dma_descriptor *spi, const enum spi_transfer_mode mode)
+{
+	ASSERT(spi);
+
+	if (spi->stat & SPI_M_DMA_STATUS_BUSY) {
+		return ERR_BUSY;
+	}
+	return _spi_m_dma_set_mode(&spi->dev, mode);
+}
+
+int32_t spi_m_dma_set_char_size(struct spi_m_dma_descriptor *spi, const enum spi_char_size char_size)
+{
+	ASSERT(spi);
+
+	if (spi->stat & SPI_M_DMA_STATUS_BUSY) {
+		return ERR_BUSY;
+	}
+	return _spi_m_dma_set_char_size(&spi->dev, char_size);
+}
+
+int32_t spi_m_dma_set_data_order(struct spi_m_dma_descriptor *spi, const enum spi_data_order dord)
+{
+	ASSERT(spi);
+
+	if (spi->stat & SPI_M_DMA_STATUS_BUSY) {
+		return ERR_BUSY;
+	}
+	return _spi_m_dma_set_data_order(&spi->dev, dord);
+}
+
+/** \brief Do SPI read in background with DMA
+ *  Clock out the dummy byte and store what comes back.
+ *
+ *  \param[in, out] io Pointer to the I/O descriptor of the SPI instance.
+ *  \param[out] buf Pointer to the buffer to store read data.
+ *  \param[in] length Size of the data in number of characters.
+ *
+ *  \return ERR_NONE on success, or an error code on failure.
+ *  \retval ERR_NONE Success, transfer started.
+ *  \retval ERR_BUSY Busy.
+ */
+static int32_t _spi_m_dma_io_read(struct io_descriptor *io, uint8_t *const buf, const uint16_t length)
+{
+	ASSERT(io);
+	struct spi_m_dma_descriptor *spi = CONTAINER_OF(io, struct spi_m_dma_descriptor, io);
+
+	return spi_m_dma_transfer(spi, NULL, buf, length);
+}
+
+/** \brief Do SPI data write in background with DMA
+ *  The data read back is discarded.
+ *
+ *  \param[in, out] io Pointer to the I/O descriptor of the SPI instance.
+ *  \param[in] buf Pointer to the buffer to store data to write.
+ *  \param[in] length Size of the data in number of characters.
+ *
+ *  \return ERR_NONE on success, or an error code on failure.
+ *  \retval ERR_NONE Success, transfer started.
+ *  \retval ERR_BUSY Busy.
+ */
+static int32_t _spi_m_dma_io_write(struct io_descriptor *io, const uint8_t *const buf, const uint16_t length)
+{
+	ASSERT(io);
+	struct spi_m_dma_descriptor *spi = CONTAINER_OF(io, struct spi_m_dma_descriptor, io);
+
+	return spi_m_dma_transfer(spi, buf, NULL, length);
+}
+
+int32_t spi_m_dma_transfer(struct spi_m_dma_descriptor *spi, uint8_t const *txbuf, uint8_t *const rxbuf,
+                           const uint16_t length)
+{
+	bool busy;
+
+	ASSERT(spi && length);
+
+	CRITICAL_SECTION_ENTER()
+	busy = spi->stat & SPI_M_DMA_STATUS_BUSY;
+	if (!busy) {
+		spi->stat = SPI_M_DMA_STATUS_BUSY;
+	}
+	CRITICAL_SECTION_LEAVE()
+
+	if (busy) {
+		return ERR_BUSY;
+	}
+
+	spi->size    = length;
+	spi->xfercnt = 0;
+
+	return _spi_m_dma_transfer(&spi->dev, txbuf, rxbuf, length);
+}
+
+int32_t spi_m_dma_get_status(struct spi_m_dma_descriptor *spi, struct spi_m_dma_status *p_stat)
+{
+	/* Get a copy of status to avoid critical issue */
+	volatile uint32_t stat = spi->stat;
+
+	if (p_stat) {
+		p_stat->flags   = stat;
+		p_stat->xfercnt = spi->xfercnt;
+	}
+
+	if (stat & SPI_M_DMA_STATUS_BUSY) {
+		return ERR_BUSY;
+	}
+
+	return ERR_NONE;
+}
+
+void spi_m_dma_register_callback(struct spi_m_dma_descriptor *spi, const enum spi_m_dma_cb_type type, FUNC_PTR func)
+{
+	ASSERT(spi && (type < SPI_M_DMA_CB_N));
+
+	if (SPI_M_DMA_CB_XFER == type) {
+		spi->callbacks.cb_xfer = (spi_m_dma_cb_xfer_t)func;
+	} else {
+		spi->callbacks.cb_error = (spi_m_dma_cb_error_t)func;
+	}
+}
+
+int32_t spi_m_dma_get_io_descriptor(struct spi_m_dma_descriptor *const spi, struct io_descriptor **io)
+{
+	ASSERT(spi && io);
+	*io = &spi->io;
+	return 0;
+}
+
+uint32_t spi_m_dma_get_version(void)
+{
+	return SPI_DRIVER_VERSION;
+}
+
+#ifdef __cplusplus
+}
+#endif
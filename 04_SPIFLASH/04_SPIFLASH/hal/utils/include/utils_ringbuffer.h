@@ -46,14 +46,30 @@ extern "C" {
 #include "compiler.h"
 #include "utils_assert.h"
 
+/**
+ * \brief Ring buffer full strategy
+ */
+enum ringbuffer_overflow_policy {
+	/** New data overwrites the oldest data in the buffer */
+	RINGBUFFER_OVERWRITE_OLDEST,
+	/** New data is dropped when the buffer is full */
+	RINGBUFFER_REJECT_NEWEST,
+	/** New data is refused when the buffer is full, the producer is expected
+	 *  to hold it back until space is available */
+	RINGBUFFER_BLOCK
+};
+
 /**
  * \brief Ring buffer element type
  */
 struct ringbuffer {
-	uint8_t *buf;         /** Buffer base address */
-	uint32_t size;        /** Buffer size */
-	uint32_t read_index;  /** Buffer read index */
-	uint32_t write_index; /** Buffer write index */
+	uint8_t *                       buf;         /** Buffer base address */
+	uint32_t                        size;        /** Buffer size */
+	uint32_t                        read_index;  /** Buffer read index */
+	uint32_t                        write_index; /** Buffer write index */
+	uint32_t                        overflows;   /** Number of bytes lost on buffer full */
+	uint32_t                        high_water;  /** Highest number of elements seen */
+	enum ringbuffer_overflow_policy policy;      /** Buffer full strategy */
 };
 
 /**
@@ -67,6 +83,18 @@ struct ringbuffer {
  */
 int32_t ringbuffer_init(struct ringbuffer *const rb, void *buf, uint32_t size);
 
+/**
+ * \brief Set the buffer full strategy of ring buffer
+ *
+ * The default strategy after ringbuffer_init() is RINGBUFFER_OVERWRITE_OLDEST.
+ *
+ * \param[in] rb The pointer to a ring buffer structure instance
+ * \param[in] policy The buffer full strategy
+ *
+ * \return ERR_NONE on success, or an error code on failure.
+ */
+int32_t ringbuffer_set_policy(struct ringbuffer *const rb, const enum ringbuffer_overflow_policy policy);
+
 /**
  * \brief Get one byte from ring buffer, the user needs to handle the concurrent
  * access on buffer via put/get/flush
@@ -86,9 +114,105 @@ int32_t ringbuffer_get(struct ringbuffer *const rb, uint8_t *data);
  * \param[in] data One byte data to be put into ring buffer
  *
  * \return ERR_NONE on success, or an error code on failure.
+ * \retval ERR_OVERFLOW The buffer is full and the byte was dropped
+ * \retval ERR_BUSY The buffer is full and the byte was refused
  */
 int32_t ringbuffer_put(struct ringbuffer *const rb, uint8_t data);
 
+/**
+ * \brief Read a block of bytes from ring buffer, the user needs to handle the
+ * concurrent access on buffer via put/get/flush
+ *
+ * The data is copied with at most two memory copies, one on each side of the
+ * buffer wrap point.
+ *
+ * \param[in] rb The pointer to a ring buffer structure instance
+ * \param[out] buf Space to store the read data
+ * \param[in] length The maximum number of bytes to read
+ *
+ * \return The number of bytes read, [0, length]
+ */
+uint32_t ringbuffer_read(struct ringbuffer *const rb, uint8_t *buf, uint32_t length);
+
+/**
+ * \brief Write a block of bytes to ring buffer, the user needs to handle the
+ * concurrent access on buffer via put/get/flush
+ *
+ * The data is copied with at most two memory copies, one on each side of the
+ * buffer wrap point. Data which does not fit is handled according to the
+ * buffer full strategy, as with ringbuffer_put().
+ *
+ * \param[in] rb The pointer to a ring buffer structure instance
+ * \param[in] buf The data to be put into ring buffer
+ * \param[in] length The number of bytes to write
+ *
+ * \return The number of bytes stored, less than length if data was refused
+ */
+uint32_t ringbuffer_write(struct ringbuffer *const rb, const uint8_t *buf, uint32_t length);
+
+/**
+ * \brief Get the contiguous readable span at the head of ring buffer
+ *
+ * The span is valid until ringbuffer_commit_read() is called, and ends at the
+ * buffer wrap point, so a second call may be needed to reach all data.
+ *
+ * \param[in] rb The pointer to a ring buffer structure instance
+ * \param[out] span The start address of the readable span
+ *
+ * \return The number of bytes in the span
+ */
+uint32_t ringbuffer_peek_span(const struct ringbuffer *const rb, uint8_t **span);
+
+/**
+ * \brief Release bytes from the head of ring buffer
+ *
+ * \param[in] rb The pointer to a ring buffer structure instance
+ * \param[in] length The number of bytes consumed from the span returned by
+ * ringbuffer_peek_span()
+ *
+ * \return ERR_NONE on success, or an error code on failure.
+ */
+int32_t ringbuffer_commit_read(struct ringbuffer *const rb, uint32_t length);
+
+/**
+ * \brief Get the contiguous free span at the tail of ring buffer
+ *
+ * The span ends at the buffer wrap point or at the oldest unread byte,
+ * whichever comes first.
+ *
+ * \param[in] rb The pointer to a ring buffer structure instance
+ * \param[out] span The start address of the writable span
+ *
+ * \return The number of bytes in the span
+ */
+uint32_t ringbuffer_reserve_span(const struct ringbuffer *const rb, uint8_t **span);
+
+/**
+ * \brief Publish bytes written into the span returned by
+ * ringbuffer_reserve_span()
+ *
+ * \param[in] rb The pointer to a ring buffer structure instance
+ * \param[in] length The number of bytes written to the span
+ *
+ * \return ERR_NONE on success, or an error code on failure.
+ */
+int32_t ringbuffer_commit_write(struct ringbuffer *const rb, uint32_t length);
+
+/**
+ * \brief Publish bytes stored into ring buffer memory by hardware
+ *
+ * Used when a peripheral (e.g. the DMAC) fills the buffer memory directly and
+ * cannot be held back. Unlike ringbuffer_commit_write(), unread data which was
+ * overwritten is dropped from the head and counted as overflow, regardless of
+ * the buffer full strategy.
+ *
+ * \param[in] rb The pointer to a ring buffer structure instance
+ * \param[in] length The number of bytes stored after the previous write index
+ *
+ * \return The number of unread bytes which were overwritten
+ */
+uint32_t ringbuffer_commit_overwrite(struct ringbuffer *const rb, uint32_t length);
+
 /**
  * \brief Return the element number of ring buffer
  *
@@ -98,6 +222,22 @@ int32_t ringbuffer_put(struct ringbuffer *const rb, uint8_t data);
  */
 uint32_t ringbuffer_num(const struct ringbuffer *const rb);
 
+/**
+ * \brief Return the free space of ring buffer
+ *
+ * \param[in] rb The pointer to a ring buffer structure instance
+ *
+ * \return The number of bytes which can be put without overflow
+ */
+uint32_t ringbuffer_space(const struct ringbuffer *const rb);
+
+/**
+ * \brief Clear the overflow counter and high-water mark of ring buffer
+ *
+ * \param[in] rb The pointer to a ring buffer structure instance
+ */
+void ringbuffer_clear_stats(struct ringbuffer *const rb);
+
 /**
  * \brief Flush ring buffer, the user needs to handle the concurrent access on buffer
  * via put/get/flush
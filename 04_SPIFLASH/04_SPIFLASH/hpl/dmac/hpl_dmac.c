@@ -34,6 +34,7 @@
 #include <compiler.h>
 #include <hpl_dma.h>
 #include <hpl_dmac_config.h>
+#include <hal_atomic.h>
 #include <utils.h>
 #include <utils_assert.h>
 #include <utils_repeat_macro.h>
@@ -190,6 +191,101 @@ int32_t _dma_enable_transaction(const uint8_t channel, const bool software_trigg
 	return ERR_NONE;
 }
 
+int32_t _dma_disable_transaction(const uint8_t channel)
+{
+	uint8_t current_channel;
+
+	CRITICAL_SECTION_ENTER()
+	current_channel = hri_dmac_read_CHID_reg(DMAC);
+	hri_dmac_write_CHID_reg(DMAC, channel);
+	hri_dmac_clear_CHCTRLA_ENABLE_bit(DMAC);
+	/* A beat in progress completes before the channel reads back disabled */
+	while (hri_dmac_get_CHCTRLA_ENABLE_bit(DMAC)) {
+		;
+	}
+	hri_dmac_write_CHID_reg(DMAC, current_channel);
+	CRITICAL_SECTION_LEAVE()
+
+	return ERR_NONE;
+}
+
+int32_t _dma_set_descriptor_valid(const uint8_t channel, const bool valid)
+{
+	hri_dmacdescriptor_write_BTCTRL_VALID_bit(&_descriptor_section[channel], valid);
+
+	return ERR_NONE;
+}
+
+int32_t _dma_get_transfer_progress(const uint8_t channel, uint32_t *const remaining, int8_t *const next_channel)
+{
+	uint32_t active;
+	uint32_t next;
+
+	ASSERT(remaining && next_channel);
+
+	CRITICAL_SECTION_ENTER()
+	active = hri_dmac_read_ACTIVE_reg(DMAC);
+	next   = hri_dmacdescriptor_read_DESCADDR_reg(&_write_back_section[channel]);
+	/* The write-back copy is stale while the channel owns the bus */
+	if ((active & DMAC_ACTIVE_ABUSY) && ((active & DMAC_ACTIVE_ID_Msk) >> DMAC_ACTIVE_ID_Pos) == channel) {
+		*remaining = (active & DMAC_ACTIVE_BTCNT_Msk) >> DMAC_ACTIVE_BTCNT_Pos;
+	} else {
+		*remaining = hri_dmacdescriptor_read_BTCNT_reg(&_write_back_section[channel]);
+	}
+	CRITICAL_SECTION_LEAVE()
+
+	*next_channel = next ? (int8_t)((next - (uint32_t)_descriptor_section) / sizeof(DmacDescriptor)) : -1;
+
+	return ERR_NONE;
+}
+
+int32_t _dma_crc_enable(const int8_t channel, const enum _dma_crc_polynomial polynomial, const uint32_t checksum)
+{
+	ASSERT(channel < DMAC_CH_NUM);
+
+	CRITICAL_SECTION_ENTER()
+	if (hri_dmac_get_CTRL_CRCENABLE_bit(DMAC)) {
+		CRITICAL_SECTION_LEAVE()
+		return ERR_BUSY;
+	}
+
+	/* CRCCTRL is enable-protected, channel n is selected by CRCSRC 0x20 + n */
+	hri_dmac_write_CRCCTRL_reg(DMAC,
+	                           DMAC_CRCCTRL_CRCBEATSIZE_BYTE
+	                               | ((polynomial == DMA_CRC_32) ? DMAC_CRCCTRL_CRCPOLY_CRC32 : DMAC_CRCCTRL_CRCPOLY_CRC16)
+	                               | ((channel < 0) ? DMAC_CRCCTRL_CRCSRC_IO : DMAC_CRCCTRL_CRCSRC(0x20 + channel)));
+	hri_dmac_write_CRCCHKSUM_reg(DMAC, checksum);
+	hri_dmac_set_CTRL_CRCENABLE_bit(DMAC);
+	CRITICAL_SECTION_LEAVE()
+
+	return ERR_NONE;
+}
+
+void _dma_crc_write(const uint8_t *data, uint32_t length)
+{
+	ASSERT(data || !length);
+
+	while (length--) {
+		hri_dmac_write_CRCDATAIN_reg(DMAC, *data++);
+	}
+}
+
+uint32_t _dma_crc_disable(void)
+{
+	uint32_t checksum;
+
+	/* With the I/O source CRCBUSY stays set until it is cleared */
+	if (hri_dmac_read_CRCCTRL_CRCSRC_bf(DMAC) == DMAC_CRCCTRL_CRCSRC_IO_Val) {
+		hri_dmac_clear_CRCSTATUS_CRCBUSY_bit(DMAC);
+	}
+	checksum = hri_dmac_read_CRCCHKSUM_reg(DMAC);
+
+	hri_dmac_clear_CTRL_CRCENABLE_bit(DMAC);
+	hri_dmac_write_CRCCTRL_reg(DMAC, 0);
+
+	return checksum;
+}
+
 int32_t _dma_get_channel_resource(struct _dma_resource **resource, const uint8_t channel)
 {
 	*resource = &_resources[channel];
@@ -218,12 +314,21 @@ static inline void _dmac_handler(void)
 	flag_status = hri_dmac_get_CHINTFLAG_reg(DMAC, DMAC_CHINTFLAG_MASK);
 	hri_dmac_write_CHID_reg(DMAC, current_channel);
 
+	hri_dmac_write_CHID_reg(DMAC, channel);
 	if (flag_status & DMAC_CHINTFLAG_TERR) {
 		hri_dmac_clear_CHINTFLAG_TERR_bit(DMAC);
-		tmp_resource->dma_cb.error(tmp_resource);
+		hri_dmac_write_CHID_reg(DMAC, current_channel);
+		if (tmp_resource->dma_cb.error) {
+			tmp_resource->dma_cb.error(tmp_resource);
+		}
 	} else if (flag_status & DMAC_CHINTFLAG_TCMPL) {
 		hri_dmac_clear_CHINTFLAG_TCMPL_bit(DMAC);
-		tmp_resource->dma_cb.transfer_done(tmp_resource);
+		hri_dmac_write_CHID_reg(DMAC, current_channel);
+		if (tmp_resource->dma_cb.transfer_done) {
+			tmp_resource->dma_cb.transfer_done(tmp_resource);
+		}
+	} else {
+		hri_dmac_write_CHID_reg(DMAC, current_channel);
 	}
 }
 
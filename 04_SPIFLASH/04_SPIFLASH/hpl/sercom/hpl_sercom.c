@@ -32,11 +32,13 @@
  *
  */
 #include <hpl_dma.h>
+#include <hpl_dmac_config.h>
 #include <hpl_i2c_m_async.h>
 #include <hpl_i2c_m_sync.h>
 #include <hpl_i2c_s_async.h>
 #include <hpl_sercom_config.h>
 #include <hpl_spi_m_async.h>
+#include <hpl_spi_m_dma.h>
 #include <hpl_spi_m_sync.h>
 #include <hpl_spi_s_async.h>
 #include <hpl_spi_s_sync.h>
@@ -106,6 +108,9 @@
 		        | (CONF_SERCOM_##n##_USART_RXEN << SERCOM_USART_CTRLB_RXEN_Pos),                                       \
 		    (uint16_t)(CONF_SERCOM_##n##_USART_BAUD_RATE), CONF_SERCOM_##n##_USART_FRACTIONAL,                         \
 		    CONF_SERCOM_##n##_USART_RECEIVE_PULSE_LENGTH, CONF_SERCOM_##n##_USART_DEBUG_STOP_MODE,                     \
+		    (CONF_SERCOM_##n##_USART_DMA_TX_ENABLE ? CONF_SERCOM_##n##_USART_DMA_TX_CHANNEL : -1),                     \
+		    (CONF_SERCOM_##n##_USART_DMA_RX_ENABLE ? CONF_SERCOM_##n##_USART_DMA_RX_CHANNEL : -1),                     \
+		    CONF_SERCOM_##n##_USART_DMA_RX_LINK_CHANNEL,                                                               \
 	}
 
 /**
@@ -119,6 +124,9 @@ struct usart_configuration {
 	uint8_t                       fractional;
 	hri_sercomusart_rxpl_reg_t    rxpl;
 	hri_sercomusart_dbgctrl_reg_t debug_ctrl;
+	int8_t                        dma_tx_channel;
+	int8_t                        dma_rx_channel;
+	int8_t                        dma_rx_link_channel;
 };
 
 #if SERCOM_USART_AMOUNT < 1
@@ -166,10 +174,15 @@ static void    _sercom_init_irq_param(const void *const hw, void *dev);
 static uint8_t _sercom_get_hardware_index(const void *const hw);
 
 static int32_t     _usart_init(void *const hw);
+static void        _usart_dma_tx_init(struct _usart_async_device *const device);
+static void        _usart_dma_rx_init(struct _usart_async_device *const device);
 static inline void _usart_deinit(void *const hw);
 static uint16_t    _usart_calculate_baud_rate(const uint32_t baud, const uint32_t clock_rate, const uint8_t samples,
                                               const enum usart_baud_rate_mode mode, const uint8_t fraction);
 static void        _usart_set_baud_rate(void *const hw, const uint32_t baud_rate);
+static int32_t     _usart_solve_baud_rate(const uint32_t baud, const uint32_t clock_rate,
+                                          struct usart_baud_setting *const setting);
+static void        _usart_set_baud_setting(void *const hw, const struct usart_baud_setting *const setting);
 static void        _usart_set_data_order(void *const hw, const enum usart_data_order order);
 static void        _usart_set_mode(void *const hw, const enum usart_mode mode);
 static void        _usart_set_parity(void *const hw, const enum usart_parity parity);
@@ -203,6 +216,8 @@ int32_t _usart_async_init(struct _usart_async_device *const device, void *const
 	}
 	device->hw = hw;
 	_sercom_init_irq_param(hw, (void *)device);
+	_usart_dma_tx_init(device);
+	_usart_dma_rx_init(device);
 	NVIC_DisableIRQ((IRQn_Type)_sercom_get_irq_num(hw));
 	NVIC_ClearPendingIRQ((IRQn_Type)_sercom_get_irq_num(hw));
 	NVIC_EnableIRQ((IRQn_Type)_sercom_get_irq_num(hw));
@@ -224,6 +239,14 @@ void _usart_sync_deinit(struct _usart_sync_device *const device)
 void _usart_async_deinit(struct _usart_async_device *const device)
 {
 	NVIC_DisableIRQ((IRQn_Type)_sercom_get_irq_num(device->hw));
+#if CONF_DMAC_ENABLE
+	if (device->dma_tx) {
+		_dma_disable_transaction(_usarts[_get_sercom_index(device->hw)].dma_tx_channel);
+	}
+	if (device->dma_rx) {
+		_dma_disable_transaction(_usarts[_get_sercom_index(device->hw)].dma_rx_channel);
+	}
+#endif
 	_usart_deinit(device->hw);
 }
 
@@ -245,6 +268,24 @@ uint16_t _usart_async_calculate_baud_rate(const uint32_t baud, const uint32_t cl
 	return _usart_calculate_baud_rate(baud, clock_rate, samples, mode, fraction);
 }
 
+/**
+ * \brief Find the baud rate generator setting closest to a baud rate
+ */
+int32_t _usart_async_solve_baud_rate(const uint32_t baud, const uint32_t clock_rate,
+                                     struct usart_baud_setting *const setting)
+{
+	return _usart_solve_baud_rate(baud, clock_rate, setting);
+}
+
+/**
+ * \brief Apply a baud rate generator setting
+ */
+void _usart_async_set_baud_setting(struct _usart_async_device *const        device,
+                                   const struct usart_baud_setting *const setting)
+{
+	_usart_set_baud_setting(device->hw, setting);
+}
+
 /**
  * \brief Enable SERCOM module
  */
@@ -507,6 +548,219 @@ void _usart_async_enable_tx_done_irq(struct _usart_async_device *const device)
 	hri_sercomusart_set_INTEN_TXC_bit(device->hw);
 }
 
+/**
+ * \brief Transmit a buffer through the DMAC
+ */
+int32_t _usart_async_dma_write(struct _usart_async_device *const device, const uint8_t *const buf,
+                               const uint16_t length)
+{
+#if CONF_DMAC_ENABLE
+	uint8_t channel = _usarts[_get_sercom_index(device->hw)].dma_tx_channel;
+
+	if (!device->dma_tx) {
+		return ERR_UNSUPPORTED_OP;
+	}
+
+	hri_sercomusart_clear_INTEN_DRE_bit(device->hw);
+	hri_sercomusart_clear_INTEN_TXC_bit(device->hw);
+	hri_sercomusart_clear_interrupt_TXC_bit(device->hw);
+	_dma_set_source_address(channel, buf);
+	_dma_set_data_amount(channel, length);
+	_dma_enable_transaction(channel, false);
+
+	return ERR_NONE;
+#else
+	(void)device;
+	(void)buf;
+	(void)length;
+
+	return ERR_UNSUPPORTED_OP;
+#endif
+}
+
+/**
+ * \brief Start circular reception through the DMAC
+ */
+int32_t _usart_async_dma_rx_start(struct _usart_async_device *const device, uint8_t *const buf,
+                                  const uint16_t length)
+{
+#if CONF_DMAC_ENABLE
+	uint8_t  i       = _get_sercom_index(device->hw);
+	uint8_t  channel = _usarts[i].dma_rx_channel;
+	uint8_t  link    = _usarts[i].dma_rx_link_channel;
+	uint16_t half    = length >> 1;
+
+	if (!device->dma_rx) {
+		return ERR_UNSUPPORTED_OP;
+	}
+	if (!half || (length & 1)) {
+		return ERR_INVALID_ARG;
+	}
+
+	hri_sercomusart_clear_INTEN_RXC_bit(device->hw);
+	/* Flag the start bit of a character, for the receive start interrupt */
+	hri_sercomusart_set_CTRLB_SFDE_bit(device->hw);
+	_dma_disable_transaction(channel);
+
+	_dma_set_destination_address(channel, buf);
+	_dma_set_data_amount(channel, half);
+	_dma_set_destination_address(link, buf + half);
+	_dma_set_data_amount(link, half);
+	_dma_set_next_descriptor(channel, link);
+	_dma_set_next_descriptor(link, channel);
+	_dma_set_descriptor_valid(link, true);
+	_dma_enable_transaction(channel, false);
+
+	return ERR_NONE;
+#else
+	(void)device;
+	(void)buf;
+	(void)length;
+
+	return ERR_UNSUPPORTED_OP;
+#endif
+}
+
+/**
+ * \brief Retrieve the DMA receive position
+ */
+uint16_t _usart_async_dma_rx_get_position(const struct _usart_async_device *const device, const uint16_t length)
+{
+#if CONF_DMAC_ENABLE
+	uint8_t  i    = _get_sercom_index(device->hw);
+	uint16_t half = length >> 1;
+	uint32_t remaining;
+	int8_t   next;
+
+	if (!device->dma_rx) {
+		return 0;
+	}
+
+	_dma_get_transfer_progress(_usarts[i].dma_rx_channel, &remaining, &next);
+	if (next < 0) {
+		return 0;
+	}
+
+	/* The first half is in progress while the second half is next */
+	if (next == _usarts[i].dma_rx_link_channel) {
+		return (half - remaining) % length;
+	}
+
+	return (length - remaining) % length;
+#else
+	(void)device;
+	(void)length;
+
+	return 0;
+#endif
+}
+
+#if CONF_DMAC_ENABLE
+/**
+ * \internal DMA receive block done handler
+ *
+ * \param[in] resource The pointer to DMA resource
+ */
+static void _usart_dma_rx_block_done(struct _dma_resource *resource)
+{
+	struct _usart_async_device *device = (struct _usart_async_device *)resource->back;
+
+	if (device->usart_cb.rx_dma_block_cb) {
+		device->usart_cb.rx_dma_block_cb(device);
+	}
+}
+
+/**
+ * \internal DMA transmit done handler
+ *
+ * The last byte is still being shifted out when the DMAC finishes, so
+ * completion is reported through the transmission complete interrupt unless
+ * the upper layer wants to queue the next buffer straight away.
+ *
+ * \param[in] resource The pointer to DMA resource
+ */
+static void _usart_dma_tx_done(struct _dma_resource *resource)
+{
+	struct _usart_async_device *device = (struct _usart_async_device *)resource->back;
+
+	if (device->usart_cb.tx_dma_done_cb) {
+		device->usart_cb.tx_dma_done_cb(device);
+	} else {
+		hri_sercomusart_set_INTEN_TXC_bit(device->hw);
+	}
+}
+
+/**
+ * \internal DMA transmit error handler
+ *
+ * \param[in] resource The pointer to DMA resource
+ */
+static void _usart_dma_tx_error(struct _dma_resource *resource)
+{
+	struct _usart_async_device *device = (struct _usart_async_device *)resource->back;
+
+	device->usart_cb.error_cb(device);
+	_usart_dma_tx_done(resource);
+}
+#endif
+
+/**
+ * \internal Claim the DMAC channel configured for USART transmission
+ *
+ * \param[in] device The pointer to USART device instance
+ */
+static void _usart_dma_tx_init(struct _usart_async_device *const device)
+{
+	device->dma_tx = NULL;
+#if CONF_DMAC_ENABLE
+	int8_t channel = _usarts[_get_sercom_index(device->hw)].dma_tx_channel;
+
+	if (channel < 0) {
+		return;
+	}
+
+	_dma_get_channel_resource(&device->dma_tx, channel);
+	device->dma_tx->back                 = device;
+	device->dma_tx->dma_cb.transfer_done = _usart_dma_tx_done;
+	device->dma_tx->dma_cb.error         = _usart_dma_tx_error;
+	_dma_set_destination_address(channel, (const void *)&((Sercom *)device->hw)->USART.DATA.reg);
+	_dma_srcinc_enable(channel, true);
+	_dma_set_irq_state(channel, DMA_TRANSFER_COMPLETE_CB, true);
+	_dma_set_irq_state(channel, DMA_TRANSFER_ERROR_CB, true);
+#endif
+}
+
+/**
+ * \internal Claim the DMAC channel configured for USART reception
+ *
+ * \param[in] device The pointer to USART device instance
+ */
+static void _usart_dma_rx_init(struct _usart_async_device *const device)
+{
+	device->dma_rx = NULL;
+#if CONF_DMAC_ENABLE
+	uint8_t i       = _get_sercom_index(device->hw);
+	int8_t  channel = _usarts[i].dma_rx_channel;
+	uint8_t link    = _usarts[i].dma_rx_link_channel;
+
+	if (channel < 0) {
+		return;
+	}
+
+	_dma_get_channel_resource(&device->dma_rx, channel);
+	device->dma_rx->back                 = device;
+	device->dma_rx->dma_cb.transfer_done = _usart_dma_rx_block_done;
+	device->dma_rx->dma_cb.error         = NULL;
+	_dma_set_source_address(channel, (const void *)&((Sercom *)device->hw)->USART.DATA.reg);
+	_dma_set_source_address(link, (const void *)&((Sercom *)device->hw)->USART.DATA.reg);
+	_dma_srcinc_enable(channel, false);
+	_dma_srcinc_enable(link, false);
+	_dma_dstinc_enable(channel, true);
+	_dma_dstinc_enable(link, true);
+	_dma_set_irq_state(channel, DMA_TRANSFER_COMPLETE_CB, true);
+#endif
+}
+
 /**
  * \brief Retrieve ordinal number of the given sercom hardware instance
  */
@@ -548,6 +802,9 @@ void _usart_async_set_irq_state(struct _usart_async_device *const device, const
 		hri_sercomusart_write_INTEN_TXC_bit(device->hw, state);
 	} else if (USART_ASYNC_RX_DONE == type) {
 		hri_sercomusart_write_INTEN_RXC_bit(device->hw, state);
+	} else if (USART_ASYNC_RX_START == type) {
+		hri_sercomusart_clear_interrupt_RXS_bit(device->hw);
+		hri_sercomusart_write_INTEN_RXS_bit(device->hw, state);
 	} else if (USART_ASYNC_ERROR == type) {
 		hri_sercomusart_write_INTEN_ERROR_bit(device->hw, state);
 	}
@@ -568,15 +825,29 @@ static void _sercom_usart_interrupt_handler(struct _usart_async_device *device)
 	} else if (hri_sercomusart_get_interrupt_TXC_bit(hw) && hri_sercomusart_get_INTEN_TXC_bit(hw)) {
 		hri_sercomusart_clear_INTEN_TXC_bit(hw);
 		device->usart_cb.tx_done_cb(device);
-	} else if (hri_sercomusart_get_interrupt_RXC_bit(hw)) {
-		if (hri_sercomusart_read_STATUS_reg(hw)
-		    & (SERCOM_USART_STATUS_PERR | SERCOM_USART_STATUS_FERR | SERCOM_USART_STATUS_BUFOVF
-		       | SERCOM_USART_STATUS_ISF | SERCOM_USART_STATUS_COLL)) {
+	} else if (hri_sercomusart_get_interrupt_RXC_bit(hw) && hri_sercomusart_get_INTEN_RXC_bit(hw)) {
+		uint32_t status = hri_sercomusart_read_STATUS_reg(hw)
+		                  & (SERCOM_USART_STATUS_PERR | SERCOM_USART_STATUS_FERR | SERCOM_USART_STATUS_BUFOVF
+		                     | SERCOM_USART_STATUS_ISF | SERCOM_USART_STATUS_COLL);
+		if (status) {
 			hri_sercomusart_clear_STATUS_reg(hw, SERCOM_USART_STATUS_MASK);
+			if (device->usart_cb.rx_error_cb) {
+				device->usart_cb.rx_error_cb(
+				    device,
+				    ((status & SERCOM_USART_STATUS_BUFOVF) ? USART_ASYNC_RX_ERROR_OVERFLOW : 0)
+				        | ((status & SERCOM_USART_STATUS_FERR) ? USART_ASYNC_RX_ERROR_FRAME : 0)
+				        | ((status & SERCOM_USART_STATUS_PERR) ? USART_ASYNC_RX_ERROR_PARITY : 0));
+			}
 			return;
 		}
 
 		device->usart_cb.rx_done_cb(device, hri_sercomusart_read_DATA_reg(hw));
+	} else if (hri_sercomusart_get_interrupt_RXS_bit(hw) && hri_sercomusart_get_INTEN_RXS_bit(hw)) {
+		hri_sercomusart_clear_INTEN_RXS_bit(hw);
+		hri_sercomusart_clear_interrupt_RXS_bit(hw);
+		if (device->usart_cb.rx_start_cb) {
+			device->usart_cb.rx_start_cb(device);
+		}
 	} else if (hri_sercomusart_get_interrupt_ERROR_bit(hw)) {
 		uint32_t status;
 
@@ -720,6 +991,129 @@ static void _usart_set_baud_rate(void *const hw, const uint32_t baud_rate)
 	hri_sercomusart_write_CTRLA_ENABLE_bit(hw, enabled);
 }
 
+/**
+ * \internal Baud rate generator modes tried by the solver
+ *
+ * Ordered by preference: more samples per bit tolerate more noise and
+ * clock deviation, so fewer samples are only used when they are closer.
+ */
+static const struct {
+	uint8_t                   sampr;
+	uint8_t                   samples;
+	enum usart_baud_rate_mode mode;
+} _usart_baud_modes[] = {
+    {0x0, 16, USART_BAUDRATE_ASYNCH_ARITHMETIC},
+    {0x1, 16, USART_BAUDRATE_ASYNCH_FRACTIONAL},
+    {0x2, 8, USART_BAUDRATE_ASYNCH_ARITHMETIC},
+    {0x3, 8, USART_BAUDRATE_ASYNCH_FRACTIONAL},
+    {0x4, 3, USART_BAUDRATE_ASYNCH_ARITHMETIC},
+};
+
+/** Error in ppm below which the solver stops looking at fewer samples */
+#define USART_BAUD_ERROR_GOOD 1000
+
+/**
+ * \internal Find the baud rate generator setting closest to a baud rate
+ *
+ * \param[in] baud Required baud rate
+ * \param[in] clock_rate SERCOM core clock frequency
+ * \param[out] setting The best setting found
+ *
+ * \return ERR_NONE if a setting was found, ERR_INVALID_ARG otherwise
+ */
+static int32_t _usart_solve_baud_rate(const uint32_t baud, const uint32_t clock_rate,
+                                      struct usart_baud_setting *const setting)
+{
+	struct usart_baud_setting candidate;
+	uint32_t                  best = UINT32_MAX;
+	uint32_t                  error;
+	uint32_t                  steps;
+	uint64_t                  num;
+	uint64_t                  den;
+	uint8_t                   i;
+
+	ASSERT(setting);
+
+	if (!baud || !clock_rate) {
+		return ERR_INVALID_ARG;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(_usart_baud_modes); i++) {
+		candidate.mode    = _usart_baud_modes[i].mode;
+		candidate.samples = _usart_baud_modes[i].samples;
+
+		if (USART_BAUDRATE_ASYNCH_ARITHMETIC == candidate.mode) {
+			/* f_baud = f_ref * steps / (65536 * S), with BAUD = 65536 - steps */
+			steps = ((uint64_t)65536 * candidate.samples * baud + clock_rate / 2) / clock_rate;
+			if (steps == 0 || steps > 65536) {
+				continue;
+			}
+			candidate.baud     = (uint16_t)(65536 - steps);
+			candidate.fraction = 0;
+			num                = (uint64_t)clock_rate * steps;
+			den                = (uint64_t)65536 * candidate.samples;
+		} else {
+			/* f_baud = f_ref * 8 / (S * steps), with BAUD.FP = steps / 8 */
+			steps = ((uint64_t)8 * clock_rate + candidate.samples * baud / 2) / (candidate.samples * baud);
+			if (steps < 8 || steps > 0xFFFF) {
+				continue;
+			}
+			candidate.baud     = steps >> 3;
+			candidate.fraction = steps & 0x7;
+			num                = (uint64_t)8 * clock_rate;
+			den                = (uint64_t)candidate.samples * steps;
+		}
+
+		candidate.actual = (num + den / 2) / den;
+		candidate.error  = (int32_t)(((int64_t)num - (int64_t)(den * baud)) * 1000000 / (int64_t)(den * baud));
+		error            = candidate.error < 0 ? -candidate.error : candidate.error;
+		if (error < best) {
+			*setting = candidate;
+			best     = error;
+		}
+		if (best <= USART_BAUD_ERROR_GOOD) {
+			break;
+		}
+	}
+
+	return best == UINT32_MAX ? ERR_INVALID_ARG : ERR_NONE;
+}
+
+/**
+ * \internal Apply a baud rate generator setting
+ *
+ * \param[in] hw The pointer to hardware instance
+ * \param[in] setting The setting to apply
+ */
+static void _usart_set_baud_setting(void *const hw, const struct usart_baud_setting *const setting)
+{
+	bool    enabled = hri_sercomusart_get_CTRLA_ENABLE_bit(hw);
+	uint8_t sampr   = 0;
+	uint8_t i;
+
+	for (i = 0; i < ARRAY_SIZE(_usart_baud_modes); i++) {
+		if (_usart_baud_modes[i].mode == setting->mode && _usart_baud_modes[i].samples == setting->samples) {
+			sampr = _usart_baud_modes[i].sampr;
+		}
+	}
+
+	hri_sercomusart_clear_CTRLA_ENABLE_bit(hw);
+
+	CRITICAL_SECTION_ENTER()
+	hri_sercomusart_wait_for_sync(hw, SERCOM_USART_SYNCBUSY_ENABLE);
+	hri_sercomusart_write_CTRLA_SAMPR_bf(hw, sampr);
+	if (USART_BAUDRATE_ASYNCH_FRACTIONAL == setting->mode) {
+		hri_sercomusart_write_BAUD_reg(hw,
+		                               SERCOM_USART_BAUD_FRACFP_BAUD(setting->baud)
+		                                   | SERCOM_USART_BAUD_FRACFP_FP(setting->fraction));
+	} else {
+		hri_sercomusart_write_BAUD_reg(hw, setting->baud);
+	}
+	CRITICAL_SECTION_LEAVE()
+
+	hri_sercomusart_write_CTRLA_ENABLE_bit(hw, enabled);
+}
+
 /**
  * \internal Set data order
  *
@@ -2049,6 +2443,8 @@ struct sercomspi_regs_cfg {
 	uint8_t  dbgctrl;
 	uint16_t dummy_byte;
 	uint8_t  n;
+	int8_t   dma_rx_channel;
+	int8_t   dma_tx_channel;
 };
 COMPILER_PACK_RESET()
 
@@ -2074,7 +2470,9 @@ COMPILER_PACK_RESET()
 		    ((uint8_t)CONF_SERCOM_##n##_SPI_BAUD_RATE),                        /* baud */                              \
 		    (CONF_SERCOM_##n##_SPI_DBGSTOP << SERCOM_SPI_DBGCTRL_DBGSTOP_Pos), /* dbgctrl */                           \
 		    CONF_SERCOM_##n##_SPI_DUMMYBYTE,                                   /* Dummy byte for SPI master mode */    \
-		    n                                                                  /* sercom number */                     \
+		    n,                                                                 /* sercom number */                     \
+		    CONF_SERCOM_##n##_SPI_M_DMA_RX_CHANNEL,                            /* DMA receive channel */               \
+		    CONF_SERCOM_##n##_SPI_M_DMA_TX_CHANNEL                             /* DMA transmit channel */              \
 	}
 
 #ifndef CONF_SERCOM_0_SPI_ENABLE
@@ -2997,3 +3395,223 @@ void _spi_s_async_set_irq_state(struct _spi_async_dev *const device, const enum
 {
 	_spi_m_async_set_irq_state(device, type, state);
 }
+
+#if CONF_DMAC_ENABLE
+/** \internal Destination of the receive channel when there is no RX buffer */
+static uint8_t _spi_dma_rx_discard;
+
+/** \internal Source of the transmit channel when there is no TX buffer */
+static uint8_t _spi_dma_tx_dummy;
+
+/**
+ * \internal DMA transfer done handler of the SPI receive channel
+ *
+ * The last character is received after it has been shifted out, so the end
+ * of the receive channel is the end of the whole transfer.
+ *
+ * \param[in] resource The pointer to DMA resource
+ */
+static void _spi_dma_rx_complete(struct _dma_resource *resource)
+{
+	struct _spi_m_dma_dev *dev = (struct _spi_m_dma_dev *)resource->back;
+
+	if (dev->callbacks.rx) {
+		dev->callbacks.rx(resource);
+	}
+}
+
+/**
+ * \internal DMA transfer done handler of the SPI transmit channel
+ *
+ * \param[in] resource The pointer to DMA resource
+ */
+static void _spi_dma_tx_complete(struct _dma_resource *resource)
+{
+	struct _spi_m_dma_dev *dev = (struct _spi_m_dma_dev *)resource->back;
+
+	if (dev->callbacks.tx) {
+		dev->callbacks.tx(resource);
+	}
+}
+
+/**
+ * \internal DMA error handler of both SPI channels
+ *
+ * \param[in] resource The pointer to DMA resource
+ */
+static void _spi_dma_error_occured(struct _dma_resource *resource)
+{
+	struct _spi_m_dma_dev *dev = (struct _spi_m_dma_dev *)resource->back;
+
+	if (dev->callbacks.error) {
+		dev->callbacks.error(resource);
+	}
+}
+
+int32_t _spi_m_dma_init(struct _spi_m_dma_dev *dev, void *const hw)
+{
+	const struct sercomspi_regs_cfg *regs = _spi_get_regs((uint32_t)hw);
+	struct _spi_m_sync_dev           sync_dev;
+	struct _dma_resource *           tx;
+	int32_t                          rc;
+
+	ASSERT(dev && hw);
+
+	if (regs == NULL || regs->dma_rx_channel < 0 || regs->dma_tx_channel < 0) {
+		return ERR_INVALID_ARG;
+	}
+
+	/* Reset and load the registers the same way as the polled driver */
+	rc = _spi_m_sync_init(&sync_dev, hw);
+	if (rc < 0) {
+		return rc;
+	}
+
+	dev->prvt            = hw;
+	dev->callbacks.tx    = NULL;
+	dev->callbacks.rx    = NULL;
+	dev->callbacks.error = NULL;
+
+	_dma_get_channel_resource(&dev->resource, regs->dma_rx_channel);
+	dev->resource->back                 = dev;
+	dev->resource->dma_cb.transfer_done = _spi_dma_rx_complete;
+	dev->resource->dma_cb.error         = _spi_dma_error_occured;
+	_dma_set_source_address(regs->dma_rx_channel, (const void *)&((Sercom *)hw)->SPI.DATA.reg);
+	_dma_srcinc_enable(regs->dma_rx_channel, false);
+	_dma_set_irq_state(regs->dma_rx_channel, DMA_TRANSFER_ERROR_CB, true);
+
+	_dma_get_channel_resource(&tx, regs->dma_tx_channel);
+	tx->back                 = dev;
+	tx->dma_cb.transfer_done = _spi_dma_tx_complete;
+	tx->dma_cb.error         = _spi_dma_error_occured;
+	_dma_set_destination_address(regs->dma_tx_channel, (const void *)&((Sercom *)hw)->SPI.DATA.reg);
+	_dma_dstinc_enable(regs->dma_tx_channel, false);
+	_dma_set_irq_state(regs->dma_tx_channel, DMA_TRANSFER_ERROR_CB, true);
+
+	return ERR_NONE;
+}
+
+int32_t _spi_m_dma_deinit(struct _spi_m_dma_dev *dev)
+{
+	const struct sercomspi_regs_cfg *regs = _spi_get_regs((uint32_t)dev->prvt);
+
+	ASSERT(dev && regs);
+
+	_dma_disable_transaction(regs->dma_tx_channel);
+	_dma_disable_transaction(regs->dma_rx_channel);
+	_dma_set_irq_state(regs->dma_tx_channel, DMA_TRANSFER_COMPLETE_CB, false);
+	_dma_set_irq_state(regs->dma_tx_channel, DMA_TRANSFER_ERROR_CB, false);
+	_dma_set_irq_state(regs->dma_rx_channel, DMA_TRANSFER_COMPLETE_CB, false);
+	_dma_set_irq_state(regs->dma_rx_channel, DMA_TRANSFER_ERROR_CB, false);
+
+	return _spi_deinit(dev->prvt);
+}
+
+int32_t _spi_m_dma_enable(struct _spi_m_dma_dev *dev)
+{
+	ASSERT(dev && dev->prvt);
+
+	return _spi_sync_enable(dev->prvt);
+}
+
+int32_t _spi_m_dma_disable(struct _spi_m_dma_dev *dev)
+{
+	const struct sercomspi_regs_cfg *regs = _spi_get_regs((uint32_t)dev->prvt);
+
+	ASSERT(dev && regs);
+
+	_dma_disable_transaction(regs->dma_tx_channel);
+	_dma_disable_transaction(regs->dma_rx_channel);
+
+	return _spi_sync_disable(dev->prvt);
+}
+
+int32_t _spi_m_dma_set_mode(struct _spi_m_dma_dev *dev, const enum spi_transfer_mode mode)
+{
+	ASSERT(dev && dev->prvt);
+
+	return _spi_set_mode(dev->prvt, mode);
+}
+
+int32_t _spi_m_dma_set_baudrate(struct _spi_m_dma_dev *dev, const uint32_t baud_val)
+{
+	ASSERT(dev && dev->prvt);
+
+	return _spi_set_baudrate(dev->prvt, baud_val);
+}
+
+int32_t _spi_m_dma_set_char_size(struct _spi_m_dma_dev *dev, const enum spi_char_size char_size)
+{
+	uint8_t size;
+
+	ASSERT(dev && dev->prvt);
+
+	/* The channels move one byte per beat */
+	if (char_size != SPI_CHAR_SIZE_8) {
+		return ERR_INVALID_ARG;
+	}
+
+	return _spi_set_char_size(dev->prvt, char_size, &size);
+}
+
+int32_t _spi_m_dma_set_data_order(struct _spi_m_dma_dev *dev, const enum spi_data_order dord)
+{
+	ASSERT(dev && dev->prvt);
+
+	return _spi_set_data_order(dev->prvt, dord);
+}
+
+void _spi_m_dma_register_callback(struct _spi_m_dma_dev *dev, enum _spi_dma_dev_cb_type type, _spi_dma_cb_t func)
+{
+	const struct sercomspi_regs_cfg *regs = _spi_get_regs((uint32_t)dev->prvt);
+
+	ASSERT(dev && regs);
+
+	switch (type) {
+	case SPI_DEV_CB_DMA_TX:
+		dev->callbacks.tx = func;
+		_dma_set_irq_state(regs->dma_tx_channel, DMA_TRANSFER_COMPLETE_CB, func != NULL);
+		break;
+	case SPI_DEV_CB_DMA_RX:
+		dev->callbacks.rx = func;
+		_dma_set_irq_state(regs->dma_rx_channel, DMA_TRANSFER_COMPLETE_CB, func != NULL);
+		break;
+	case SPI_DEV_CB_DMA_ERROR:
+		dev->callbacks.error = func;
+		break;
+	default:
+		break;
+	}
+}
+
+int32_t _spi_m_dma_transfer(struct _spi_m_dma_dev *dev, uint8_t const *txbuf, uint8_t *const rxbuf,
+                            const uint16_t length)
+{
+	void *const                      hw   = dev->prvt;
+	const struct sercomspi_regs_cfg *regs = _spi_get_regs((uint32_t)hw);
+
+	ASSERT(dev && regs && length);
+
+	/* Flush what is left in the receiver so the first beat lines up */
+	while (hri_sercomspi_get_INTFLAG_reg(hw, SERCOM_SPI_INTFLAG_RXC)) {
+		hri_sercomspi_read_DATA_reg(hw);
+	}
+	hri_sercomspi_clear_STATUS_reg(hw, SERCOM_SPI_STATUS_BUFOVF);
+	hri_sercomspi_clear_INTFLAG_reg(hw, SERCOM_SPI_INTFLAG_ERROR);
+
+	_dma_set_destination_address(regs->dma_rx_channel, rxbuf ? (void *)rxbuf : (void *)&_spi_dma_rx_discard);
+	_dma_dstinc_enable(regs->dma_rx_channel, rxbuf != NULL);
+	_dma_set_data_amount(regs->dma_rx_channel, length);
+
+	_spi_dma_tx_dummy = (uint8_t)regs->dummy_byte;
+	_dma_set_source_address(regs->dma_tx_channel, txbuf ? (const void *)txbuf : (const void *)&_spi_dma_tx_dummy);
+	_dma_srcinc_enable(regs->dma_tx_channel, txbuf != NULL);
+	_dma_set_data_amount(regs->dma_tx_channel, length);
+
+	/* The data register is empty, so TX starts as soon as it is enabled */
+	_dma_enable_transaction(regs->dma_rx_channel, false);
+	_dma_enable_transaction(regs->dma_tx_channel, false);
+
+	return ERR_NONE;
+}
+#endif
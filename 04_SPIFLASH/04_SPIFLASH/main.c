@@ -2,12 +2,13 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include "ext_flash.h"
+#include "flash_log.h"
 
 // Debug Out IO Descriptor
 struct io_descriptor *debug_io;
 
-// Flags for UART Receive
-volatile debug_io_receiving, debug_io_complete = false;
+// Flag for UART Receive
+volatile bool debug_io_complete = false;
 
 // Maximum Size of UART Message for Memory
 #define MAX_MESSAGE_SIZE		64
@@ -15,67 +16,101 @@ volatile debug_io_receiving, debug_io_complete = false;
 // Char Array for UART Received Bytes
 static uint8_t debug_io_received_bytes[MAX_MESSAGE_SIZE];
 
-// Byte Counter
-uint8_t debug_io_bytes_received_counter = 0;
+// Line Framer
+static struct framer debug_framer;
+
+// Set once the Record Log is Mounted
+static bool flash_log_ready = false;
 
 /**
- * UART Receive Callback function.
+ * UART Line Received Callback function.
  *
  */
-static void debug_rx_cb(const struct usart_async_descriptor *const io_descr)
+static void debug_frame_cb(const struct framer *const fr, const struct framer_frame *const frame)
 {
-	// Counters
-	uint8_t ch, count;
+	// Byte Counter
+	uint16_t count;
+	
+	// Drop the line if the previous one is still being stored
+	if (debug_io_complete == true)
+	{
+		return;
+	}
+	
+	// Copy the line, leaving room for the terminator
+	count = framer_frame_copy(frame, debug_io_received_bytes, MAX_MESSAGE_SIZE - 1);
 	
-	// Read a character
-	count = io_read(debug_io, &ch, 1);
+	// Terminate the string
+	debug_io_received_bytes[count] = '\0';
 	
-	// Now we're checking if we've received already
-	if (debug_io_receiving == false)
+	// Set the Completion Flag
+	debug_io_complete = true;
+}
+
+// UART Receive Idle Check Timer Task, queued only while received data is pending
+static struct timer_task debug_idle_task;
+volatile bool debug_idle_armed = false;
+
+/**
+ * Start the UART receive idle timeout, unless it is running already
+ *
+ */
+static void debug_idle_arm(void)
+{
+	if (!debug_idle_armed)
 	{
-		// Set the Receiving Flag
-		debug_io_receiving = true;
-		
-		// Reset the Byte Counter
-		debug_io_bytes_received_counter = 0;
-		
-		// Start filling the buffer
-		debug_io_received_bytes[debug_io_bytes_received_counter] = ch;
-		
-		// Increment the Counter
-		debug_io_bytes_received_counter += count;
+		debug_idle_armed = true;
+		timer_add_task(&TIMER, &debug_idle_task);
 	}
-	else
+}
+
+/**
+ * UART Receive Idle Check Timer Task
+ *
+ */
+static void debug_idle_task_cb(const struct timer_task *const timer_task)
+{
+	debug_idle_armed = false;
+	
+	// Pass received bytes to the framer, check again until the line goes idle
+	if (usart_async_check_rx_idle(&DEBUGOUT) == ERR_NOT_READY)
 	{
-		// Continue filling the buffer
-		debug_io_received_bytes[debug_io_bytes_received_counter] = ch;
-		
-		// Increment the Counter
-		debug_io_bytes_received_counter += count;
-		
-		// Check for end of string
-		if (ch == '\n')
-		{
-			// Set the Completion Flag
-			debug_io_complete = true;
-		}
+		debug_idle_arm();
 	}
 }
 
+/**
+ * UART Receive Start Callback
+ *
+ */
+static void debug_rx_start_cb(const struct usart_async_descriptor *const descr)
+{
+	// A character is arriving, start the idle timeout
+	debug_idle_arm();
+}
+
 /**
  * Method for initialising UART
  *
  */
 static void init_com_port()
 {
-	// Register the Callback Function
-	usart_async_register_callback(&DEBUGOUT, USART_ASYNC_RXC_CB, debug_rx_cb);
+	// Split received data into lines
+	framer_init(&debug_framer, &DEBUGOUT.rx, FRAMER_DELIMITER, '\n', MAX_MESSAGE_SIZE - 1, debug_frame_cb);
+	usart_async_set_framer(&DEBUGOUT, &debug_framer);
 	
 	// Set the IO Descriptor
 	usart_async_get_io_descriptor(&DEBUGOUT, &debug_io);
 	
 	// Enable ASYNC UART
 	usart_async_enable(&DEBUGOUT);
+	
+	// Check the receive line for idle a millisecond after data starts arriving
+	debug_idle_task.interval = 1;
+	debug_idle_task.cb = debug_idle_task_cb;
+	debug_idle_task.mode = TIMER_TASK_ONE_SHOT;
+	usart_async_register_callback(&DEBUGOUT, USART_ASYNC_RX_START_CB, debug_rx_start_cb);
+	timer_start(&TIMER);
 }
 
 int main(void)
@@ -88,54 +123,44 @@ int main(void)
 	
 	// Initialise Serial Flash
 	EXTFLASH_init();
+	
+	// Mount the Record Log
+	if (EXTFLASH_open())
+	{
+		flash_log_ready = FLASHLOG_mount();
+	}
 
 	/* Replace with your application code */
 	while (1)
 	{
-		// Check if we're receiving
-		if (debug_io_receiving == true)
+		// Check if receive complete
+		if (debug_io_complete == true)
 		{
-			// Check if receive complete
-			if (debug_io_complete == true)
+			// Records are limited to FLASHLOG_MAX_DATA bytes
+			size_t length = strlen((char *)debug_io_received_bytes);
+			if (length > FLASHLOG_MAX_DATA)
+			{
+				length = FLASHLOG_MAX_DATA;
+			}
+			
+			// Append the Line to the Record Log
+			if (flash_log_ready && FLASHLOG_append(debug_io_received_bytes, length))
 			{
-				// Open Serial Flash
-				if (EXTFLASH_open())
+				// Read the Record back
+				flashLogRecord_t record;
+				if (FLASHLOG_readLatest(&record, 1) == 1)
 				{
-					// Erase First Block
-					if (EXTFLASH_erase(0, FLASH_ERASE_SECTOR_SIZE))
-					{
-						// Delay to allow erase
-						delay_ms(240);
-					}
-					
-					// Buffer for Write Data
-					uint8_t wdata[MAX_MESSAGE_SIZE];
-					memcpy(&wdata[0], &debug_io_received_bytes[0], MAX_MESSAGE_SIZE);
+					// Response String, kept until the Write has Sent it
+					static char response[128];
+					snprintf(response, sizeof(response), "Stored in memory: %.*s (record %lu)\r\n", record.length, (char *)record.data, (unsigned long)record.seq);
 					
-					// Attempt to Write Data
-					if (EXTFLASH_write(0, MAX_MESSAGE_SIZE, wdata))
-					{
-						// Buffer for Read Data
-						uint8_t rdata[MAX_MESSAGE_SIZE];
-						memset(rdata, 0x00, MAX_MESSAGE_SIZE);
-						
-						// Attempt to Read Data
-						if (EXTFLASH_read(0, MAX_MESSAGE_SIZE, &rdata[0]))
-						{
-							// Response String
-							char *response = malloc(128);
-							sprintf(response, "Stored in memory: %s", rdata);
-							
-							// Print to Console
-							io_write(debug_io, response, strlen(response));
-						}
-					}
+					// Print to Console
+					io_write(debug_io, response, strlen(response));
 				}
-				
-				// Reset Flags
-				debug_io_receiving = false;
-				debug_io_complete = false;
 			}
+			
+			// Reset Flag
+			debug_io_complete = false;
 		}
 	}
 }
@@ -0,0 +1,408 @@
+// Include SPI Bus Header File
+#include "spi_bus.h"
+
+// Include HAL Helpers
+#include <hal_atomic.h>
+#include <hal_delay.h>
+#include <hal_gpio.h>
+
+// Buses in Use, to find the bus of a completed transfer
+static spiBus_t *buses[SPIBUS_MAX_BUSES];
+
+// Run the next Part of the Transaction in Flight
+static void SPIBUS_next(spiBus_t *bus);
+
+/**
+ * Find the bus of a SPI descriptor.
+ *
+ * @param spi_m_dma_descriptor *spi		SPI descriptor.
+ *
+ * @return spiBus_t *					NULL if the descriptor has no bus
+ */
+static spiBus_t *SPIBUS_find(const struct spi_m_dma_descriptor *spi)
+{
+	uint8_t i;
+	
+	for (i = 0; i < SPIBUS_MAX_BUSES; i++)
+	{
+		if (buses[i] && buses[i]->spi == spi)
+		{
+			return buses[i];
+		}
+	}
+	
+	return NULL;
+}
+
+/**
+ * BAUD register value for a SPI clock, rounded so the clock is never
+ * faster than asked for.
+ *
+ * @param spiBus_t *bus					Bus.
+ * @param uint32_t baud					SPI clock in Hz.
+ *
+ * @return uint32_t
+ */
+static uint32_t SPIBUS_baudValue(const spiBus_t *bus, uint32_t baud)
+{
+	uint32_t divider = (bus->clock + 2 * baud - 1) / (2 * baud);
+	
+	// BAUD is an 8-bit register
+	if (divider > 256)
+	{
+		divider = 256;
+	}
+	
+	return (divider > 0) ? divider - 1 : 0;
+}
+
+/**
+ * Take the next transaction off the queue. While a device holds CS asserted
+ * only its own transactions are taken, the others wait until it lets go.
+ * Called with interrupts disabled.
+ *
+ * @param spiBus_t *bus					Bus.
+ *
+ * @return spiBusTransaction_t *		NULL if none can run
+ */
+static spiBusTransaction_t *SPIBUS_dequeue(spiBus_t *bus)
+{
+	spiBusTransaction_t **link;
+	spiBusTransaction_t *prev = NULL;
+	
+	for (link = &bus->head; *link != NULL; prev = *link, link = &(*link)->next)
+	{
+		spiBusTransaction_t *transaction = *link;
+	
+		if (bus->holder == NULL || transaction->device == bus->holder)
+		{
+			// Unlink it
+			*link = transaction->next;
+			if (bus->tail == transaction)
+			{
+				bus->tail = prev;
+			}
+			transaction->next = NULL;
+			return transaction;
+		}
+	}
+	
+	return NULL;
+}
+
+/**
+ * Start the transaction taken off the queue: set the SERCOM up for its
+ * device if another device used it last, select the device and clock the
+ * first segment.
+ *
+ * @param spiBus_t *bus					Bus.
+ *
+ * @return void
+ */
+static void SPIBUS_begin(spiBus_t *bus)
+{
+	spiBusTransaction_t *transaction = bus->active;
+	spiBusDevice_t *device = transaction->device;
+	
+	// Change the SERCOM over, its settings are enable-protected
+	if (bus->current != device)
+	{
+		spi_m_dma_disable(bus->spi);
+		spi_m_dma_set_mode(bus->spi, device->mode);
+		spi_m_dma_set_baudrate(bus->spi, SPIBUS_baudValue(bus, device->baud));
+		spi_m_dma_set_char_size(bus->spi, device->charSize);
+		spi_m_dma_enable(bus->spi);
+		bus->current = device;
+		bus->switches++;
+	}
+	
+	// Select the Device, unless it still holds CS from its last Transaction
+	if (bus->holder != device)
+	{
+		gpio_set_pin_level(device->csPin, false);
+		bus->holder = device;
+	}
+	
+	// Clock the Segments
+	transaction->segment = 0;
+	transaction->done = 0;
+	SPIBUS_next(bus);
+}
+
+/**
+ * End the transaction in flight, report it and start the next one.
+ *
+ * @param spiBus_t *bus					Bus.
+ * @param int32_t status				Result of the transaction.
+ *
+ * @return void
+ */
+static void SPIBUS_finish(spiBus_t *bus, int32_t status)
+{
+	spiBusTransaction_t *transaction = bus->active;
+	spiBusCallback_t cb = transaction->cb;
+	spiBusTransaction_t *next;
+	
+	// Deselect the Device, a failed Transaction never holds the Bus
+	if (!transaction->hold || status != ERR_NONE)
+	{
+		gpio_set_pin_level(transaction->device->csPin, true);
+		bus->holder = NULL;
+	}
+	
+	// Take the next Transaction before the Callback may submit another
+	CRITICAL_SECTION_ENTER()
+	next = SPIBUS_dequeue(bus);
+	bus->active = next;
+	CRITICAL_SECTION_LEAVE()
+	
+	// Hand the Transaction back to its Owner
+	transaction->status = status;
+	if (cb)
+	{
+		cb(transaction);
+	}
+	
+	// Run the next one
+	if (next)
+	{
+		SPIBUS_begin(bus);
+	}
+}
+
+/**
+ * Clock the next block of the transaction in flight, or finish it once all
+ * its segments are done. A segment longer than one DMA transfer takes
+ * several blocks.
+ *
+ * @param spiBus_t *bus					Bus.
+ *
+ * @return void
+ */
+static void SPIBUS_next(spiBus_t *bus)
+{
+	spiBusTransaction_t *transaction = bus->active;
+	const spiBusSegment_t *segment;
+	const uint8_t *wbuf;
+	uint8_t *rbuf;
+	uint16_t ilen;
+	
+	// Move past finished (and empty) Segments
+	while (transaction->segment < transaction->segmentCount && transaction->done >= transaction->segments[transaction->segment].length)
+	{
+		transaction->segment++;
+		transaction->done = 0;
+	}
+	
+	if (transaction->segment >= transaction->segmentCount)
+	{
+		SPIBUS_finish(bus, ERR_NONE);
+		return;
+	}
+	
+	// Next Block of the Segment
+	segment = &transaction->segments[transaction->segment];
+	ilen = (segment->length - transaction->done > SPIBUS_MAX_TRANSFER_SIZE) ? SPIBUS_MAX_TRANSFER_SIZE : segment->length - transaction->done;
+	wbuf = segment->wbuf ? &segment->wbuf[transaction->done] : NULL;
+	rbuf = segment->rbuf ? &segment->rbuf[transaction->done] : NULL;
+	
+	// Count it first, the completion may come before the call returns
+	transaction->done += ilen;
+	if (spi_m_dma_transfer(bus->spi, wbuf, rbuf, ilen) != ERR_NONE)
+	{
+		SPIBUS_finish(bus, ERR_IO);
+	}
+}
+
+/**
+ * Transfer complete callback of the SPI descriptors on a bus.
+ *
+ * @param spi_m_dma_descriptor *spi		SPI descriptor.
+ *
+ * @return void
+ */
+static void SPIBUS_complete_cb(const struct spi_m_dma_descriptor *const spi)
+{
+	spiBus_t *bus = SPIBUS_find(spi);
+	
+	if (bus && bus->active)
+	{
+		SPIBUS_next(bus);
+	}
+}
+
+/**
+ * DMA error callback of the SPI descriptors on a bus.
+ *
+ * @param spi_m_dma_descriptor *spi		SPI descriptor.
+ * @param int32_t status				Error.
+ *
+ * @return void
+ */
+static void SPIBUS_error_cb(const struct spi_m_dma_descriptor *const spi, const int32_t status)
+{
+	spiBus_t *bus = SPIBUS_find(spi);
+	
+	if (bus && bus->active)
+	{
+		SPIBUS_finish(bus, status);
+	}
+}
+
+/**
+ * Put a SPI descriptor under a bus. The bus takes over its callbacks and
+ * enables it.
+ *
+ * @param spiBus_t *bus					Bus to set up.
+ * @param spi_m_dma_descriptor *spi		Initialised SPI descriptor.
+ * @param uint32_t clock				Core clock of the SERCOM in Hz.
+ *
+ * @return int32_t						ERR_NONE, or ERR_NO_RESOURCE if SPIBUS_MAX_BUSES are in use
+ */
+int32_t SPIBUS_init(spiBus_t *bus, struct spi_m_dma_descriptor *spi, uint32_t clock)
+{
+	uint8_t i;
+	
+	// Find a free Slot
+	for (i = 0; i < SPIBUS_MAX_BUSES && buses[i] != NULL && buses[i] != bus; i++)
+	{
+	}
+	if (i == SPIBUS_MAX_BUSES)
+	{
+		return ERR_NO_RESOURCE;
+	}
+	
+	// Empty Bus
+	bus->spi = spi;
+	bus->clock = clock;
+	bus->active = NULL;
+	bus->head = NULL;
+	bus->tail = NULL;
+	bus->current = NULL;
+	bus->holder = NULL;
+	bus->switches = 0;
+	buses[i] = bus;
+	
+	// Take the Callbacks and Enable the SERCOM
+	spi_m_dma_register_callback(spi, SPI_M_DMA_CB_XFER, (FUNC_PTR)SPIBUS_complete_cb);
+	spi_m_dma_register_callback(spi, SPI_M_DMA_CB_ERROR, (FUNC_PTR)SPIBUS_error_cb);
+	spi_m_dma_enable(spi);
+	
+	return ERR_NONE;
+}
+
+/**
+ * Add a device to a bus and deselect it.
+ *
+ * @param spiBus_t *bus					Bus the device is wired to.
+ * @param spiBusDevice_t *device		Device settings, kept by the bus.
+ *
+ * @return int32_t						ERR_NONE, or ERR_INVALID_ARG for settings the bus cannot run
+ */
+int32_t SPIBUS_register(spiBus_t *bus, spiBusDevice_t *device)
+{
+	// The DMA channels move one byte per beat
+	if (device->charSize != SPI_CHAR_SIZE_8 || device->baud == 0 || device->baud > bus->clock / 2)
+	{
+		return ERR_INVALID_ARG;
+	}
+	
+	device->bus = bus;
+	gpio_set_pin_level(device->csPin, true);
+	
+	return ERR_NONE;
+}
+
+/**
+ * Queue a transaction. It starts straight away if the bus is free, the
+ * callback is called from the DMAC interrupt once it is done. Can be called
+ * from interrupts. The transaction and its buffers must stay untouched until
+ * its status is no longer ERR_BUSY.
+ *
+ * @param spiBusTransaction_t *transaction	Transaction to run.
+ *
+ * @return int32_t						ERR_NONE, or ERR_NOT_INITIALIZED for an unregistered device
+ */
+int32_t SPIBUS_submit(spiBusTransaction_t *transaction)
+{
+	spiBus_t *bus;
+	spiBusTransaction_t *start = NULL;
+	
+	if (transaction->device == NULL || transaction->device->bus == NULL)
+	{
+		return ERR_NOT_INITIALIZED;
+	}
+	bus = transaction->device->bus;
+	
+	transaction->status = ERR_BUSY;
+	transaction->next = NULL;
+	
+	CRITICAL_SECTION_ENTER()
+	// Add it to the Queue
+	if (bus->tail)
+	{
+		bus->tail->next = transaction;
+	}
+	else
+	{
+		bus->head = transaction;
+	}
+	bus->tail = transaction;
+	
+	// Start the Queue if it is idle
+	if (bus->active == NULL)
+	{
+		start = SPIBUS_dequeue(bus);
+		bus->active = start;
+	}
+	CRITICAL_SECTION_LEAVE()
+	
+	if (start)
+	{
+		SPIBUS_begin(bus);
+	}
+	
+	return ERR_NONE;
+}
+
+/**
+ * Run a transaction and wait for it. Transactions queued before it run
+ * first. The callback is not used. Not for use from interrupts.
+ *
+ * @param spiBusTransaction_t *transaction	Transaction to run.
+ *
+ * @return int32_t						ERR_NONE, or the error of the transaction
+ */
+int32_t SPIBUS_transfer(spiBusTransaction_t *transaction)
+{
+	int32_t returnValue;
+	
+	// Queue it
+	transaction->cb = NULL;
+	returnValue = SPIBUS_submit(transaction);
+	if (returnValue != ERR_NONE)
+	{
+		return returnValue;
+	}
+	
+	// Wait until it is done...
+	while (transaction->status == ERR_BUSY)
+	{
+		// Delay a bit before checking again
+		delay_us(10);
+	}
+	
+	return transaction->status;
+}
+
+/**
+ * Check whether the bus has nothing in flight or queued.
+ *
+ * @param spiBus_t *bus					Bus.
+ *
+ * @return bool
+ */
+bool SPIBUS_isIdle(const spiBus_t *bus)
+{
+	return (bus->active == NULL && bus->head == NULL);
+}
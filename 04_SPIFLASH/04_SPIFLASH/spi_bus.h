@@ -0,0 +1,81 @@
+#ifndef SPI_BUS_H_
+#define SPI_BUS_H_
+
+// Include STD C Libraries
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Include the DMA SPI Master Driver
+#include <hal_spi_m_dma.h>
+
+// Buses that can be managed (one per SERCOM)
+#ifndef SPIBUS_MAX_BUSES
+#define SPIBUS_MAX_BUSES			1
+#endif
+
+// Largest single DMA transfer, longer segments are split
+#define SPIBUS_MAX_TRANSFER_SIZE	0xFFFF
+
+// Forward Declarations
+struct spiBus;
+struct spiBusTransaction;
+
+// Settings of a Device on the Bus, applied whenever the bus changes over to it
+typedef struct spiBusDevice
+{
+	uint8_t csPin;							// Chip select, active low
+	enum spi_transfer_mode mode;			// Clock polarity and phase
+	uint32_t baud;							// SPI clock in Hz
+	enum spi_char_size charSize;			// SPI_CHAR_SIZE_8 (the DMA channels move bytes)
+	struct spiBus *bus;						// Set by SPIBUS_register
+} spiBusDevice_t;
+
+// Segment of a Transaction, all segments are clocked under one CS assertion
+typedef struct
+{
+	const uint8_t *wbuf;					// Data to send, or NULL to send the dummy byte
+	uint8_t *rbuf;							// Buffer for the received data, or NULL to drop it
+	size_t length;							// Bytes to clock
+} spiBusSegment_t;
+
+// Completion Callback of a Transaction, called from the DMAC interrupt
+typedef void (*spiBusCallback_t)(struct spiBusTransaction *transaction);
+
+// Transaction, owned by the bus from SPIBUS_submit until it is done
+typedef struct spiBusTransaction
+{
+	spiBusDevice_t *device;
+	const spiBusSegment_t *segments;
+	uint8_t segmentCount;
+	bool hold;								// Keep CS asserted and the bus reserved for the device afterwards
+	spiBusCallback_t cb;					// Completion callback, or NULL
+
+	// Filled in by the Bus
+	volatile int32_t status;				// ERR_BUSY until done, then ERR_NONE or the error
+	struct spiBusTransaction *next;			// Queue link
+	uint8_t segment;						// Segment in flight
+	size_t done;							// Bytes of the segment clocked
+} spiBusTransaction_t;
+
+// Bus on one SERCOM
+typedef struct spiBus
+{
+	struct spi_m_dma_descriptor *spi;
+	uint32_t clock;							// SERCOM core clock in Hz
+	spiBusTransaction_t *active;			// Transaction in flight
+	spiBusTransaction_t *head;				// Queue of waiting transactions
+	spiBusTransaction_t *tail;
+	spiBusDevice_t *current;				// Device the SERCOM is set up for
+	spiBusDevice_t *holder;					// Device holding CS asserted, or NULL
+	uint32_t switches;						// Times the SERCOM was set up for another device
+} spiBus_t;
+
+// Bus Methods
+extern int32_t SPIBUS_init(spiBus_t *bus, struct spi_m_dma_descriptor *spi, uint32_t clock);
+extern int32_t SPIBUS_register(spiBus_t *bus, spiBusDevice_t *device);
+extern int32_t SPIBUS_submit(spiBusTransaction_t *transaction);
+extern int32_t SPIBUS_transfer(spiBusTransaction_t *transaction);
+extern bool SPIBUS_isIdle(const spiBus_t *bus);
+
+#endif
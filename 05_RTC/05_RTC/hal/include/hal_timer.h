@@ -47,6 +47,30 @@ extern "C" {
  * @{
  */
 
+/**
+ * \brief Number of slots of the timer task wheel
+ *
+ * Each task is kept in the slot of the tick it is due on, so adding, removing
+ * and expiring a task only looks at the tasks sharing its slot. Must be a
+ * power of two, no fewer slots than tasks keeps each slot short.
+ */
+#ifndef TIMER_WHEEL_SLOTS
+#define TIMER_WHEEL_SLOTS 16
+#endif
+
+/**
+ * \brief Tickless timer
+ *
+ * When set to 1 the timer counter runs freely and the compare interrupt is set
+ * for the next task due, instead of interrupting on every tick. The timer time
+ * is kept from the counter and only brought up to date by the driver (on the
+ * interrupt and when a task is added), read timer_get_timestamp for the time
+ * now. Needs the free running functions of the TC driver.
+ */
+#ifndef TIMER_TICKLESS
+#define TIMER_TICKLESS 0
+#endif
+
 /**
  * \brief Timer mode type
  */
@@ -70,6 +94,7 @@ typedef void (*timer_cb_t)(const struct timer_task *const timer_task);
 struct timer_task {
 	struct list_element elem;       /*! List element. */
 	uint32_t            time_label; /*! Absolute timer start time. */
+	uint32_t            due;        /*! Timer time the task is queued for. */
 
 	uint32_t             interval; /*! Number of timer ticks before calling the task. */
 	timer_cb_t           cb;       /*! Function pointer to the task. */
@@ -82,8 +107,15 @@ struct timer_task {
 struct timer_descriptor {
 	struct _timer_device   device;
 	uint32_t               time;
-	struct list_descriptor tasks; /*! Timer tasks list. */
+	uint32_t               wheel_time;               /*! Timer time the task wheel is processed up to. */
+	struct list_descriptor wheel[TIMER_WHEEL_SLOTS]; /*! Timer tasks, by due time modulo TIMER_WHEEL_SLOTS. */
 	volatile uint8_t       flags;
+#if TIMER_TICKLESS
+	uint32_t tick_cycles; /*! Clock cycles per tick. */
+	uint32_t top;         /*! Top value of the free running counter. */
+	uint32_t count;       /*! Counter value the time was last brought up to date at. */
+	uint32_t cycles;      /*! Clock cycles counted into the current tick. */
+#endif
 };
 
 /**
@@ -165,6 +197,21 @@ int32_t timer_set_clock_cycles_per_tick(struct timer_descriptor *const descr, co
  */
 int32_t timer_get_clock_cycles_in_tick(const struct timer_descriptor *const descr, uint32_t *const cycles);
 
+/**
+ * \brief Retrieve the number of clock cycles since the timer was started
+ *
+ * This function combines the tick count with the hardware counter, giving a
+ * free-running time stamp with the resolution of the timer clock. It can be
+ * called from interrupt handlers. The value wraps around after 2^32 clock
+ * cycles, differences between two time stamps are valid up to that.
+ *
+ * \param[in]  descr The timer descriptor of a timer to read
+ * \param[out] cycles The time stamp in clock cycles
+ *
+ * \return The status of time stamp retrieving.
+ */
+int32_t timer_get_timestamp(const struct timer_descriptor *const descr, uint32_t *const cycles);
+
 /**
  * \brief Add timer task
  *
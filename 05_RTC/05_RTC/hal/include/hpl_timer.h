@@ -135,6 +135,26 @@ void _timer_set_period(struct _timer_device *const device, const uint32_t clock_
  */
 uint32_t _timer_get_period(const struct _timer_device *const device);
 
+/**
+ * \brief Retrieve timer counter value
+ *
+ * \param[in] device The pointer to timer device instance
+ *
+ * \return Counter value, from 0 to the timer period
+ */
+uint32_t _timer_get_counter(const struct _timer_device *const device);
+
+/**
+ * \brief Check if a timer period has expired and its interrupt is pending
+ *
+ * \param[in] device The pointer to timer device instance
+ *
+ * \return Check status.
+ * \retval true The period has expired and not been processed yet
+ * \retval false No period has expired since the last interrupt
+ */
+bool _timer_is_period_pending(const struct _timer_device *const device);
+
 /**
  * \brief Check if timer is running
  *
@@ -146,6 +166,34 @@ uint32_t _timer_get_period(const struct _timer_device *const device);
  */
 bool _timer_is_started(const struct _timer_device *const device);
 
+/**
+ * \brief Let the timer counter run freely
+ *
+ * The counter counts up to its top value and wraps instead of restarting every
+ * period. The period interrupt is replaced by the compare interrupt, set with
+ * _timer_set_compare. Must be called while the timer is stopped.
+ *
+ * \param[in] device The pointer to timer device instance
+ */
+void _timer_set_free_running(struct _timer_device *const device);
+
+/**
+ * \brief Retrieve the top value of the free running counter
+ *
+ * \param[in] device The pointer to timer device instance
+ *
+ * \return Top value, one less than a power of two
+ */
+uint32_t _timer_get_counter_top(const struct _timer_device *const device);
+
+/**
+ * \brief Set the counter value of the next compare interrupt
+ *
+ * \param[in] device The pointer to timer device instance
+ * \param[in] count Counter value to interrupt at
+ */
+void _timer_set_compare(struct _timer_device *const device, const uint32_t count);
+
 /**
  * \brief Set timer IRQ
  *
@@ -47,19 +47,42 @@
  */
 #define TIMER_FLAG_QUEUE_IS_TAKEN 1
 #define TIMER_FLAG_INTERRUPT_TRIGERRED 2
+#define TIMER_FLAG_PROCESSING 4
 
-static void timer_add_timer_task(struct list_descriptor *list, struct timer_task *const new_task, const uint32_t time);
-static void timer_process_counted(struct _timer_device *device);
+#if (TIMER_WHEEL_SLOTS & (TIMER_WHEEL_SLOTS - 1)) != 0
+#error "TIMER_WHEEL_SLOTS must be a power of two"
+#endif
+
+static inline void             timer_task_set_due(struct timer_task *const task);
+static struct list_descriptor *timer_task_slot(struct timer_descriptor *const descr, const struct timer_task *const task);
+static void                    timer_process_counted(struct _timer_device *device);
+#if TIMER_TICKLESS
+static void timer_update_time(struct timer_descriptor *const descr);
+#endif
 
 /**
  * \brief Initialize timer
  */
 int32_t timer_init(struct timer_descriptor *const descr, void *const hw, struct _timer_hpl_interface *const func)
 {
+	uint8_t i;
+
 	ASSERT(descr && hw);
 	_timer_init(&descr->device, hw);
-	descr->time                           = 0;
+	descr->time       = 0;
+	descr->wheel_time = 0;
+	for (i = 0; i < TIMER_WHEEL_SLOTS; i++) {
+		list_reset(&descr->wheel[i]);
+	}
 	descr->device.timer_cb.period_expired = timer_process_counted;
+#if TIMER_TICKLESS
+	/* A period of CC0 counts CC0 + 1 clock cycles */
+	descr->tick_cycles = _timer_get_period(&descr->device) + 1;
+	_timer_set_free_running(&descr->device);
+	descr->top    = _timer_get_counter_top(&descr->device);
+	descr->count  = _timer_get_counter(&descr->device);
+	descr->cycles = 0;
+#endif
 
 	return ERR_NONE;
 }
@@ -85,6 +108,10 @@ int32_t timer_start(struct timer_descriptor *const descr)
 		return ERR_DENIED;
 	}
 	_timer_start(&descr->device);
+#if TIMER_TICKLESS
+	/* Set the compare for the first task due */
+	_timer_set_irq(&descr->device);
+#endif
 
 	return ERR_NONE;
 }
@@ -109,7 +136,19 @@ int32_t timer_stop(struct timer_descriptor *const descr)
 int32_t timer_set_clock_cycles_per_tick(struct timer_descriptor *const descr, const uint32_t clock_cycles)
 {
 	ASSERT(descr);
+#if TIMER_TICKLESS
+	CRITICAL_SECTION_ENTER()
+	timer_update_time(descr);
+	descr->tick_cycles = clock_cycles + 1;
+	descr->time += descr->cycles / descr->tick_cycles;
+	descr->cycles %= descr->tick_cycles;
+	CRITICAL_SECTION_LEAVE()
+	if (_timer_is_started(&descr->device)) {
+		_timer_set_irq(&descr->device);
+	}
+#else
 	_timer_set_period(&descr->device, clock_cycles);
+#endif
 
 	return ERR_NONE;
 }
@@ -122,13 +161,19 @@ int32_t timer_add_task(struct timer_descriptor *const descr, struct timer_task *
 	ASSERT(descr && task);
 
 	descr->flags |= TIMER_FLAG_QUEUE_IS_TAKEN;
-	if (is_list_element(&descr->tasks, task)) {
+	if (is_list_element(timer_task_slot(descr, task), task)) {
 		descr->flags &= ~TIMER_FLAG_QUEUE_IS_TAKEN;
 		ASSERT(false);
 		return ERR_ALREADY_INITIALIZED;
 	}
+#if TIMER_TICKLESS
+	CRITICAL_SECTION_ENTER()
+	timer_update_time(descr);
+	CRITICAL_SECTION_LEAVE()
+#endif
 	task->time_label = descr->time;
-	timer_add_timer_task(&descr->tasks, task, descr->time);
+	timer_task_set_due(task);
+	list_insert_as_head(timer_task_slot(descr, task), task);
 
 	descr->flags &= ~TIMER_FLAG_QUEUE_IS_TAKEN;
 	if (descr->flags & TIMER_FLAG_INTERRUPT_TRIGERRED) {
@@ -137,6 +182,12 @@ int32_t timer_add_task(struct timer_descriptor *const descr, struct timer_task *
 		_timer_set_irq(&descr->device);
 		CRITICAL_SECTION_LEAVE()
 	}
+#if TIMER_TICKLESS
+	else if (!(descr->flags & TIMER_FLAG_PROCESSING) && _timer_is_started(&descr->device)) {
+		/* The task may be due before the compare set, the interrupt sets it again */
+		_timer_set_irq(&descr->device);
+	}
+#endif
 
 	return ERR_NONE;
 }
@@ -149,12 +200,11 @@ int32_t timer_remove_task(struct timer_descriptor *const descr, const struct tim
 	ASSERT(descr && task);
 
 	descr->flags |= TIMER_FLAG_QUEUE_IS_TAKEN;
-	if (!is_list_element(&descr->tasks, task)) {
+	if (!list_delete_element(timer_task_slot(descr, task), task)) {
 		descr->flags &= ~TIMER_FLAG_QUEUE_IS_TAKEN;
 		ASSERT(false);
 		return ERR_NOT_FOUND;
 	}
-	list_delete_element(&descr->tasks, task);
 
 	descr->flags &= ~TIMER_FLAG_QUEUE_IS_TAKEN;
 	if (descr->flags & TIMER_FLAG_INTERRUPT_TRIGERRED) {
@@ -173,8 +223,46 @@ int32_t timer_remove_task(struct timer_descriptor *const descr, const struct tim
 int32_t timer_get_clock_cycles_in_tick(const struct timer_descriptor *const descr, uint32_t *const cycles)
 {
 	ASSERT(descr && cycles);
+#if TIMER_TICKLESS
+	*cycles = descr->tick_cycles - 1;
+#else
 	*cycles = _timer_get_period(&descr->device);
+#endif
+	return ERR_NONE;
+}
+
+/**
+ * \brief Retrieve the number of clock cycles since the timer was started
+ */
+int32_t timer_get_timestamp(const struct timer_descriptor *const descr, uint32_t *const cycles)
+{
+	uint32_t time;
+	uint32_t count;
+
+	ASSERT(descr && cycles);
+
+#if TIMER_TICKLESS
+	CRITICAL_SECTION_ENTER()
+	time  = descr->time;
+	count = descr->cycles + ((_timer_get_counter(&descr->device) - descr->count) & descr->top);
+	CRITICAL_SECTION_LEAVE()
+
+	*cycles = time * descr->tick_cycles + count;
+	return ERR_NONE;
+#else
+	CRITICAL_SECTION_ENTER()
+	time  = descr->time;
+	count = _timer_get_counter(&descr->device);
+	if (_timer_is_period_pending(&descr->device)) {
+		/* The tick is not counted yet, the counter may have wrapped after it was read */
+		time++;
+		count = _timer_get_counter(&descr->device);
+	}
+	CRITICAL_SECTION_LEAVE()
+
+	*cycles = time * (_timer_get_period(&descr->device) + 1) + count;
 	return ERR_NONE;
+#endif
 }
 
 /**
@@ -186,65 +274,185 @@ uint32_t timer_get_version(void)
 }
 
 /**
- * \internal Insert a timer task into sorted timer's list
+ * \internal Set the timer time a task is due on
+ *
+ * A task fires on the first tick at least interval ticks after it was added,
+ * so an interval of 0 is due on the next tick. The due time is kept in the
+ * task while it is queued, so it stays in its slot whatever the interval is
+ * changed to meanwhile.
  *
- * \param[in] head The pointer to the head of timer task list
- * \param[in] task The pointer to task to add
- * \param[in] time Current timer time
+ * \param[in] task The pointer to the task
  */
-static void timer_add_timer_task(struct list_descriptor *list, struct timer_task *const new_task, const uint32_t time)
+static inline void timer_task_set_due(struct timer_task *const task)
 {
-	struct timer_task *it, *prev = NULL, *head = (struct timer_task *)list_get_head(list);
+	task->due = task->time_label + (task->interval ? task->interval : 1);
+}
 
-	if (!head) {
-		list_insert_as_head(list, new_task);
-		return;
+/**
+ * \internal Retrieve the wheel slot of a timer task
+ *
+ * \param[in] descr The timer descriptor
+ * \param[in] task The pointer to the task
+ */
+static struct list_descriptor *timer_task_slot(struct timer_descriptor *const descr, const struct timer_task *const task)
+{
+	return &descr->wheel[task->due & (TIMER_WHEEL_SLOTS - 1)];
+}
+
+#if TIMER_TICKLESS
+/**
+ * \internal Bring the timer time up to date from the free running counter
+ *
+ * Must be called at least once per counter wrap, with interrupts disabled
+ * outside of the timer interrupt.
+ *
+ * \param[in] descr The timer descriptor
+ */
+static void timer_update_time(struct timer_descriptor *const descr)
+{
+	uint32_t count   = _timer_get_counter(&descr->device);
+	uint32_t elapsed = (count - descr->count) & descr->top;
+
+	descr->count = count;
+	descr->time += elapsed / descr->tick_cycles;
+	descr->cycles += elapsed % descr->tick_cycles;
+	if (descr->cycles >= descr->tick_cycles) {
+		descr->cycles -= descr->tick_cycles;
+		descr->time++;
 	}
+}
+
+/**
+ * \internal Retrieve the number of ticks until the next task is due
+ *
+ * \param[in] descr The timer descriptor
+ *
+ * \return Ticks after the wheel time, 0xFFFFFFFF if there are no tasks
+ */
+static uint32_t timer_next_due(struct timer_descriptor *const descr)
+{
+	uint32_t next = 0xFFFFFFFF;
+	uint8_t  i;
 
-	for (it = head; it; it = (struct timer_task *)list_get_next_element(it)) {
-		uint32_t time_left;
+	for (i = 0; i < TIMER_WHEEL_SLOTS; i++) {
+		struct timer_task *it;
 
-		if (it->time_label <= time) {
-			time_left = it->interval - (time - it->time_label);
-		} else {
-			time_left = it->interval - (0xFFFFFFFF - it->time_label) - time;
+		for (it = (struct timer_task *)list_get_head(&descr->wheel[i]); it;
+		     it = (struct timer_task *)list_get_next_element(it)) {
+			uint32_t ticks = it->due - descr->wheel_time;
+
+			if (ticks < next) {
+				next = ticks;
+			}
 		}
-		if (time_left >= new_task->interval)
-			break;
-		prev = it;
 	}
 
-	if (it == head) {
-		list_insert_as_head(list, new_task);
+	return next;
+}
+
+/**
+ * \internal Set the compare interrupt for the next task due
+ *
+ * The compare is never set more than half a counter wrap ahead, so the time
+ * is brought up to date before the counter can wrap past it. If the counter
+ * gets to the compare before it is set, the interrupt is raised straight away.
+ *
+ * \param[in] descr The timer descriptor
+ */
+static void timer_schedule(struct timer_descriptor *const descr)
+{
+	uint32_t limit = descr->top >> 1;
+	uint32_t next  = timer_next_due(descr);
+	uint32_t cycles;
+
+	/* Ticks came while the tasks were processed */
+	if (descr->wheel_time != descr->time) {
+		_timer_set_irq(&descr->device);
+		return;
+	}
+
+	if (next > limit / descr->tick_cycles) {
+		cycles = limit;
 	} else {
-		list_insert_after(prev, new_task);
+		cycles = next * descr->tick_cycles - descr->cycles;
+	}
+	_timer_set_compare(&descr->device, (descr->count + cycles) & descr->top);
+
+	if (((_timer_get_counter(&descr->device) - descr->count) & descr->top) >= cycles) {
+		_timer_set_irq(&descr->device);
 	}
 }
+#endif
 
 /**
  * \internal Process interrupts
+ *
+ * Every tick the slot of the tick is searched for the tasks due on it. Tasks
+ * further ahead share the slot until their turn comes round. Ticks that came
+ * while the task wheel was taken are caught up on the next one. A tickless
+ * timer gets here on the compare set for the next task due, and catches up on
+ * all the ticks since.
  */
 static void timer_process_counted(struct _timer_device *device)
 {
 	struct timer_descriptor *timer = CONTAINER_OF(device, struct timer_descriptor, device);
-	struct timer_task *      it    = (struct timer_task *)list_get_head(&timer->tasks);
-	uint32_t                 time  = ++timer->time;
+#if TIMER_TICKLESS
+	uint32_t time;
+
+	timer_update_time(timer);
+	time = timer->time;
+#else
+	uint32_t time = ++timer->time;
+#endif
 
 	if ((timer->flags & TIMER_FLAG_QUEUE_IS_TAKEN) || (timer->flags & TIMER_FLAG_INTERRUPT_TRIGERRED)) {
 		timer->flags |= TIMER_FLAG_INTERRUPT_TRIGERRED;
 		return;
 	}
 
-	while (it && ((time - it->time_label) >= it->interval)) {
-		struct timer_task *tmp = it;
+	timer->flags |= TIMER_FLAG_PROCESSING;
+	while (timer->wheel_time != time) {
+		uint32_t                now;
+		struct list_descriptor *slot;
 
-		list_remove_head(&timer->tasks);
-		if (TIMER_TASK_REPEAT == tmp->mode) {
-			tmp->time_label = time;
-			timer_add_timer_task(&timer->tasks, tmp, time);
-		}
-		it = (struct timer_task *)list_get_head(&timer->tasks);
+#if TIMER_TICKLESS
+		/* After a long sleep go straight to the tick before the next task due */
+		if (time - timer->wheel_time > TIMER_WHEEL_SLOTS) {
+			uint32_t next = timer_next_due(timer);
 
-		tmp->cb(tmp);
+			if (next > time - timer->wheel_time) {
+				next = time - timer->wheel_time;
+			}
+			timer->wheel_time += next - 1;
+		}
+#endif
+		now  = ++timer->wheel_time;
+		slot = &timer->wheel[now & (TIMER_WHEEL_SLOTS - 1)];
+
+		/* Callbacks may add and remove tasks, so look the slot up again after each */
+		for (;;) {
+			struct timer_task *it = (struct timer_task *)list_get_head(slot);
+
+			while (it && it->due != now) {
+				it = (struct timer_task *)list_get_next_element(it);
+			}
+			if (!it) {
+				break;
+			}
+
+			list_delete_element(slot, it);
+			if (TIMER_TASK_REPEAT == it->mode) {
+				it->time_label = time;
+				timer_task_set_due(it);
+				list_insert_as_head(timer_task_slot(timer, it), it);
+			}
+
+			it->cb(it);
+		}
 	}
+	timer->flags &= ~TIMER_FLAG_PROCESSING;
+
+#if TIMER_TICKLESS
+	timer_schedule(timer);
+#endif
 }
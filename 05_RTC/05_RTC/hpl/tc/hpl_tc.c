@@ -228,6 +228,33 @@ uint32_t _timer_get_period(const struct _timer_device *const device)
 
 	return 0;
 }
+/**
+ * \brief Retrieve timer counter value
+ */
+uint32_t _timer_get_counter(const struct _timer_device *const device)
+{
+	void *const hw = device->hw;
+
+	hri_tc_write_READREQ_reg(hw, TC_READREQ_RREQ | TC_READREQ_ADDR(TC_COUNT16_COUNT_OFFSET));
+	hri_tc_wait_for_sync(hw);
+
+	if (TC_CTRLA_MODE_COUNT32_Val == hri_tc_read_CTRLA_MODE_bf(hw)) {
+		return hri_tccount32_read_COUNT_reg(hw);
+	} else if (TC_CTRLA_MODE_COUNT16_Val == hri_tc_read_CTRLA_MODE_bf(hw)) {
+		return hri_tccount16_read_COUNT_reg(hw);
+	} else if (TC_CTRLA_MODE_COUNT8_Val == hri_tc_read_CTRLA_MODE_bf(hw)) {
+		return hri_tccount8_read_COUNT_reg(hw);
+	}
+
+	return 0;
+}
+/**
+ * \brief Check if a timer period has expired and its interrupt is pending
+ */
+bool _timer_is_period_pending(const struct _timer_device *const device)
+{
+	return hri_tc_get_INTFLAG_OVF_bit(device->hw);
+}
 /**
  * \brief Check if timer is running
  */
@@ -235,6 +262,54 @@ bool _timer_is_started(const struct _timer_device *const device)
 {
 	return hri_tc_get_CTRLA_ENABLE_bit(device->hw);
 }
+/**
+ * \brief Let the timer counter run freely
+ */
+void _timer_set_free_running(struct _timer_device *const device)
+{
+	void *const hw = device->hw;
+
+	/* Count to MAX (PER in 8-bit mode), CC0 is free for the compare */
+	hri_tc_write_CTRLA_WAVEGEN_bf(hw, TC_CTRLA_WAVEGEN_NFRQ_Val);
+	if (TC_CTRLA_MODE_COUNT8_Val == hri_tc_read_CTRLA_MODE_bf(hw)) {
+		hri_tccount8_write_PER_reg(hw, 0xFF);
+	}
+	hri_tc_clear_INTEN_OVF_bit(hw);
+	hri_tc_clear_interrupt_MC0_bit(hw);
+	hri_tc_set_INTEN_MC0_bit(hw);
+}
+/**
+ * \brief Retrieve the top value of the free running counter
+ */
+uint32_t _timer_get_counter_top(const struct _timer_device *const device)
+{
+	void *const hw = device->hw;
+
+	if (TC_CTRLA_MODE_COUNT32_Val == hri_tc_read_CTRLA_MODE_bf(hw)) {
+		return 0xFFFFFFFF;
+	} else if (TC_CTRLA_MODE_COUNT16_Val == hri_tc_read_CTRLA_MODE_bf(hw)) {
+		return 0xFFFF;
+	}
+
+	return 0xFF;
+}
+/**
+ * \brief Set the counter value of the next compare interrupt
+ */
+void _timer_set_compare(struct _timer_device *const device, const uint32_t count)
+{
+	void *const hw = device->hw;
+
+	if (TC_CTRLA_MODE_COUNT32_Val == hri_tc_read_CTRLA_MODE_bf(hw)) {
+		hri_tccount32_write_CC_reg(hw, 0, count);
+	} else if (TC_CTRLA_MODE_COUNT16_Val == hri_tc_read_CTRLA_MODE_bf(hw)) {
+		hri_tccount16_write_CC_reg(hw, 0, (hri_tccount16_cc_reg_t)count);
+	} else if (TC_CTRLA_MODE_COUNT8_Val == hri_tc_read_CTRLA_MODE_bf(hw)) {
+		hri_tccount8_write_CC_reg(hw, 0, (hri_tccount8_cc_reg_t)count);
+	}
+	/* The compare is only armed once the write is synchronized */
+	hri_tc_wait_for_sync(hw);
+}
 
 /**
  * \brief Retrieve timer helper functions
@@ -269,7 +344,11 @@ static void tc_interrupt_handler(struct _timer_device *device)
 {
 	void *const hw = device->hw;
 
-	if (hri_tc_get_interrupt_OVF_bit(hw)) {
+	if (hri_tc_get_INTEN_MC0_bit(hw)) {
+		/* Free running: a compare match, or _timer_set_irq asking for the tasks to be looked at */
+		hri_tc_clear_interrupt_MC0_bit(hw);
+		device->timer_cb.period_expired(device);
+	} else if (hri_tc_get_interrupt_OVF_bit(hw)) {
 		hri_tc_clear_interrupt_OVF_bit(hw);
 		device->timer_cb.period_expired(device);
 	}
@@ -1,7 +1,5 @@
 #include <atmel_start.h>
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
+#include "debug_log.h"
 
 // Structs for Calendar Alarms
 static struct calendar_alarm alarm1;
@@ -10,6 +8,15 @@ static struct calendar_alarm alarm2;
 // Struct for Timer Task
 static struct timer_task task;
 
+/**
+ * Debug log output, sends the encoded records over the debug UART
+ *
+ */
+static int32_t debug_write(const uint8_t *buf, const int32_t len)
+{
+	return io_write(&DEBUGOUT.io, buf, len);
+}
+
 /**
  * Callback for Timer Task
  *
@@ -32,14 +39,8 @@ static void alarm_cb(struct calendar_descriptor *const descr)
 	// Get date and time from calendar
 	calendar_get_date_time(&CALENDAR, &datetime);
 	
-	// Allocate Memory for Debug Out String
-	char *alarm_message = malloc(32);
-	
-	// Format Alarm Message
-	sprintf(alarm_message, "ALARM AT %d-%d-%d %02d:%02d:%02d\r\n", datetime.date.year, datetime.date.month, datetime.date.day, datetime.time.hour, datetime.time.min, datetime.time.sec);
-	
-	// Write to Debug Out
-	io_write(&DEBUGOUT, alarm_message, strlen(alarm_message));
+	// Log the Alarm, Formatted on the Host
+	DLOG("ALARM AT %d-%d-%d %02d:%02d:%02d\r\n", datetime.date.year, datetime.date.month, datetime.date.day, datetime.time.hour, datetime.time.min, datetime.time.sec);
 }
 
 int main(void)
@@ -50,6 +51,9 @@ int main(void)
 	// Enable UART
 	usart_sync_enable(&DEBUGOUT);
 	
+	// Send the Debug Log over the UART
+	DLOG_init(debug_write);
+	
 	// Set up Calendar Date and Time Structs
 	struct calendar_date date;
 	struct calendar_time time;
@@ -94,5 +98,7 @@ int main(void)
 
 	/* Replace with your application code */
 	while (1) {
+		// Send any Logged Messages
+		DLOG_flush();
 	}
 }
@@ -0,0 +1,77 @@
+/**
+ * Deferred Binary Debug Log
+ *
+ * Log calls store the address of their format string and the raw argument
+ * values in a RAM buffer, which takes a few microseconds and is safe in
+ * interrupts. DLOG_flush() sends the stored records from the main loop as
+ * COBS framed binary messages:
+ *
+ *   [format string ID, 16-bit LE] [argument 0, 32-bit LE] ... [0x00]
+ *
+ * The format strings only live in the .logstr section of the ELF file, which
+ * is not loaded into flash. tools/dlog_decode.py turns the records back into
+ * text using the ELF file of the running firmware.
+ *
+ * Arguments are integers, chars or floats, at most DLOG_MAX_ARGS of them.
+ * Strings are not supported.
+ */
+#ifndef DEBUG_LOG_H_
+#define DEBUG_LOG_H_
+
+// Include STD C Libraries
+#include <stdint.h>
+#include <stdbool.h>
+
+// Size of the Record Buffer (Must be a Power of 2)
+#ifndef DLOG_BUFFER_SIZE
+#define DLOG_BUFFER_SIZE			256
+#endif
+
+// Maximum Number of Arguments per Record
+#define DLOG_MAX_ARGS				6
+
+// Function that Sends the Encoded Records
+typedef int32_t (*dlog_write_t)(const uint8_t *buf, const int32_t len);
+
+// Argument Conversion: Floats are Stored as Their Raw Bits
+uint32_t DLOG_arg_float(float value);
+uint32_t DLOG_arg_double(double value);
+uint32_t DLOG_arg_int(uint32_t value);
+
+#define DLOG_ARG(x)					_Generic((x), float: DLOG_arg_float, double: DLOG_arg_double, default: DLOG_arg_int)(x)
+
+// Argument Counting and Mapping
+#define DLOG_NARGS(...)				DLOG_NARGS_(0, ##__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0)
+#define DLOG_NARGS_(z, a, b, c, d, e, f, n, ...)	n
+#define DLOG_MAP_0(...)
+#define DLOG_MAP_1(x)				DLOG_ARG(x)
+#define DLOG_MAP_2(x, ...)			DLOG_ARG(x), DLOG_MAP_1(__VA_ARGS__)
+#define DLOG_MAP_3(x, ...)			DLOG_ARG(x), DLOG_MAP_2(__VA_ARGS__)
+#define DLOG_MAP_4(x, ...)			DLOG_ARG(x), DLOG_MAP_3(__VA_ARGS__)
+#define DLOG_MAP_5(x, ...)			DLOG_ARG(x), DLOG_MAP_4(__VA_ARGS__)
+#define DLOG_MAP_6(x, ...)			DLOG_ARG(x), DLOG_MAP_5(__VA_ARGS__)
+#define DLOG_CAT(a, b)				DLOG_CAT_(a, b)
+#define DLOG_CAT_(a, b)				a##b
+
+/**
+ * Record a log message.
+ *
+ * @param fmt		printf style format string literal
+ * @param ...		Up to DLOG_MAX_ARGS integer, char or float arguments
+ */
+#define DLOG(fmt, ...)																	\
+	do																					\
+	{																					\
+		static const char dlog_fmt[] __attribute__((section(".logstr"), used)) = fmt;	\
+		const uint32_t dlog_args[DLOG_NARGS(__VA_ARGS__) + 1] =							\
+			{ 0, DLOG_CAT(DLOG_MAP_, DLOG_NARGS(__VA_ARGS__))(__VA_ARGS__) };			\
+		DLOG_record((uintptr_t)dlog_fmt, &dlog_args[1], DLOG_NARGS(__VA_ARGS__));		\
+	} while (0)
+
+// Debug Log Methods
+void DLOG_init(dlog_write_t write);
+bool DLOG_record(uint32_t id, const uint32_t *args, uint8_t nargs);
+bool DLOG_flush(void);
+uint32_t DLOG_dropped(void);
+
+#endif
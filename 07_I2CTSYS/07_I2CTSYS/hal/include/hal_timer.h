@@ -47,6 +47,17 @@ extern "C" {
  * @{
  */
 
+/**
+ * \brief Number of slots of the timer task wheel
+ *
+ * Each task is kept in the slot of the tick it is due on, so adding, removing
+ * and expiring a task only looks at the tasks sharing its slot. Must be a
+ * power of two, no fewer slots than tasks keeps each slot short.
+ */
+#ifndef TIMER_WHEEL_SLOTS
+#define TIMER_WHEEL_SLOTS 16
+#endif
+
 /**
  * \brief Timer mode type
  */
@@ -70,6 +81,7 @@ typedef void (*timer_cb_t)(const struct timer_task *const timer_task);
 struct timer_task {
 	struct list_element elem;       /*! List element. */
 	uint32_t            time_label; /*! Absolute timer start time. */
+	uint32_t            due;        /*! Timer time the task is queued for. */
 
 	uint32_t             interval; /*! Number of timer ticks before calling the task. */
 	timer_cb_t           cb;       /*! Function pointer to the task. */
@@ -82,7 +94,8 @@ struct timer_task {
 struct timer_descriptor {
 	struct _timer_device   device;
 	uint32_t               time;
-	struct list_descriptor tasks; /*! Timer tasks list. */
+	uint32_t               wheel_time;               /*! Timer time the task wheel is processed up to. */
+	struct list_descriptor wheel[TIMER_WHEEL_SLOTS]; /*! Timer tasks, by due time modulo TIMER_WHEEL_SLOTS. */
 	volatile uint8_t       flags;
 };
 
@@ -48,17 +48,28 @@
 #define TIMER_FLAG_QUEUE_IS_TAKEN 1
 #define TIMER_FLAG_INTERRUPT_TRIGERRED 2
 
-static void timer_add_timer_task(struct list_descriptor *list, struct timer_task *const new_task, const uint32_t time);
-static void timer_process_counted(struct _timer_device *device);
+#if (TIMER_WHEEL_SLOTS & (TIMER_WHEEL_SLOTS - 1)) != 0
+#error "TIMER_WHEEL_SLOTS must be a power of two"
+#endif
+
+static inline void             timer_task_set_due(struct timer_task *const task);
+static struct list_descriptor *timer_task_slot(struct timer_descriptor *const descr, const struct timer_task *const task);
+static void                    timer_process_counted(struct _timer_device *device);
 
 /**
  * \brief Initialize timer
  */
 int32_t timer_init(struct timer_descriptor *const descr, void *const hw, struct _timer_hpl_interface *const func)
 {
+	uint8_t i;
+
 	ASSERT(descr && hw);
 	_timer_init(&descr->device, hw);
-	descr->time                           = 0;
+	descr->time       = 0;
+	descr->wheel_time = 0;
+	for (i = 0; i < TIMER_WHEEL_SLOTS; i++) {
+		list_reset(&descr->wheel[i]);
+	}
 	descr->device.timer_cb.period_expired = timer_process_counted;
 
 	return ERR_NONE;
@@ -122,13 +133,14 @@ int32_t timer_add_task(struct timer_descriptor *const descr, struct timer_task *
 	ASSERT(descr && task);
 
 	descr->flags |= TIMER_FLAG_QUEUE_IS_TAKEN;
-	if (is_list_element(&descr->tasks, task)) {
+	if (is_list_element(timer_task_slot(descr, task), task)) {
 		descr->flags &= ~TIMER_FLAG_QUEUE_IS_TAKEN;
 		ASSERT(false);
 		return ERR_ALREADY_INITIALIZED;
 	}
 	task->time_label = descr->time;
-	timer_add_timer_task(&descr->tasks, task, descr->time);
+	timer_task_set_due(task);
+	list_insert_as_head(timer_task_slot(descr, task), task);
 
 	descr->flags &= ~TIMER_FLAG_QUEUE_IS_TAKEN;
 	if (descr->flags & TIMER_FLAG_INTERRUPT_TRIGERRED) {
@@ -149,12 +161,11 @@ int32_t timer_remove_task(struct timer_descriptor *const descr, const struct tim
 	ASSERT(descr && task);
 
 	descr->flags |= TIMER_FLAG_QUEUE_IS_TAKEN;
-	if (!is_list_element(&descr->tasks, task)) {
+	if (!list_delete_element(timer_task_slot(descr, task), task)) {
 		descr->flags &= ~TIMER_FLAG_QUEUE_IS_TAKEN;
 		ASSERT(false);
 		return ERR_NOT_FOUND;
 	}
-	list_delete_element(&descr->tasks, task);
 
 	descr->flags &= ~TIMER_FLAG_QUEUE_IS_TAKEN;
 	if (descr->flags & TIMER_FLAG_INTERRUPT_TRIGERRED) {
@@ -186,48 +197,41 @@ uint32_t timer_get_version(void)
 }
 
 /**
- * \internal Insert a timer task into sorted timer's list
+ * \internal Set the timer time a task is due on
  *
- * \param[in] head The pointer to the head of timer task list
- * \param[in] task The pointer to task to add
- * \param[in] time Current timer time
+ * A task fires on the first tick at least interval ticks after it was added,
+ * so an interval of 0 is due on the next tick. The due time is kept in the
+ * task while it is queued, so it stays in its slot whatever the interval is
+ * changed to meanwhile.
+ *
+ * \param[in] task The pointer to the task
  */
-static void timer_add_timer_task(struct list_descriptor *list, struct timer_task *const new_task, const uint32_t time)
+static inline void timer_task_set_due(struct timer_task *const task)
 {
-	struct timer_task *it, *prev = NULL, *head = (struct timer_task *)list_get_head(list);
-
-	if (!head) {
-		list_insert_as_head(list, new_task);
-		return;
-	}
-
-	for (it = head; it; it = (struct timer_task *)list_get_next_element(it)) {
-		uint32_t time_left;
-
-		if (it->time_label <= time) {
-			time_left = it->interval - (time - it->time_label);
-		} else {
-			time_left = it->interval - (0xFFFFFFFF - it->time_label) - time;
-		}
-		if (time_left >= new_task->interval)
-			break;
-		prev = it;
-	}
+	task->due = task->time_label + (task->interval ? task->interval : 1);
+}
 
-	if (it == head) {
-		list_insert_as_head(list, new_task);
-	} else {
-		list_insert_after(prev, new_task);
-	}
+/**
+ * \internal Retrieve the wheel slot of a timer task
+ *
+ * \param[in] descr The timer descriptor
+ * \param[in] task The pointer to the task
+ */
+static struct list_descriptor *timer_task_slot(struct timer_descriptor *const descr, const struct timer_task *const task)
+{
+	return &descr->wheel[task->due & (TIMER_WHEEL_SLOTS - 1)];
 }
 
 /**
  * \internal Process interrupts
+ *
+ * Every tick the slot of the tick is searched for the tasks due on it. Tasks
+ * further ahead share the slot until their turn comes round. Ticks that came
+ * while the task wheel was taken are caught up on the next one.
  */
 static void timer_process_counted(struct _timer_device *device)
 {
 	struct timer_descriptor *timer = CONTAINER_OF(device, struct timer_descriptor, device);
-	struct timer_task *      it    = (struct timer_task *)list_get_head(&timer->tasks);
 	uint32_t                 time  = ++timer->time;
 
 	if ((timer->flags & TIMER_FLAG_QUEUE_IS_TAKEN) || (timer->flags & TIMER_FLAG_INTERRUPT_TRIGERRED)) {
@@ -235,16 +239,29 @@ static void timer_process_counted(struct _timer_device *device)
 		return;
 	}
 
-	while (it && ((time - it->time_label) >= it->interval)) {
-		struct timer_task *tmp = it;
-
-		list_remove_head(&timer->tasks);
-		if (TIMER_TASK_REPEAT == tmp->mode) {
-			tmp->time_label = time;
-			timer_add_timer_task(&timer->tasks, tmp, time);
+	while (timer->wheel_time != time) {
+		uint32_t                now  = ++timer->wheel_time;
+		struct list_descriptor *slot = &timer->wheel[now & (TIMER_WHEEL_SLOTS - 1)];
+
+		/* Callbacks may add and remove tasks, so look the slot up again after each */
+		for (;;) {
+			struct timer_task *it = (struct timer_task *)list_get_head(slot);
+
+			while (it && it->due != now) {
+				it = (struct timer_task *)list_get_next_element(it);
+			}
+			if (!it) {
+				break;
+			}
+
+			list_delete_element(slot, it);
+			if (TIMER_TASK_REPEAT == it->mode) {
+				it->time_label = time;
+				timer_task_set_due(it);
+				list_insert_as_head(timer_task_slot(timer, it), it);
+			}
+
+			it->cb(it);
 		}
-		it = (struct timer_task *)list_get_head(&timer->tasks);
-
-		tmp->cb(tmp);
 	}
 }
@@ -1,6 +1,6 @@
 #include <atmel_start.h>
-#include <stdio.h>
 #include "ext_tsys01.h"
+#include "debug_log.h"
 
 // IO Descriptor for Debug UART
 struct io_descriptor *debug_io;
@@ -11,10 +11,6 @@ static struct timer_task temp_timer;
 // Temperature Float
 static float temperature = 0.0f;
 
-// UART String
-static char *temp_output;
-static char buf[5];
-
 /**
  * Initialise UART on Debug Out
  *
@@ -26,17 +22,22 @@ void init_uart(void)
 	usart_sync_enable(&DEBUGOUT);
 }
 
+/**
+ * Debug log output, sends the encoded records over the debug UART
+ *
+ */
+static int32_t debug_write(const uint8_t *buf, const int32_t len)
+{
+	return io_write(debug_io, buf, len);
+}
+
 static void read_temp_cb(const struct timer_task *const timer_task)
 {
 	// Read the Temperature
 	read_temperature(&temperature);
-	gcvt(temperature, 5, buf);
-	
-	// Create the Reading String
-	sprintf(&temp_output[0], "Temperature is %sC\r\n", buf);
 	
-	// Write to Console
-	io_write(debug_io, temp_output, strlen(temp_output));
+	// Log the Reading, Formatted on the Host
+	DLOG("Temperature is %.3fC\r\n", temperature);
 }
 
 void init_timer()
@@ -60,14 +61,16 @@ int main(void)
 	init_tsys();
 	read_eeprom();
 	
-	// Allocate some memory for the temperature string
-	temp_output = malloc(30);
-	
 	// Initialise the UART and Timer
 	init_uart();
 	init_timer();
+	
+	// Send the Debug Log over the UART
+	DLOG_init(debug_write);
 
 	/* Replace with your application code */
 	while (1) {
+		// Send any Logged Messages
+		DLOG_flush();
 	}
 }
@@ -0,0 +1,213 @@
+// Include Debug Log Header File
+#include "debug_log.h"
+
+// Include Drivers
+#include <string.h>
+#include <hal_atomic.h>
+
+// Record Header: Set Once the Record is Complete
+#define DLOG_RECORD_VALID			0x80
+#define DLOG_RECORD_NARGS_MASK		0x0F
+
+// Record Layout: Header, 16-bit ID, 32-bit Arguments
+#define DLOG_RECORD_SIZE(n)			(3 + 4 * (n))
+
+// Largest Frame: Record without Header, COBS Overhead and Delimiter
+#define DLOG_FRAME_SIZE				(DLOG_RECORD_SIZE(DLOG_MAX_ARGS) - 1 + 2)
+
+// Record Buffer and Indexes
+static uint8_t dlogBuffer[DLOG_BUFFER_SIZE];
+static volatile uint32_t dlogWriteIndex = 0;
+static volatile uint32_t dlogReadIndex = 0;
+
+// Number of Records Lost on Buffer Full
+static volatile uint32_t dlogDropped = 0;
+
+// Function that Sends the Encoded Records
+static dlog_write_t dlogWrite = NULL;
+
+/**
+ * Float argument conversion.
+ *
+ * @param float value				Argument value
+ *
+ * @return uint32_t
+ */
+uint32_t DLOG_arg_float(float value)
+{
+	// Raw Bits of the Float
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+/**
+ * Double argument conversion, stored as float to keep records small.
+ *
+ * @param double value				Argument value
+ *
+ * @return uint32_t
+ */
+uint32_t DLOG_arg_double(double value)
+{
+	return DLOG_arg_float((float)value);
+}
+
+/**
+ * Integer argument conversion.
+ *
+ * @param uint32_t value			Argument value
+ *
+ * @return uint32_t
+ */
+uint32_t DLOG_arg_int(uint32_t value)
+{
+	return value;
+}
+
+/**
+ * Method for initialising the debug log.
+ *
+ * @param dlog_write_t write		Function sending the encoded records, it must
+ *									be done with the data when it returns
+ *
+ * @return void
+ */
+void DLOG_init(dlog_write_t write)
+{
+	// Set the Output Function
+	dlogWrite = write;
+}
+
+/**
+ * Method for storing a log record. Safe to call from interrupts.
+ *
+ * @param uint32_t id				Address of the format string
+ * @param const uint32_t *args		Argument values
+ * @param uint8_t nargs				Number of arguments
+ *
+ * @return bool						False when the record was dropped
+ */
+bool DLOG_record(uint32_t id, const uint32_t *args, uint8_t nargs)
+{
+	// Record Size and Position
+	uint32_t size = DLOG_RECORD_SIZE(nargs);
+	uint32_t pos;
+	bool reserved = false;
+	
+	// Reserve Space, Interrupts are Only Held Off for the Index Update
+	CRITICAL_SECTION_ENTER()
+	if (DLOG_BUFFER_SIZE - (dlogWriteIndex - dlogReadIndex) >= size)
+	{
+		pos = dlogWriteIndex;
+		dlogWriteIndex += size;
+		dlogBuffer[pos & (DLOG_BUFFER_SIZE - 1)] = 0;
+		reserved = true;
+	}
+	else
+	{
+		dlogDropped++;
+	}
+	CRITICAL_SECTION_LEAVE()
+	
+	// Check if the Buffer was Full
+	if (!reserved)
+	{
+		return false;
+	}
+	
+	// Store the ID
+	dlogBuffer[(pos + 1) & (DLOG_BUFFER_SIZE - 1)] = (uint8_t)id;
+	dlogBuffer[(pos + 2) & (DLOG_BUFFER_SIZE - 1)] = (uint8_t)(id >> 8);
+	
+	// Store the Arguments
+	for (uint8_t i = 0; i < nargs; i++)
+	{
+		for (uint8_t b = 0; b < 4; b++)
+		{
+			dlogBuffer[(pos + 3 + 4 * i + b) & (DLOG_BUFFER_SIZE - 1)] = (uint8_t)(args[i] >> (8 * b));
+		}
+	}
+	
+	// Mark the Record Complete, After Everything Else is Stored
+	__asm volatile("" ::: "memory");
+	dlogBuffer[pos & (DLOG_BUFFER_SIZE - 1)] = DLOG_RECORD_VALID | nargs;
+	
+	return true;
+}
+
+/**
+ * Method for sending the stored records. Call from the main loop.
+ *
+ * @return bool						True when all records have been sent
+ */
+bool DLOG_flush(void)
+{
+	// Frame Buffer
+	uint8_t frame[DLOG_FRAME_SIZE];
+	
+	// Check if we can Write
+	if (dlogWrite == NULL)
+	{
+		return false;
+	}
+	
+	// Loop over the Completed Records
+	while (dlogReadIndex != dlogWriteIndex)
+	{
+		// Read the Header
+		uint8_t header = dlogBuffer[dlogReadIndex & (DLOG_BUFFER_SIZE - 1)];
+		
+		// Stop at a Record Still Being Written
+		if (!(header & DLOG_RECORD_VALID))
+		{
+			return false;
+		}
+		
+		// Encode the Record without its Header (COBS)
+		uint32_t size = DLOG_RECORD_SIZE(header & DLOG_RECORD_NARGS_MASK);
+		uint8_t code = 1;
+		uint8_t codePos = 0;
+		uint8_t out = 1;
+		
+		for (uint32_t i = 1; i < size; i++)
+		{
+			uint8_t data = dlogBuffer[(dlogReadIndex + i) & (DLOG_BUFFER_SIZE - 1)];
+			
+			// Zeros End a Block
+			if (data == 0)
+			{
+				frame[codePos] = code;
+				codePos = out++;
+				code = 1;
+			}
+			else
+			{
+				frame[out++] = data;
+				code++;
+			}
+		}
+		
+		// Close the Last Block and Add the Delimiter
+		frame[codePos] = code;
+		frame[out++] = 0x00;
+		
+		// Release the Record
+		dlogReadIndex += size;
+		
+		// Send the Frame
+		dlogWrite(frame, out);
+	}
+	
+	return true;
+}
+
+/**
+ * Method for reading the number of records lost on buffer full.
+ *
+ * @return uint32_t
+ */
+uint32_t DLOG_dropped(void)
+{
+	return dlogDropped;
+}
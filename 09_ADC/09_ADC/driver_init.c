@@ -17,7 +17,12 @@
 
 struct adc_sync_descriptor BATTERY_ADC;
 
-struct usart_sync_descriptor TARGET_IO;
+/*! The buffer size for USART */
+#define TARGET_IO_BUFFER_SIZE 16
+
+struct usart_async_descriptor TARGET_IO;
+
+static uint8_t TARGET_IO_buffer[TARGET_IO_BUFFER_SIZE];
 
 void BATTERY_ADC_PORT_init(void)
 {
@@ -46,24 +51,40 @@ void BATTERY_ADC_init(void)
 	adc_sync_init(&BATTERY_ADC, ADC, (void *)NULL);
 }
 
-void TARGET_IO_PORT_init(void)
+/**
+ * \brief USART Clock initialization function
+ *
+ * Enables register interface and peripheral clock
+ */
+void TARGET_IO_CLOCK_init()
 {
 
-	gpio_set_pin_function(PA22, PINMUX_PA22C_SERCOM3_PAD0);
-
-	gpio_set_pin_function(PA23, PINMUX_PA23C_SERCOM3_PAD1);
+	_pm_enable_bus_clock(PM_BUS_APBC, SERCOM3);
+	_gclk_enable_channel(SERCOM3_GCLK_ID_CORE, CONF_GCLK_SERCOM3_CORE_SRC);
 }
 
-void TARGET_IO_CLOCK_init(void)
+/**
+ * \brief USART pinmux initialization function
+ *
+ * Set each required pin to USART functionality
+ */
+void TARGET_IO_PORT_init()
 {
-	_pm_enable_bus_clock(PM_BUS_APBC, SERCOM3);
-	_gclk_enable_channel(SERCOM3_GCLK_ID_CORE, CONF_GCLK_SERCOM3_CORE_SRC);
+
+	gpio_set_pin_function(PA22, PINMUX_PA22C_SERCOM3_PAD0);
+
+	gpio_set_pin_function(PA23, PINMUX_PA23C_SERCOM3_PAD1);
 }
 
+/**
+ * \brief USART initialization function
+ *
+ * Enables USART peripheral, clocks and initializes USART driver
+ */
 void TARGET_IO_init(void)
 {
 	TARGET_IO_CLOCK_init();
-	usart_sync_init(&TARGET_IO, SERCOM3, (void *)NULL);
+	usart_async_init(&TARGET_IO, SERCOM3, TARGET_IO_buffer, TARGET_IO_BUFFER_SIZE, (void *)NULL);
 	TARGET_IO_PORT_init();
 }
 
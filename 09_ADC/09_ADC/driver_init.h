@@ -23,11 +23,11 @@ extern "C" {
 
 #include <hal_adc_sync.h>
 
-#include <hal_usart_sync.h>
+#include <hal_usart_async.h>
 
 extern struct adc_sync_descriptor BATTERY_ADC;
 
-extern struct usart_sync_descriptor TARGET_IO;
+extern struct usart_async_descriptor TARGET_IO;
 
 void BATTERY_ADC_PORT_init(void);
 void BATTERY_ADC_CLOCK_init(void);
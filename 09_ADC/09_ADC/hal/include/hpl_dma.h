@@ -150,6 +150,44 @@ int32_t _dma_set_data_amount(const uint8_t channel, const uint32_t amount);
  */
 int32_t _dma_enable_transaction(const uint8_t channel, const bool software_trigger);
 
+/**
+ * \brief Abort the transaction on the given channel
+ *
+ * Waits until the channel has finished the beat in progress and reads back
+ * disabled.
+ *
+ * \param[in] channel DMA channel to disable
+ *
+ * \return status of operation
+ */
+int32_t _dma_disable_transaction(const uint8_t channel);
+
+/**
+ * \brief Mark the descriptor of the given channel valid or invalid
+ *
+ * Needed for descriptors which are only reached through
+ * _dma_set_next_descriptor(), as _dma_enable_transaction() only validates the
+ * first descriptor of a channel.
+ *
+ * \param[in] channel DMA channel whose descriptor to mark
+ * \param[in] valid True to mark valid, false to mark invalid
+ *
+ * \return status of operation
+ */
+int32_t _dma_set_descriptor_valid(const uint8_t channel, const bool valid);
+
+/**
+ * \brief Retrieve the progress of the transaction on the given channel
+ *
+ * \param[in] channel DMA channel to query
+ * \param[out] remaining The number of beats left in the current block
+ * \param[out] next_channel The channel whose descriptor follows the current
+ *                          block, or -1 if the current block is the last one
+ *
+ * \return status of operation
+ */
+int32_t _dma_get_transfer_progress(const uint8_t channel, uint32_t *const remaining, int8_t *const next_channel);
+
 /**
  * \brief Retrieves DMA resource structure
  *
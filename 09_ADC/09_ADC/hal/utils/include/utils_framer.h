@@ -0,0 +1,157 @@
+/**
+ * \file
+ *
+ * \brief Framed message receiver declaration.
+ *
+ * Copyright (c) 2014-2018 Microchip Technology Inc. and its subsidiaries.
+ *
+ * \asf_license_start
+ *
+ * \page License
+ *
+ * Subject to your compliance with these terms, you may use Microchip
+ * software and any derivatives exclusively with Microchip products.
+ * It is your responsibility to comply with third party license terms applicable
+ * to your use of third party software (including open source software) that
+ * may accompany Microchip software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES,
+ * WHETHER EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE,
+ * INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY,
+ * AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL MICROCHIP BE
+ * LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR CONSEQUENTIAL
+ * LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO THE
+ * SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE
+ * POSSIBILITY OR THE DAMAGES ARE FORESEEABLE.  TO THE FULLEST EXTENT
+ * ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN ANY WAY
+ * RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+ * THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+ *
+ * \asf_license_stop
+ *
+ */
+#ifndef _UTILS_FRAMER_H_INCLUDED
+#define _UTILS_FRAMER_H_INCLUDED
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \addtogroup doc_driver_hal_utils_framer
+ *
+ * @{
+ */
+
+#include "compiler.h"
+#include "utils_assert.h"
+#include "utils_ringbuffer.h"
+
+/**
+ * \brief Frame format
+ */
+enum framer_mode {
+	/** Frames are terminated by a delimiter character, which is not part of
+	 *  the frame. Empty frames are ignored */
+	FRAMER_DELIMITER,
+	/** Frames start with their length as a 16-bit big-endian value */
+	FRAMER_LENGTH_PREFIX,
+	/** Frames are COBS encoded and terminated by 0x00, they are decoded in
+	 *  place */
+	FRAMER_COBS
+};
+
+/**
+ * \brief Received frame
+ *
+ * The frame is located in the ring buffer, so it can be split in two spans
+ * when it wraps around the end of the buffer. The second span is empty
+ * otherwise.
+ */
+struct framer_frame {
+	const uint8_t *data[2];   /** Frame spans */
+	uint16_t       length[2]; /** Number of bytes in each span */
+	uint16_t       size;      /** Total number of bytes in the frame */
+};
+
+struct framer;
+
+/**
+ * \brief Frame received callback type
+ *
+ * The frame is released from the ring buffer when the callback returns, its
+ * spans must not be accessed afterwards.
+ */
+typedef void (*framer_cb_t)(const struct framer *const fr, const struct framer_frame *const frame);
+
+/**
+ * \brief Framer element type
+ */
+struct framer {
+	struct ringbuffer *rb;        /** Ring buffer the frames are received in */
+	framer_cb_t        cb;        /** Frame received callback */
+	enum framer_mode   mode;      /** Frame format */
+	uint8_t            delimiter; /** Frame delimiter in FRAMER_DELIMITER mode */
+	uint16_t           max_frame; /** Longest frame accepted */
+	uint32_t           start;     /** Ring buffer index of the frame start */
+	uint32_t           scan;      /** Ring buffer index of the next byte to parse */
+	uint32_t           out;       /** Ring buffer index of the next decoded byte */
+	uint32_t           skip;      /** Number of bytes left to discard */
+	uint16_t           expected;  /** Frame length in FRAMER_LENGTH_PREFIX mode */
+	uint8_t            cobs_run;  /** Bytes left in the current COBS block */
+	bool               cobs_zero; /** Current COBS block ends in a zero */
+	bool               discard;   /** Data is discarded up to the next delimiter */
+	uint32_t           frames;    /** Number of frames received */
+	uint32_t           dropped;   /** Number of frames dropped */
+};
+
+/**
+ * \brief Framer initialization
+ *
+ * \param[in] fr The pointer to a framer structure instance
+ * \param[in] rb The ring buffer to take the frames from, the framer must be
+ *               its only reader
+ * \param[in] mode The frame format
+ * \param[in] delimiter The frame delimiter, used in FRAMER_DELIMITER mode only
+ * \param[in] max_frame The longest frame accepted, longer frames are dropped.
+ *                      Must leave room for the frame header in the buffer
+ * \param[in] cb The frame received callback
+ *
+ * \return ERR_NONE on success, or an error code on failure.
+ */
+int32_t framer_init(struct framer *const fr, struct ringbuffer *const rb, const enum framer_mode mode,
+                    const uint8_t delimiter, const uint16_t max_frame, framer_cb_t cb);
+
+/**
+ * \brief Parse the data added to the ring buffer since the previous call
+ *
+ * Complete frames are handed to the callback and released from the ring
+ * buffer, as are the bytes of dropped frames. Parsing restarts at the oldest
+ * data when the frame in progress has been overwritten or flushed, frames
+ * are dropped until the next delimiter then.
+ * The user needs to handle the concurrent access on the buffer.
+ *
+ * \param[in] fr The pointer to a framer structure instance
+ *
+ * \return The number of frames received.
+ */
+uint32_t framer_process(struct framer *const fr);
+
+/**
+ * \brief Copy a received frame into a linear buffer
+ *
+ * \param[in] frame The received frame
+ * \param[out] buf The buffer to copy to
+ * \param[in] length The size of the buffer
+ *
+ * \return The number of bytes copied, the frame is truncated when it does not
+ *         fit.
+ */
+uint16_t framer_frame_copy(const struct framer_frame *const frame, uint8_t *const buf, const uint16_t length);
+
+/**@}*/
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _UTILS_FRAMER_H_INCLUDED */
@@ -1,5 +1,5 @@
 #include <atmel_start.h>
-#include <stdio.h>
+#include "debug_log.h"
 
 // ADC Calculation Defs
 #define ADC_REF 3300
@@ -56,16 +56,23 @@ int main(void)
 	
 	// Enable UART
 	struct io_descriptor *io;
-	usart_sync_get_io_descriptor(&TARGET_IO, &io);
-	usart_sync_enable(&TARGET_IO);
+	usart_async_get_io_descriptor(&TARGET_IO, &io);
+	usart_async_enable(&TARGET_IO);
+	
+	// Send the Debug Log through the Buffered Output
+	DLOG_init(stdio_io_write);
 
 	/* Replace with your application code */
 	while (1) {
 		// Read the Battery Voltage
 		read_battery_level();
 		
-		// Print the Reading
-		printf("Battery reading at %0.2f volts\r\n", battery_voltage);
+		// Log the Reading, Formatted on the Host
+		DLOG("Battery reading at %0.2f volts\r\n", battery_voltage);
+		DLOG_flush();
+		
+		// Send it now, binary frames do not end in a newline to start the Output
+		stdio_io_flush();
 		
 		// Delay by 5 Seconds
 		delay_ms(5000);
@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+"""
+Decoder for the deferred binary debug log (debug_log.c).
+
+Reads COBS framed log records from a serial port or a capture file and
+expands them to text with the format strings from the .logstr section of
+the firmware ELF file.
+
+    dlog_decode.py Debug/09_ADC.elf /dev/ttyACM0 --baud 19200
+    dlog_decode.py Debug/09_ADC.elf capture.bin
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+SPEC = re.compile(r'%([-+ #0]*\d*(?:\.\d+)?)(hh|h|ll|l|j|z|t|L)?([diouxXcfFeEgGaAs%])')
+
+
+def load_format_strings(path):
+    """Return the .logstr section and its address from an ELF32 file."""
+    with open(path, 'rb') as f:
+        elf = f.read()
+    if elf[:4] != b'\x7fELF' or elf[4] != 1 or elf[5] != 1:
+        raise ValueError('%s is not a little-endian ELF32 file' % path)
+
+    shoff, = struct.unpack_from('<I', elf, 0x20)
+    shentsize, shnum, shstrndx = struct.unpack_from('<HHH', elf, 0x2E)
+
+    def section(index):
+        # name, type, flags, addr, offset, size
+        return struct.unpack_from('<IIIIII', elf, shoff + index * shentsize)
+
+    names = section(shstrndx)[4]
+    for i in range(shnum):
+        name, _, _, addr, offset, size = section(i)
+        end = elf.index(b'\0', names + name)
+        if elf[names + name:end] == b'.logstr':
+            return addr, elf[offset:offset + size]
+    raise ValueError('%s has no .logstr section' % path)
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data) + 1:
+            raise ValueError('malformed frame')
+        out += data[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def expand(fmt, args):
+    """printf-style expansion of 32-bit raw argument values."""
+    values = iter(args)
+
+    def convert(m):
+        flags, _, conv = m.groups()
+        if conv == '%':
+            return '%'
+        try:
+            raw = next(values)
+        except StopIteration:
+            return '<missing>'
+        if conv in 'di':
+            return ('%' + flags + 'd') % struct.unpack('<i', struct.pack('<I', raw))[0]
+        if conv in 'fFeEgGaA':
+            conv = 'f' if conv in 'aA' else conv
+            return ('%' + flags + conv) % struct.unpack('<f', struct.pack('<I', raw))[0]
+        if conv == 'c':
+            return ('%' + flags + 'c') % chr(raw & 0xFF)
+        if conv == 's':
+            return '<0x%08x>' % raw
+        return ('%' + flags + conv) % raw
+
+    return SPEC.sub(convert, fmt)
+
+
+def decode_frame(frame, base, strings):
+    record = cobs_decode(frame)
+    if len(record) < 2 or (len(record) - 2) % 4:
+        raise ValueError('bad record length %d' % len(record))
+    ident, = struct.unpack_from('<H', record)
+    offset = (ident - base) & 0xFFFF
+    if offset >= len(strings):
+        raise ValueError('unknown format string 0x%04x' % ident)
+    fmt = strings[offset:strings.index(b'\0', offset)].decode('ascii', 'replace')
+    args = struct.unpack_from('<%dI' % ((len(record) - 2) // 4), record, 2)
+    return expand(fmt, args)
+
+
+def open_input(path, baud):
+    fd = os.open(path, os.O_RDONLY | getattr(os, 'O_NOCTTY', 0))
+    if os.isatty(fd):
+        import termios
+        import tty
+        tty.setraw(fd)
+        if baud:
+            attrs = termios.tcgetattr(fd)
+            speed = getattr(termios, 'B%d' % baud)
+            attrs[4] = attrs[5] = speed
+            termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    return os.fdopen(fd, 'rb', buffering=0)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('elf', help='firmware ELF file the records were produced by')
+    parser.add_argument('input', nargs='?', help='serial port or capture file, stdin if omitted')
+    parser.add_argument('--baud', type=int, help='serial port baud rate')
+    opts = parser.parse_args()
+
+    base, strings = load_format_strings(opts.elf)
+    stream = open_input(opts.input, opts.baud) if opts.input else sys.stdin.buffer
+
+    frame = bytearray()
+    while True:
+        data = stream.read(1)
+        if not data:
+            break
+        if data[0]:
+            frame += data
+            continue
+        if frame:
+            try:
+                text = decode_frame(bytes(frame), base, strings)
+            except ValueError as e:
+                text = '<%s>' % e
+            sys.stdout.write(text if text.endswith('\n') else text + '\n')
+            sys.stdout.flush()
+        frame = bytearray()
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,455 @@
+/*
+ * Flash path benchmark for 04_SPIFLASH.
+ *
+ * Runs ext_flash.c and flash_log.c unchanged against the simulated SPI NOR
+ * device and reports throughput, bus utilisation, bus bytes per payload byte
+ * and the latency distribution of each call, in simulated time. The data
+ * written is checked against the device array, and the run fails if the
+ * driver broke the device protocol (instructions sent while busy, without
+ * write enable, in deep power-down or against the suspend rules, bytes
+ * clocked with CS high).
+ *
+ * Build and run from the top of the repository:
+ *
+ *     cc -O2 -Itools/flashsim/include -I04_SPIFLASH/04_SPIFLASH \
+ *         tools/flashsim/flashbench.c tools/flashsim/hal_sim.c \
+ *         tools/flashsim/spi_nor_sim.c 04_SPIFLASH/04_SPIFLASH/ext_flash.c \
+ *         04_SPIFLASH/04_SPIFLASH/flash_log.c 04_SPIFLASH/04_SPIFLASH/crc.c \
+ *         04_SPIFLASH/04_SPIFLASH/spi_bus.c -o flashbench
+ *     ./flashbench [--sfdp]
+ *
+ * Add -DCONF_SERCOM_5_SPI_BAUD=, -DFLASH_CACHE_PAGES=, -DFLASH_WRITE_COMBINE=
+ * or -DFLASH_WRITE_FLUSH_MS= to the build to compare settings. The SPI clock
+ * can be at most half of CONF_GCLK_SERCOM5_CORE_FREQUENCY (1 MHz), raise it
+ * with -DCONF_GCLK_SERCOM5_CORE_FREQUENCY= for faster clocks.
+ */
+
+// Include the Driver under Test and the Simulation
+#include "ext_flash.h"
+#include "flash_log.h"
+#include "hal_sim.h"
+#include "spi_nor_sim.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Most Calls timed per Measurement
+#define BENCH_MAX_OPS				512
+
+// Areas of the Device
+#define BENCH_READ_AREA				0x00000	// Preloaded data for the reads
+#define BENCH_READ_AREA_SIZE		0x40000
+#define BENCH_WRITE_AREA			0x40000	// Erased before every write run
+#define BENCH_WRITE_AREA_SIZE		0x40000
+#define BENCH_ERASE_AREA			0x80000
+#define BENCH_HOT_SET				0x800	// Reads that should stay in the cache
+
+// Pause before each idle call, long enough for the device to be powered down
+#define BENCH_IDLE_MS				(FLASH_POWER_DOWN_MS + 10)
+
+// Kinds of Call
+typedef enum
+{
+	BENCH_READ,
+	BENCH_READ_CACHED,
+	BENCH_READ_IDLE,
+	BENCH_READ_ERASING,
+	BENCH_WRITE,
+	BENCH_WRITE_IDLE,
+	BENCH_ERASE,
+	BENCH_ERASE_IDLE,
+	BENCH_CRC,
+	BENCH_LOG_APPEND
+} benchOp_t;
+
+// Latency Samples
+static uint64_t samples[BENCH_MAX_OPS];
+
+// Data Buffers
+static uint8_t data[0x10000];
+static uint8_t check[0x10000];
+
+// Random Number State (fixed seed so runs compare)
+static uint32_t seed = 1;
+
+// Set when a check failed
+static bool failed = false;
+
+// Asynchronous Operations that did not complete
+static uint32_t asyncFailures = 0;
+
+/**
+ * Small deterministic random number generator.
+ *
+ * @return uint32_t
+ */
+static uint32_t BENCH_random(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+/**
+ * Completion callback of the asynchronous operations.
+ *
+ * @param extFlashResult_t result		Result of the operation.
+ *
+ * @return void
+ */
+static void BENCH_async_cb(extFlashResult_t result)
+{
+	if (result != EXTFLASH_OK)
+	{
+		asyncFailures++;
+	}
+}
+
+/**
+ * Sort helper for the latency samples.
+ *
+ * @return int
+ */
+static int BENCH_compare(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a;
+	uint64_t y = *(const uint64_t *)b;
+	
+	return (x > y) - (x < y);
+}
+
+/**
+ * Carry out one call of a measurement.
+ *
+ * @param benchOp_t op					Kind of call.
+ * @param uint32_t size					Payload bytes per call.
+ * @param uint32_t i					Number of the call.
+ *
+ * @return bool
+ */
+static bool BENCH_call(benchOp_t op, uint32_t size, uint32_t i)
+{
+	uint32_t offset;
+	uint16_t crc;
+	
+	switch (op)
+	{
+		case BENCH_READ_ERASING:
+			// Keep a 64K erase running under the reads
+			if (!EXTFLASH_isBusy() && !EXTFLASH_erase_async(BENCH_ERASE_AREA, 0x10000, NULL))
+			{
+				return false;
+			}
+			// fall through
+	
+		case BENCH_READ:
+		case BENCH_READ_IDLE:
+			offset = BENCH_READ_AREA + BENCH_random() % (BENCH_READ_AREA_SIZE - size);
+			if (!EXTFLASH_read_uncached(offset, size, data))
+			{
+				return false;
+			}
+			if (memcmp(data, &SPINOR_memory()[offset], size))
+			{
+				printf("read back wrong data at 0x%06X\n", (unsigned)offset);
+				failed = true;
+			}
+			return true;
+	
+		case BENCH_READ_CACHED:
+			offset = BENCH_READ_AREA + BENCH_random() % (BENCH_HOT_SET - (size < BENCH_HOT_SET ? size : 0) + 1);
+			if (!EXTFLASH_read(offset, size, data))
+			{
+				return false;
+			}
+			if (memcmp(data, &SPINOR_memory()[offset], size))
+			{
+				printf("cached read wrong data at 0x%06X\n", (unsigned)offset);
+				failed = true;
+			}
+			return true;
+	
+		case BENCH_WRITE:
+		case BENCH_WRITE_IDLE:
+			// Sequential writes, like a log
+			offset = BENCH_WRITE_AREA + i * size;
+			memcpy(data, &check[(i * size) % sizeof(check)], size);
+			return EXTFLASH_write(offset, size, data);
+	
+		case BENCH_ERASE:
+			return EXTFLASH_erase(BENCH_ERASE_AREA + i * size, size);
+		
+		case BENCH_ERASE_IDLE:
+			return EXTFLASH_erase_async(BENCH_ERASE_AREA + i * size, size, BENCH_async_cb);
+	
+		case BENCH_CRC:
+			// Check whole pages of the read area, as after programming them
+			offset = BENCH_READ_AREA + (BENCH_random() % (BENCH_READ_AREA_SIZE / size)) * size;
+			crc = CRC16_INIT;
+			if (!EXTFLASH_crc16(offset, size, &crc))
+			{
+				return false;
+			}
+			if (crc != CRC_crc16(CRC16_INIT, &SPINOR_memory()[offset], size))
+			{
+				printf("wrong CRC at 0x%06X\n", (unsigned)offset);
+				failed = true;
+			}
+			return true;
+			
+		case BENCH_LOG_APPEND:
+			memset(data, 'A' + (i % 26), size);
+			return FLASHLOG_append(data, size);
+	
+		default:
+			return false;
+	}
+}
+
+/**
+ * Time a run of calls and print a result line.
+ *
+ * @param const char *name				Name of the measurement.
+ * @param benchOp_t op					Kind of call.
+ * @param uint32_t size					Payload bytes per call.
+ * @param uint32_t ops					Number of calls.
+ *
+ * @return void
+ */
+static void BENCH_measure(const char *name, benchOp_t op, uint32_t size, uint32_t ops)
+{
+	extFlashCacheStats_t cacheBefore, cacheAfter;
+	uint64_t start, busStart, busBytesStart, elapsed, bus, busBytes;
+	uint64_t idle = 0, idleBus = 0, idleBusBytes = 0;
+	bool idleFirst = (op == BENCH_READ_IDLE || op == BENCH_WRITE_IDLE || op == BENCH_ERASE_IDLE);
+	bool writing = (op == BENCH_WRITE || op == BENCH_WRITE_IDLE);
+	uint32_t failures = asyncFailures;
+	char rate[16], load[16];
+	uint32_t i;
+	
+	// Start from an erased write area
+	if (writing && !EXTFLASH_erase(BENCH_WRITE_AREA, BENCH_WRITE_AREA_SIZE))
+	{
+		printf("%-14s setup erase failed\n", name);
+		failed = true;
+		return;
+	}
+	
+	// Let the device finish the previous run first
+	while (SPINOR_isBusy())
+	{
+		SIM_advance(100000);
+	}
+	
+	EXTFLASH_cacheStats(&cacheBefore);
+	start = SIM_now();
+	busStart = SIM_busTime();
+	busBytesStart = SPINOR_stats()->busBytes;
+	
+	for (i = 0; i < ops; i++)
+	{
+		uint64_t t = SIM_now();
+	
+		// Leave the Device idle, the pause (and the power-down and background work in it) does not count towards the run
+		if (idleFirst)
+		{
+			uint64_t b = SIM_busTime(), bb = SPINOR_stats()->busBytes;
+	
+			while (EXTFLASH_isBusy())
+			{
+				SIM_advance(100000);
+			}
+			SIM_advance((uint64_t)BENCH_IDLE_MS * 1000000);
+			idle += SIM_now() - t;
+			idleBus += SIM_busTime() - b;
+			idleBusBytes += SPINOR_stats()->busBytes - bb;
+			t = SIM_now();
+		}
+	
+		if (!BENCH_call(op, size, i))
+		{
+			printf("%-14s %6u call %u failed\n", name, (unsigned)size, (unsigned)i);
+			failed = true;
+			return;
+		}
+		samples[i] = SIM_now() - t;
+	}
+	
+	// Staged writes count towards the run
+	if (writing || op == BENCH_LOG_APPEND)
+	{
+		EXTFLASH_flush();
+	}
+	
+	elapsed = SIM_now() - start - idle;
+	bus = SIM_busTime() - busStart - idleBus;
+	busBytes = SPINOR_stats()->busBytes - busBytesStart - idleBusBytes;
+	EXTFLASH_cacheStats(&cacheAfter);
+	
+	// Let a background Erase finish
+	while (EXTFLASH_isBusy())
+	{
+		SIM_advance(100000);
+	}
+	
+	// Check the written Data, the pattern repeats every sizeof(check) bytes
+	if (writing)
+	{
+		for (i = 0; i < ops * size; i += sizeof(check))
+		{
+			uint32_t length = ops * size - i < sizeof(check) ? ops * size - i : sizeof(check);
+	
+			if (memcmp(&SPINOR_memory()[BENCH_WRITE_AREA + i], check, length))
+			{
+				printf("%-14s %6u written data does not match\n", name, (unsigned)size);
+				failed = true;
+				break;
+			}
+		}
+	}
+	
+	// Check the Erases run in the Background
+	if (op == BENCH_ERASE_IDLE)
+	{
+		if (asyncFailures != failures)
+		{
+			printf("%-14s %6u %u erases failed\n", name, (unsigned)size, (unsigned)(asyncFailures - failures));
+			failed = true;
+		}
+		for (i = 0; i < ops * size; i++)
+		{
+			if (SPINOR_memory()[BENCH_ERASE_AREA + i] != 0xFF)
+			{
+				printf("%-14s %6u not erased at 0x%06X\n", name, (unsigned)size, (unsigned)(BENCH_ERASE_AREA + i));
+				failed = true;
+				break;
+			}
+		}
+	}
+	
+	// Runs served from the cache take no simulated time
+	if (elapsed)
+	{
+		snprintf(rate, sizeof(rate), "%.2f", (double)size * ops / 1024.0 / (elapsed / 1e9));
+		snprintf(load, sizeof(load), "%.1f%%", 100.0 * bus / elapsed);
+	}
+	else
+	{
+		strcpy(rate, "-");
+		strcpy(load, "-");
+	}
+	
+	// Latency Distribution
+	qsort(samples, ops, sizeof(samples[0]), BENCH_compare);
+	printf("%-14s %6u %5u %10s %7s %6.2f %9.3f %9.3f %9.3f %9.3f %5u/%-5u\n",
+		name, (unsigned)size, (unsigned)ops, rate, load,
+		(double)busBytes / ((double)size * ops),
+		samples[0] / 1e6, samples[ops / 2] / 1e6, samples[(ops * 99) / 100] / 1e6, samples[ops - 1] / 1e6,
+		(unsigned)(cacheAfter.hits - cacheBefore.hits), (unsigned)(cacheAfter.misses - cacheBefore.misses));
+}
+
+int main(int argc, char *argv[])
+{
+	static const uint32_t sizes[] = { 1, 16, 64, 256, 1024, 4096 };
+	spiNorConfig_t config = SPINOR_AT25DF081A;
+	const extFlashInfo_t *info;
+	const spiNorStats_t *stats;
+	extFlashPowerStats_t power;
+	uint32_t i;
+	
+	// Device with or without SFDP Tables
+	if (argc > 1 && strcmp(argv[1], "--sfdp") == 0)
+	{
+		config.sfdp = true;
+	}
+	SPINOR_reset(&config);
+	
+	// Preload the Read Area, and the Pattern for the Writes
+	for (i = 0; i < BENCH_READ_AREA_SIZE; i++)
+	{
+		SPINOR_memory()[BENCH_READ_AREA + i] = BENCH_random();
+	}
+	for (i = 0; i < sizeof(check); i++)
+	{
+		check[i] = BENCH_random();
+	}
+	
+	// Bring up the Driver
+	EXTFLASH_init();
+	if (!EXTFLASH_open())
+	{
+		printf("EXTFLASH_open failed\n");
+		return 1;
+	}
+	info = EXTFLASH_getInfo();
+	printf("SPI clock %u Hz, %u Kbyte device, page %u, smallest erase %u (%s)\n",
+		(unsigned)FLASH_SPI_FREQUENCY, (unsigned)(info->deviceSize / 1024), (unsigned)info->pageSize,
+		(unsigned)info->eraseTypes[0].size, info->sfdp ? "SFDP" : "table");
+	printf("read cache %u pages, write combining %s, deep power-down after %u ms\n\n",
+		(unsigned)FLASH_CACHE_PAGES, FLASH_WRITE_COMBINE ? "on" : "off", (unsigned)FLASH_POWER_DOWN_MS);
+	
+	printf("%-14s %6s %5s %10s %7s %6s %9s %9s %9s %9s %s\n",
+		"call", "bytes", "ops", "KB/s", "bus", "bus/B", "min ms", "p50 ms", "p99 ms", "max ms", "hit/miss");
+	
+	// Reads
+	for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+	{
+		BENCH_measure("read", BENCH_READ, sizes[i], sizes[i] >= 1024 ? 32 : 256);
+	}
+	for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+	{
+		BENCH_measure("read cached", BENCH_READ_CACHED, sizes[i], sizes[i] >= 1024 ? 32 : 256);
+	}
+	BENCH_measure("read idle", BENCH_READ_IDLE, 16, 32);
+	BENCH_measure("read erasing", BENCH_READ_ERASING, 16, 256);
+	
+	// Programs
+	for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+	{
+		BENCH_measure("write", BENCH_WRITE, sizes[i], sizes[i] >= 1024 ? 32 : 256);
+	}
+	BENCH_measure("write idle", BENCH_WRITE_IDLE, 16, 32);
+	
+	// Erases
+	BENCH_measure("erase", BENCH_ERASE, 0x1000, 4);
+	BENCH_measure("erase", BENCH_ERASE, 0x8000, 4);
+	BENCH_measure("erase", BENCH_ERASE, 0x10000, 4);
+	BENCH_measure("erase idle", BENCH_ERASE_IDLE, 0x1000, 4);
+	
+	// Page Checks
+	BENCH_measure("crc", BENCH_CRC, 256, 64);
+	BENCH_measure("crc", BENCH_CRC, 4096, 16);
+	
+	// Record Log
+	if (!FLASHLOG_mount())
+	{
+		printf("FLASHLOG_mount failed\n");
+		return 1;
+	}
+	BENCH_measure("log append", BENCH_LOG_APPEND, 16, 512);
+	BENCH_measure("log append", BENCH_LOG_APPEND, FLASHLOG_MAX_DATA, 512);
+	
+	// Protocol Errors
+	stats = SPINOR_stats();
+	printf("\n%u transactions, %u reads, %u programs, %u erases, %u status polls\n",
+		(unsigned)stats->transactions, (unsigned)stats->reads, (unsigned)stats->programs,
+		(unsigned)stats->erases, (unsigned)stats->statusPolls);
+	EXTFLASH_powerStats(&power);
+	printf("%u deep power-downs, %u wakes, %u ms powered down\n",
+		(unsigned)power.powerDowns, (unsigned)power.wakes, (unsigned)power.downMs);
+	if (power.powerDowns != stats->powerDowns || power.wakes > stats->resumes)
+	{
+		printf("device saw %u power-downs and %u resumes\n", (unsigned)stats->powerDowns, (unsigned)stats->resumes);
+		failed = true;
+	}
+	printf("%u programs / erases suspended for reads\n", (unsigned)stats->suspends);
+	if (stats->busyIgnored || stats->welIgnored || stats->sleepIgnored || stats->suspendIgnored || stats->strayBytes)
+	{
+		printf("protocol errors: %u while busy, %u without write enable, %u in deep power-down, %u against suspend, %u stray bytes\n",
+			(unsigned)stats->busyIgnored, (unsigned)stats->welIgnored, (unsigned)stats->sleepIgnored,
+			(unsigned)stats->suspendIgnored, (unsigned)stats->strayBytes);
+		failed = true;
+	}
+	
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,325 @@
+// Include Simulated HAL Header Files
+#include "driver_init.h"
+#include "hal_sim.h"
+#include "spi_nor_sim.h"
+
+// SPI Clock of the simulated Bus
+#include <hpl_sercom_config.h>
+#include <peripheral_clk_config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Drivers used by ext_flash.c
+struct timer_descriptor TIMER;
+struct spi_m_dma_descriptor SERIALFLASH;
+
+// Simulated Time
+static uint64_t now = 0;
+static uint64_t nextTick = 1000000;
+static uint64_t busTime = 0;
+
+// Set while a simulated interrupt runs, so TIMER does not preempt it
+static bool inIrq = false;
+
+/**
+ * Run the TIMER tasks that are due, as the TC interrupt would.
+ *
+ * @return void
+ */
+static void SIM_timerTick(void)
+{
+	struct timer_task *task;
+	struct timer_task **link;
+	
+	TIMER.time++;
+	
+	// Callbacks may add or remove tasks, so look for one due task at a time
+	do
+	{
+		for (link = &TIMER.tasks; (task = *link) != NULL; link = &task->next)
+		{
+			if (TIMER.time - task->time_label >= task->interval)
+			{
+				break;
+			}
+		}
+	
+		if (task)
+		{
+			// Take the Task off, a repeating one goes back on
+			*link = task->next;
+			task->next = NULL;
+			if (task->mode == TIMER_TASK_REPEAT)
+			{
+				timer_add_task(&TIMER, task);
+			}
+	
+			task->cb(task);
+		}
+	} while (task);
+}
+
+/**
+ * Get the simulated time.
+ *
+ * @return uint64_t						Nanoseconds since the start
+ */
+uint64_t SIM_now(void)
+{
+	return now;
+}
+
+/**
+ * Move the simulated time on, running TIMER on every millisecond passed
+ * unless a simulated interrupt is already running.
+ *
+ * @param uint64_t ns					Nanoseconds to move on.
+ *
+ * @return void
+ */
+void SIM_advance(uint64_t ns)
+{
+	uint64_t target = now + ns;
+	
+	while (!inIrq && nextTick <= target)
+	{
+		now = nextTick;
+		nextTick += 1000000;
+	
+		inIrq = true;
+		SIM_timerTick();
+		inIrq = false;
+	}
+	
+	// A tick task may have used up the time already
+	if (now < target)
+	{
+		now = target;
+	}
+}
+
+/**
+ * Get the time the SPI bus has spent clocking.
+ *
+ * @return uint64_t						Nanoseconds
+ */
+uint64_t SIM_busTime(void)
+{
+	return busTime;
+}
+
+/**
+ * Drive a pin, SERIALFLASH_CS selects the simulated device.
+ *
+ * @return void
+ */
+void gpio_set_pin_level(const uint8_t pin, const bool level)
+{
+	if (pin == SERIALFLASH_CS)
+	{
+		SPINOR_select(!level);
+	}
+}
+
+/**
+ * Busy waits pass simulated time.
+ *
+ * @return void
+ */
+void delay_us(const uint16_t us)
+{
+	SIM_advance((uint64_t)us * 1000);
+}
+
+void delay_ms(const uint16_t ms)
+{
+	SIM_advance((uint64_t)ms * 1000000);
+}
+
+/**
+ * The simulated SERCOM needs no enabling.
+ *
+ * @return void
+ */
+void spi_m_dma_enable(struct spi_m_dma_descriptor *spi)
+{
+}
+
+void spi_m_dma_disable(struct spi_m_dma_descriptor *spi)
+{
+}
+
+/**
+ * Keep the BAUD register value, the bus time of a transfer follows it.
+ *
+ * @return int32_t
+ */
+int32_t spi_m_dma_set_baudrate(struct spi_m_dma_descriptor *spi, const uint32_t baud_val)
+{
+	spi->baud = baud_val + 1;
+	return ERR_NONE;
+}
+
+/**
+ * The simulated device samples in any mode, only 8 bit characters are
+ * supported (as by the DMA driver).
+ *
+ * @return int32_t
+ */
+int32_t spi_m_dma_set_mode(struct spi_m_dma_descriptor *spi, const enum spi_transfer_mode mode)
+{
+	return ERR_NONE;
+}
+
+int32_t spi_m_dma_set_char_size(struct spi_m_dma_descriptor *spi, const enum spi_char_size char_size)
+{
+	return (char_size == SPI_CHAR_SIZE_8) ? ERR_NONE : ERR_INVALID_ARG;
+}
+
+/**
+ * Clock a transfer through the simulated device. The bus time passes while
+ * it runs, at the clock set by spi_m_dma_set_baudrate (CONF_SERCOM_5_SPI_BAUD
+ * until then), then the completion callback is called as from the DMAC
+ * interrupt. Without a write buffer the dummy byte (0xFF) is sent.
+ *
+ * @return int32_t
+ */
+int32_t spi_m_dma_transfer(struct spi_m_dma_descriptor *spi, uint8_t const *txbuf, uint8_t *const rxbuf, const uint16_t length)
+{
+	uint64_t clock = spi->baud ? CONF_GCLK_SERCOM5_CORE_FREQUENCY / (2 * spi->baud) : CONF_SERCOM_5_SPI_BAUD;
+	uint64_t ns = (uint64_t)length * 8 * 1000000000 / clock;
+	uint16_t i;
+	
+	if (spi->stat & SPI_M_DMA_STATUS_BUSY)
+	{
+		return ERR_BUSY;
+	}
+	spi->stat = SPI_M_DMA_STATUS_BUSY;
+	spi->size = length;
+	
+	// Exchange the Data
+	for (i = 0; i < length; i++)
+	{
+		uint8_t miso = SPINOR_exchange(txbuf ? txbuf[i] : 0xFF);
+	
+		if (rxbuf)
+		{
+			rxbuf[i] = miso;
+		}
+	}
+	
+	// Let the Bus Time pass
+	busTime += ns;
+	SIM_advance(ns);
+	spi->stat = SPI_M_DMA_STATUS_COMPLETE;
+	
+	// Completion Interrupt
+	if (spi->cb_xfer)
+	{
+		bool nested = inIrq;
+	
+		inIrq = true;
+		spi->cb_xfer(spi);
+		inIrq = nested;
+	}
+	
+	return ERR_NONE;
+}
+
+/**
+ * Get the transfer status.
+ *
+ * @return int32_t
+ */
+int32_t spi_m_dma_get_status(struct spi_m_dma_descriptor *spi, struct spi_m_dma_status *stat)
+{
+	if (stat)
+	{
+		stat->flags = spi->stat;
+		stat->xfercnt = spi->size;
+	}
+	
+	return (spi->stat & SPI_M_DMA_STATUS_BUSY) ? ERR_BUSY : ERR_NONE;
+}
+
+/**
+ * Register the transfer complete callback, simulated transfers never fail.
+ *
+ * @return void
+ */
+void spi_m_dma_register_callback(struct spi_m_dma_descriptor *spi, const enum spi_m_dma_cb_type type, FUNC_PTR func)
+{
+	if (type == SPI_M_DMA_CB_XFER)
+	{
+		spi->cb_xfer = (spi_m_dma_cb_xfer_t)func;
+	}
+}
+
+/**
+ * Get the IO descriptor, ext_flash.c only keeps it.
+ *
+ * @return int32_t
+ */
+int32_t spi_m_dma_get_io_descriptor(struct spi_m_dma_descriptor *const spi, struct io_descriptor **io)
+{
+	*io = &spi->io;
+	return ERR_NONE;
+}
+
+/**
+ * TIMER always runs.
+ *
+ * @return int32_t
+ */
+int32_t timer_start(struct timer_descriptor *const descr)
+{
+	return ERR_NONE;
+}
+
+/**
+ * Add a task, adding one that is already queued is a driver bug (the ASF
+ * driver asserts on it).
+ *
+ * @return int32_t
+ */
+int32_t timer_add_task(struct timer_descriptor *const descr, struct timer_task *const task)
+{
+	struct timer_task *it;
+	
+	for (it = descr->tasks; it != NULL; it = it->next)
+	{
+		if (it == task)
+		{
+			fprintf(stderr, "timer_add_task: task %p is already queued\n", (void *)task);
+			abort();
+		}
+	}
+	
+	task->time_label = descr->time;
+	task->next = descr->tasks;
+	descr->tasks = task;
+	
+	return ERR_NONE;
+}
+
+/**
+ * Remove a task.
+ *
+ * @return int32_t
+ */
+int32_t timer_remove_task(struct timer_descriptor *const descr, const struct timer_task *const task)
+{
+	struct timer_task **link;
+	
+	for (link = &descr->tasks; *link != NULL; link = &(*link)->next)
+	{
+		if (*link == task)
+		{
+			*link = task->next;
+			return ERR_NONE;
+		}
+	}
+	
+	return ERR_NONE;
+}
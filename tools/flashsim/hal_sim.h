@@ -0,0 +1,21 @@
+/*
+ * Simulated time base of the host HAL (hal_sim.c).
+ *
+ * Time only moves when the driver clocks the SPI bus or waits in delay_us /
+ * delay_ms, or when the caller advances it. TIMER ticks every millisecond
+ * of it, with its tasks run as if from the TC interrupt.
+ */
+#ifndef HAL_SIM_H_
+#define HAL_SIM_H_
+
+// Include STD C Libraries
+#include <stdint.h>
+
+// Simulated Time in Nanoseconds
+extern uint64_t SIM_now(void);
+extern void SIM_advance(uint64_t ns);
+
+// Time the SPI bus spent clocking, in Nanoseconds
+extern uint64_t SIM_busTime(void);
+
+#endif
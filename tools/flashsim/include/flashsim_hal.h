@@ -0,0 +1,128 @@
+/*
+ * Host stand-in for the ASF4 HAL used by ext_flash.c and flash_log.c.
+ *
+ * The headers in this directory take the place of the HAL headers that
+ * driver_init.h includes, so the driver builds unchanged on the host. The
+ * functions are implemented in hal_sim.c on top of the simulated device in
+ * spi_nor_sim.c.
+ */
+#ifndef FLASHSIM_HAL_H_
+#define FLASHSIM_HAL_H_
+
+// Include STD C Libraries
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// ASF Types and Error Codes
+typedef void (*FUNC_PTR)(void);
+#define ERR_NONE					0
+#define ERR_BUSY					-4
+#define ERR_IO						-6
+#define ERR_INVALID_ARG				-13
+#define ERR_NOT_INITIALIZED			-20
+#define ERR_NO_RESOURCE				-28
+
+// Critical Sections, simulated interrupts only run at the calls that raise them
+#define CRITICAL_SECTION_ENTER()
+#define CRITICAL_SECTION_LEAVE()
+
+// Pin Numbering (hpl_gpio.h)
+enum gpio_port { GPIO_PORTA, GPIO_PORTB, GPIO_PORTC };
+#define GPIO(port, pin)				((((port) & 0x7u) << 5) + ((pin) & 0x1Fu))
+
+// GPIO and Delay Driver
+void gpio_set_pin_level(const uint8_t pin, const bool level);
+void delay_us(const uint16_t us);
+void delay_ms(const uint16_t ms);
+
+// IO Descriptor
+struct io_descriptor
+{
+	int32_t (*write)(struct io_descriptor *const io_descr, const uint8_t *const buf, const uint16_t length);
+	int32_t (*read)(struct io_descriptor *const io_descr, uint8_t *const buf, const uint16_t length);
+};
+
+// DMA SPI Master Driver
+#define SPI_M_DMA_STATUS_BUSY		0x0010
+#define SPI_M_DMA_STATUS_COMPLETE	0x0080
+
+enum spi_transfer_mode
+{
+	SPI_MODE_0,
+	SPI_MODE_1,
+	SPI_MODE_2,
+	SPI_MODE_3
+};
+
+enum spi_char_size
+{
+	SPI_CHAR_SIZE_8 = 0,
+	SPI_CHAR_SIZE_9 = 1
+};
+
+enum spi_m_dma_cb_type
+{
+	SPI_M_DMA_CB_XFER,
+	SPI_M_DMA_CB_ERROR,
+	SPI_M_DMA_CB_N
+};
+
+struct spi_m_dma_descriptor;
+typedef void (*spi_m_dma_cb_xfer_t)(struct spi_m_dma_descriptor *spi);
+
+struct spi_m_dma_status
+{
+	uint32_t flags;
+	int32_t xfercnt;
+};
+
+struct spi_m_dma_descriptor
+{
+	struct io_descriptor io;
+	spi_m_dma_cb_xfer_t cb_xfer;
+	volatile uint32_t stat;
+	uint16_t size;
+	uint32_t baud;						// BAUD register value + 1, 0 until set
+};
+
+void spi_m_dma_enable(struct spi_m_dma_descriptor *spi);
+void spi_m_dma_disable(struct spi_m_dma_descriptor *spi);
+int32_t spi_m_dma_set_baudrate(struct spi_m_dma_descriptor *spi, const uint32_t baud_val);
+int32_t spi_m_dma_set_mode(struct spi_m_dma_descriptor *spi, const enum spi_transfer_mode mode);
+int32_t spi_m_dma_set_char_size(struct spi_m_dma_descriptor *spi, const enum spi_char_size char_size);
+int32_t spi_m_dma_transfer(struct spi_m_dma_descriptor *spi, uint8_t const *txbuf, uint8_t *const rxbuf, const uint16_t length);
+int32_t spi_m_dma_get_status(struct spi_m_dma_descriptor *spi, struct spi_m_dma_status *stat);
+void spi_m_dma_register_callback(struct spi_m_dma_descriptor *spi, const enum spi_m_dma_cb_type type, FUNC_PTR func);
+int32_t spi_m_dma_get_io_descriptor(struct spi_m_dma_descriptor *const spi, struct io_descriptor **io);
+
+// Timer Driver, ticking every millisecond of simulated time
+struct timer_task;
+typedef void (*timer_cb_t)(const struct timer_task *const timer_task);
+
+enum timer_task_mode
+{
+	TIMER_TASK_ONE_SHOT,
+	TIMER_TASK_REPEAT
+};
+
+struct timer_task
+{
+	struct timer_task *next;
+	uint32_t time_label;
+	uint32_t interval;
+	timer_cb_t cb;
+	enum timer_task_mode mode;
+};
+
+struct timer_descriptor
+{
+	struct timer_task *tasks;
+	uint32_t time;
+};
+
+int32_t timer_start(struct timer_descriptor *const descr);
+int32_t timer_add_task(struct timer_descriptor *const descr, struct timer_task *const task);
+int32_t timer_remove_task(struct timer_descriptor *const descr, const struct timer_task *const task);
+
+#endif
@@ -0,0 +1,8 @@
+// Host stand-in, the SPI clock and DMA channels of the simulated bus (as in Config/hpl_sercom_config.h)
+#ifndef CONF_SERCOM_5_SPI_BAUD
+#define CONF_SERCOM_5_SPI_BAUD 50000
+#endif
+
+#ifndef CONF_SERCOM_5_SPI_M_DMA_RX_CHANNEL
+#define CONF_SERCOM_5_SPI_M_DMA_RX_CHANNEL 3
+#endif
@@ -0,0 +1,2 @@
+// Host stand-in, see flashsim_hal.h
+#include "flashsim_hal.h"
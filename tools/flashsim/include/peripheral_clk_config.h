@@ -0,0 +1,4 @@
+// Host stand-in, the SERCOM core clock of the simulated bus (as in Config/peripheral_clk_config.h)
+#ifndef CONF_GCLK_SERCOM5_CORE_FREQUENCY
+#define CONF_GCLK_SERCOM5_CORE_FREQUENCY 1000000
+#endif
@@ -0,0 +1,549 @@
+// Include Simulated Device Header Files
+#include "spi_nor_sim.h"
+#include "hal_sim.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Instruction Codes
+#define SPINOR_CMD_PROGRAM			0x02
+#define SPINOR_CMD_READ				0x03
+#define SPINOR_CMD_WRITE_DISABLE	0x04
+#define SPINOR_CMD_READ_STATUS		0x05
+#define SPINOR_CMD_WRITE_ENABLE		0x06
+#define SPINOR_CMD_FAST_READ		0x0B
+#define SPINOR_CMD_SECTOR_ERASE		0x20
+#define SPINOR_CMD_BLOCK_ERASE_32K	0x52
+#define SPINOR_CMD_READ_SFDP		0x5A
+#define SPINOR_CMD_CHIP_ERASE		0x60
+#define SPINOR_CMD_MDID				0x9F
+#define SPINOR_CMD_RESUME			0xAB
+#define SPINOR_CMD_SUSPEND			0xB0
+#define SPINOR_CMD_DEEP_POWER_DOWN	0xB9
+#define SPINOR_CMD_SUSPEND_RESUME	0xD0
+#define SPINOR_CMD_CHIP_ERASE_ALT	0xC7
+#define SPINOR_CMD_BLOCK_ERASE_64K	0xD8
+
+// Status Register Bits
+#define SPINOR_STATUS_BUSY			0x01
+#define SPINOR_STATUS_WEL			0x02
+
+// Device Geometry
+#define SPINOR_PAGE_SIZE			256
+#define SPINOR_SFDP_SIZE			256
+#define SPINOR_SFDP_BFPT			0x30	// Address of the Basic Flash Parameter Table
+
+// AT25DF081A as fitted to the SAMD21 Xplained Pro (typical timings)
+const spiNorConfig_t SPINOR_AT25DF081A =
+{
+	.size = 0x100000,
+	.jedecId = { 0x1F, 0x45, 0x01 },
+	.sfdp = false,
+	.programUs = 1000,
+	.erase4kUs = 50000,
+	.erase32kUs = 250000,
+	.erase64kUs = 400000,
+	.chipEraseUs = 7000000,
+	.resumeUs = 30,
+	.suspendUs = 20,
+	.suspendIntervalUs = 128
+};
+
+// Device State
+static spiNorConfig_t config;
+static uint8_t *memory = NULL;
+static uint8_t sfdp[SPINOR_SFDP_SIZE];
+static spiNorStats_t stats;
+static bool selected = false;
+static bool wel = false;
+static uint64_t busyUntil = 0;
+static bool poweredDown = false;
+static uint64_t resumeUntil = 0;
+
+// Suspended Program / Erase
+static bool suspended = false;
+static uint64_t suspendedLeft = 0;		// Busy time left when it resumes
+static uint64_t resumedAt = 0;
+
+// Instruction being Decoded
+static uint8_t opcode;
+static bool ignored;			// Opcode arrived while busy
+static uint32_t count;			// Bytes clocked since CS went low
+static uint32_t address;
+
+// Page Buffer of a Page Program
+static uint8_t pageBuffer[SPINOR_PAGE_SIZE];
+
+/**
+ * Encode a typical time for the SFDP tables in the smallest unit that fits.
+ *
+ * @param uint32_t us					Time in microseconds.
+ * @param uint32_t *units				Units in microseconds, smallest first.
+ * @param uint8_t unitCount				Number of units.
+ * @param uint8_t countBits				Width of the count field.
+ *
+ * @return uint32_t						Count, with the unit index above it
+ */
+static uint32_t SPINOR_sfdpTime(uint32_t us, const uint32_t *units, uint8_t unitCount, uint8_t countBits)
+{
+	uint32_t unit;
+	uint32_t n;
+	
+	for (unit = 0; unit < unitCount - 1U; unit++)
+	{
+		if ((us + units[unit] - 1) / units[unit] <= (1UL << countBits))
+		{
+			break;
+		}
+	}
+	
+	n = (us + units[unit] - 1) / units[unit];
+	if (n == 0)
+	{
+		n = 1;
+	}
+	if (n > (1UL << countBits))
+	{
+		n = 1UL << countBits;
+	}
+	
+	return (n - 1) | (unit << countBits);
+}
+
+/**
+ * Build the SFDP area: the SFDP header, one parameter header and a JESD216B
+ * Basic Flash Parameter Table describing the configured device.
+ *
+ * @return void
+ */
+static void SPINOR_buildSfdp(void)
+{
+	static const uint32_t eraseUnits[4] = { 1000, 16000, 128000, 1000000 };
+	static const uint32_t programUnits[2] = { 8, 64 };
+	static const uint32_t chipUnits[4] = { 16000, 256000, 4000000, 64000000 };
+	uint32_t table[16];
+	uint8_t i;
+	
+	memset(sfdp, 0xFF, sizeof(sfdp));
+	memset(table, 0, sizeof(table));
+	
+	// SFDP Header, revision 1.6 with one parameter header
+	memcpy(&sfdp[0], "SFDP", 4);
+	sfdp[4] = 0x06;
+	sfdp[5] = 0x01;
+	sfdp[6] = 0x00;
+	sfdp[7] = 0xFF;
+	
+	// Parameter Header of the Basic Flash Parameter Table
+	sfdp[8] = 0x00;
+	sfdp[9] = 0x06;
+	sfdp[10] = 0x01;
+	sfdp[11] = 16;
+	sfdp[12] = SPINOR_SFDP_BFPT & 0xFF;
+	sfdp[13] = 0x00;
+	sfdp[14] = 0x00;
+	sfdp[15] = 0xFF;
+	
+	// 4K Erase, Dual Output Fast Read (1-1-2), 3-byte addressing
+	table[0] = 0x01 | (SPINOR_CMD_SECTOR_ERASE << 8) | (1UL << 16);
+	
+	// Density in bits
+	table[1] = config.size * 8 - 1;
+	
+	// Dual Output Fast Read 0x3B with 8 dummy clocks
+	table[3] = 0x08 | (0x3B << 8);
+	
+	// Erase Types 4K, 32K and 64K
+	table[7] = 12 | (SPINOR_CMD_SECTOR_ERASE << 8) | (15UL << 16) | ((uint32_t)SPINOR_CMD_BLOCK_ERASE_32K << 24);
+	table[8] = 16 | (SPINOR_CMD_BLOCK_ERASE_64K << 8);
+	
+	// Erase Times, maximum four times typical
+	table[9] = 0x1;
+	table[9] |= SPINOR_sfdpTime(config.erase4kUs, eraseUnits, 4, 5) << 4;
+	table[9] |= SPINOR_sfdpTime(config.erase32kUs, eraseUnits, 4, 5) << 11;
+	table[9] |= SPINOR_sfdpTime(config.erase64kUs, eraseUnits, 4, 5) << 18;
+	
+	// Page Size, Program and Chip Erase Times, maximum six times typical
+	table[10] = 0x2 | (8 << 4);
+	table[10] |= SPINOR_sfdpTime(config.programUs, programUnits, 2, 5) << 8;
+	table[10] |= SPINOR_sfdpTime(config.chipEraseUs, chipUnits, 4, 5) << 24;
+	
+	// Suspend Latency in microseconds, Resume to Suspend Interval in 64 us steps
+	table[11] = (1UL << 29) | ((config.suspendUs - 1) << 24) | (((config.suspendIntervalUs + 63) / 64 - 1) << 20);
+	table[11] |= (1UL << 18) | ((config.suspendUs - 1) << 13) | (((config.suspendIntervalUs + 63) / 64 - 1) << 9);
+	
+	// Suspend and Resume Instructions, the same for programs and erases
+	table[12] = ((uint32_t)SPINOR_CMD_SUSPEND << 24) | ((uint32_t)SPINOR_CMD_SUSPEND_RESUME << 16) | (SPINOR_CMD_SUSPEND << 8) | SPINOR_CMD_SUSPEND_RESUME;
+	
+	// Store the Table little endian
+	for (i = 0; i < 16; i++)
+	{
+		sfdp[SPINOR_SFDP_BFPT + i * 4 + 0] = table[i] & 0xFF;
+		sfdp[SPINOR_SFDP_BFPT + i * 4 + 1] = (table[i] >> 8) & 0xFF;
+		sfdp[SPINOR_SFDP_BFPT + i * 4 + 2] = (table[i] >> 16) & 0xFF;
+		sfdp[SPINOR_SFDP_BFPT + i * 4 + 3] = (table[i] >> 24) & 0xFF;
+	}
+}
+
+/**
+ * Power the device up with an erased array.
+ *
+ * @param spiNorConfig_t *cfg			Device description.
+ *
+ * @return void
+ */
+void SPINOR_reset(const spiNorConfig_t *cfg)
+{
+	config = *cfg;
+	
+	// Erased Array
+	free(memory);
+	memory = malloc(config.size);
+	memset(memory, 0xFF, config.size);
+	
+	// SFDP Area, blank when the device has none
+	memset(sfdp, 0xFF, sizeof(sfdp));
+	if (config.sfdp)
+	{
+		SPINOR_buildSfdp();
+	}
+	
+	// Idle Device
+	selected = false;
+	wel = false;
+	busyUntil = 0;
+	poweredDown = false;
+	resumeUntil = 0;
+	suspended = false;
+	suspendedLeft = 0;
+	resumedAt = 0;
+	SPINOR_clearStats();
+}
+
+/**
+ * Get the memory array, for preloading and checking contents.
+ *
+ * @return uint8_t *
+ */
+uint8_t *SPINOR_memory(void)
+{
+	return memory;
+}
+
+/**
+ * Check whether a program or erase is still running.
+ *
+ * @return bool
+ */
+bool SPINOR_isBusy(void)
+{
+	return SIM_now() < busyUntil;
+}
+
+/**
+ * Start a program or erase.
+ *
+ * @param uint32_t us					Time it takes.
+ *
+ * @return void
+ */
+static void SPINOR_startBusy(uint32_t us)
+{
+	busyUntil = SIM_now() + (uint64_t)us * 1000;
+	wel = false;
+}
+
+/**
+ * Carry out an erase instruction whose address is complete.
+ *
+ * @param uint32_t size					Bytes erased, the address is aligned down to it.
+ * @param uint32_t us					Time it takes.
+ *
+ * @return void
+ */
+static void SPINOR_erase(uint32_t size, uint32_t us)
+{
+	uint32_t base = (address % config.size) & ~(size - 1);
+	
+	if (!wel)
+	{
+		stats.welIgnored++;
+		return;
+	}
+	
+	memset(&memory[base], 0xFF, size);
+	stats.erases++;
+	SPINOR_startBusy(us);
+}
+
+/**
+ * Drive CS, the device acts on program and erase instructions when CS goes
+ * high at the end of them.
+ *
+ * @param bool select					true for CS low.
+ *
+ * @return void
+ */
+void SPINOR_select(bool select)
+{
+	uint32_t i;
+	
+	// New Instruction
+	if (select && !selected)
+	{
+		stats.transactions++;
+		count = 0;
+		address = 0;
+		ignored = false;
+	}
+	
+	// End of an Instruction
+	if (!select && selected && count > 0 && !ignored)
+	{
+		switch (opcode)
+		{
+			case SPINOR_CMD_WRITE_ENABLE:
+				wel = true;
+				break;
+	
+			case SPINOR_CMD_WRITE_DISABLE:
+				wel = false;
+				break;
+	
+			case SPINOR_CMD_PROGRAM:
+				// Program the loaded bytes, they wrapped within the page
+				if (count <= 4)
+				{
+					break;
+				}
+				if (!wel)
+				{
+					stats.welIgnored++;
+					break;
+				}
+				for (i = 0; i < SPINOR_PAGE_SIZE; i++)
+				{
+					memory[((address % config.size) & ~(SPINOR_PAGE_SIZE - 1)) + i] &= pageBuffer[i];
+				}
+				stats.programs++;
+				stats.programBytes += (count - 4 < SPINOR_PAGE_SIZE) ? count - 4 : SPINOR_PAGE_SIZE;
+				SPINOR_startBusy(config.programUs);
+				break;
+	
+			case SPINOR_CMD_SECTOR_ERASE:
+				if (count == 4)
+				{
+					SPINOR_erase(0x1000, config.erase4kUs);
+				}
+				break;
+	
+			case SPINOR_CMD_BLOCK_ERASE_32K:
+				if (count == 4)
+				{
+					SPINOR_erase(0x8000, config.erase32kUs);
+				}
+				break;
+	
+			case SPINOR_CMD_BLOCK_ERASE_64K:
+				if (count == 4)
+				{
+					SPINOR_erase(0x10000, config.erase64kUs);
+				}
+				break;
+	
+			case SPINOR_CMD_CHIP_ERASE:
+			case SPINOR_CMD_CHIP_ERASE_ALT:
+				if (count == 1)
+				{
+					address = 0;
+					SPINOR_erase(config.size, config.chipEraseUs);
+				}
+				break;
+	
+			case SPINOR_CMD_DEEP_POWER_DOWN:
+				if (count == 1)
+				{
+					poweredDown = true;
+					stats.powerDowns++;
+				}
+				break;
+	
+			case SPINOR_CMD_SUSPEND:
+				// Ignored without a Program / Erase to suspend
+				if (count != 1 || suspended || !SPINOR_isBusy())
+				{
+					break;
+				}
+				if (SIM_now() - resumedAt < (uint64_t)config.suspendIntervalUs * 1000)
+				{
+					stats.suspendIgnored++;
+					break;
+				}
+				suspended = true;
+				suspendedLeft = busyUntil - SIM_now();
+				busyUntil = SIM_now() + (uint64_t)config.suspendUs * 1000;
+				stats.suspends++;
+				break;
+	
+			case SPINOR_CMD_SUSPEND_RESUME:
+				if (count == 1 && suspended)
+				{
+					suspended = false;
+					busyUntil = SIM_now() + suspendedLeft;
+					resumedAt = SIM_now();
+				}
+				break;
+	
+			case SPINOR_CMD_RESUME:
+				// Ignored in standby
+				if (poweredDown)
+				{
+					poweredDown = false;
+					resumeUntil = SIM_now() + (uint64_t)config.resumeUs * 1000;
+					stats.resumes++;
+				}
+				break;
+	
+			default:
+				break;
+		}
+	}
+	
+	selected = select;
+}
+
+/**
+ * Clock one byte through the device.
+ *
+ * @param uint8_t mosi					Byte from the master.
+ *
+ * @return uint8_t						Byte to the master
+ */
+uint8_t SPINOR_exchange(uint8_t mosi)
+{
+	uint8_t miso = 0xFF;
+	
+	// Not Selected, the data line floats
+	if (!selected)
+	{
+		stats.strayBytes++;
+		return miso;
+	}
+	stats.busBytes++;
+	
+	// Opcode, only the status register can be read while busy, and only
+	// resume is decoded in deep power-down
+	if (count == 0)
+	{
+		opcode = mosi;
+		count++;
+	
+		if ((poweredDown && opcode != SPINOR_CMD_RESUME) || SIM_now() < resumeUntil)
+		{
+			stats.sleepIgnored++;
+			ignored = true;
+		}
+		else if (SPINOR_isBusy() && opcode != SPINOR_CMD_READ_STATUS && opcode != SPINOR_CMD_SUSPEND)
+		{
+			stats.busyIgnored++;
+			ignored = true;
+		}
+		else if (suspended && (opcode == SPINOR_CMD_PROGRAM || opcode == SPINOR_CMD_SECTOR_ERASE || opcode == SPINOR_CMD_BLOCK_ERASE_32K
+			|| opcode == SPINOR_CMD_BLOCK_ERASE_64K || opcode == SPINOR_CMD_CHIP_ERASE || opcode == SPINOR_CMD_CHIP_ERASE_ALT))
+		{
+			stats.suspendIgnored++;
+			ignored = true;
+		}
+		else if (opcode == SPINOR_CMD_READ_STATUS)
+		{
+			stats.statusPolls++;
+		}
+		else if (opcode == SPINOR_CMD_READ || opcode == SPINOR_CMD_FAST_READ || opcode == SPINOR_CMD_READ_SFDP)
+		{
+			stats.reads++;
+		}
+		else if (opcode == SPINOR_CMD_PROGRAM)
+		{
+			memset(pageBuffer, 0xFF, sizeof(pageBuffer));
+		}
+		return miso;
+	}
+	
+	if (ignored)
+	{
+		count++;
+		return miso;
+	}
+	
+	switch (opcode)
+	{
+		case SPINOR_CMD_READ_STATUS:
+			miso = (SPINOR_isBusy() ? SPINOR_STATUS_BUSY : 0) | (wel ? SPINOR_STATUS_WEL : 0);
+			break;
+	
+		case SPINOR_CMD_MDID:
+			miso = (count <= 3) ? config.jedecId[count - 1] : 0x00;
+			break;
+	
+		case SPINOR_CMD_READ:
+		case SPINOR_CMD_FAST_READ:
+		case SPINOR_CMD_READ_SFDP:
+		case SPINOR_CMD_PROGRAM:
+		case SPINOR_CMD_SECTOR_ERASE:
+		case SPINOR_CMD_BLOCK_ERASE_32K:
+		case SPINOR_CMD_BLOCK_ERASE_64K:
+			// 24 bit Address
+			if (count <= 3)
+			{
+				address = (address << 8) | mosi;
+				break;
+			}
+	
+			// Data Phase
+			if (opcode == SPINOR_CMD_READ)
+			{
+				miso = memory[(address + count - 4) % config.size];
+			}
+			else if (opcode == SPINOR_CMD_FAST_READ && count >= 5)
+			{
+				miso = memory[(address + count - 5) % config.size];
+			}
+			else if (opcode == SPINOR_CMD_READ_SFDP && count >= 5)
+			{
+				uint32_t offset = address + count - 5;
+				miso = (offset < SPINOR_SFDP_SIZE) ? sfdp[offset] : 0xFF;
+			}
+			else if (opcode == SPINOR_CMD_PROGRAM)
+			{
+				// Loading past the end of the page wraps to its start
+				pageBuffer[(address + count - 4) % SPINOR_PAGE_SIZE] &= mosi;
+			}
+			break;
+	
+		default:
+			break;
+	}
+	
+	count++;
+	return miso;
+}
+
+/**
+ * Get the device counters.
+ *
+ * @return spiNorStats_t *
+ */
+const spiNorStats_t *SPINOR_stats(void)
+{
+	return &stats;
+}
+
+/**
+ * Reset the device counters.
+ *
+ * @return void
+ */
+void SPINOR_clearStats(void)
+{
+	memset(&stats, 0, sizeof(stats));
+}
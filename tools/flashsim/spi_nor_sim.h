@@ -0,0 +1,68 @@
+/*
+ * Simulated AT25-class SPI NOR flash for running ext_flash.c on the host.
+ *
+ * The device decodes the instructions used by EXTFLASH_* one byte at a time
+ * as hal_sim.c clocks them over the simulated bus, and models the status
+ * register, write enable latch, busy timing, page wrap of page programs
+ * (bits can only be cleared), the erase block alignment, program / erase
+ * suspend and deep power-down.
+ */
+#ifndef SPI_NOR_SIM_H_
+#define SPI_NOR_SIM_H_
+
+// Include STD C Libraries
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Simulated Device Description
+typedef struct
+{
+	uint32_t size;				// Array size in bytes
+	uint8_t jedecId[3];			// Manufacturer ID, Device ID 1, Device ID 2
+	bool sfdp;					// Answer Read SFDP with a Basic Flash Parameter Table
+	uint32_t programUs;			// Page program time
+	uint32_t erase4kUs;			// Sector erase time
+	uint32_t erase32kUs;		// 32K block erase time
+	uint32_t erase64kUs;		// 64K block erase time
+	uint32_t chipEraseUs;		// Chip erase time
+	uint32_t resumeUs;			// Resume from deep power-down time
+	uint32_t suspendUs;			// Program / erase suspend time
+	uint32_t suspendIntervalUs;	// Least run time between a resume and the next suspend
+} spiNorConfig_t;
+
+// Device Counters
+typedef struct
+{
+	uint64_t busBytes;			// Bytes clocked while selected
+	uint32_t transactions;		// CS low periods
+	uint32_t reads;				// Read Data, Fast Read and Read SFDP instructions
+	uint32_t programs;			// Page programs carried out
+	uint64_t programBytes;		// Bytes loaded by page programs
+	uint32_t erases;			// Erases carried out (any size)
+	uint32_t statusPolls;		// Read Status Register instructions
+	uint32_t powerDowns;		// Deep power-downs entered
+	uint32_t resumes;			// Resumes from deep power-down
+	uint32_t suspends;			// Programs / erases suspended
+	uint32_t busyIgnored;		// Instructions ignored as the device was busy
+	uint32_t welIgnored;		// Program / erase instructions ignored without write enable
+	uint32_t sleepIgnored;		// Instructions ignored in deep power-down or while resuming
+	uint32_t suspendIgnored;	// Suspends too soon after a resume, programs / erases while suspended
+	uint32_t strayBytes;		// Bytes clocked while CS was high
+} spiNorStats_t;
+
+// AT25DF081A as fitted to the SAMD21 Xplained Pro (typical timings)
+extern const spiNorConfig_t SPINOR_AT25DF081A;
+
+// Device Methods
+extern void SPINOR_reset(const spiNorConfig_t *config);
+extern uint8_t *SPINOR_memory(void);
+extern void SPINOR_select(bool selected);
+extern uint8_t SPINOR_exchange(uint8_t mosi);
+extern bool SPINOR_isBusy(void);
+
+// Counters
+extern const spiNorStats_t *SPINOR_stats(void);
+extern void SPINOR_clearStats(void);
+
+#endif